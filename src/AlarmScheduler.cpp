@@ -0,0 +1,430 @@
+#include "AlarmScheduler.h"
+#include <algorithm>
+#include <functional>
+
+#ifdef _WIN32
+#include "WindowsHeaders.h"
+#elif defined(__linux__)
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+    constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000LL;
+    constexpr int64_t NO_DEADLINE = INT64_MAX;
+
+#if !defined(_WIN32) && !defined(__linux__)
+    // No clock-change notifications here; look at the wall clock this often
+    constexpr auto CLOCK_POLL_INTERVAL = std::chrono::seconds(1);
+#endif
+
+    int64_t FloorSeconds(int64_t nanoseconds) {
+        int64_t seconds = nanoseconds / NANOSECONDS_PER_SECOND;
+        return (nanoseconds % NANOSECONDS_PER_SECOND < 0) ? seconds - 1 : seconds;
+    }
+}
+
+AlarmScheduler::AlarmScheduler()
+    : next_id_(1)
+    , executor_(nullptr)
+    , clock_changed_(false)
+    , stop_(false) {
+#ifdef _WIN32
+    // Absolute due times on a waitable timer follow system time changes
+    timer_handle_ = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+    wake_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+#elif defined(__linux__)
+    timer_fd_ = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#else
+    wake_pending_ = false;
+    armed_deadline_ = NO_DEADLINE;
+#endif
+
+    thread_ = std::thread(&AlarmScheduler::Run, this);
+}
+
+AlarmScheduler::~AlarmScheduler() {
+    stop_ = true;
+    Wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+#ifdef _WIN32
+    if (timer_handle_) CloseHandle(timer_handle_);
+    if (wake_event_) CloseHandle(wake_event_);
+#elif defined(__linux__)
+    if (timer_fd_ >= 0) close(timer_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+#endif
+}
+
+AlarmScheduler::Id AlarmScheduler::AddAt(std::chrono::system_clock::time_point time, Callback callback,
+                                         std::string label) {
+    int64_t key = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    bool is_earliest;
+    Id id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        
+        Alarm& alarm = alarms_[id];
+        alarm.callback = std::move(callback);
+        alarm.label = std::move(label);
+        alarm.key = key;
+        
+        is_earliest = utc_heap_.empty() || key < utc_heap_.front().key;
+        Push(utc_heap_, { key, id });
+    }
+    
+    if (is_earliest) {
+        Wake();
+    }
+    return id;
+}
+
+AlarmScheduler::Id AlarmScheduler::AddLocal(int64_t local_seconds, std::shared_ptr<const TimeZone> zone,
+                                            Callback callback, std::string label) {
+    Alarm alarm;
+    alarm.callback = std::move(callback);
+    alarm.label = std::move(label);
+    return InsertLocal(local_seconds, std::move(zone), std::move(alarm));
+}
+
+AlarmScheduler::Id AlarmScheduler::AddRecurring(const CronSchedule& schedule, std::shared_ptr<const TimeZone> zone,
+                                                Callback callback, std::string label) {
+    int64_t local_seconds;
+    if (schedule.Next(FloorSeconds(NowNanoseconds()), *zone, &local_seconds) == CronSchedule::NO_MATCH) {
+        return 0;
+    }
+    
+    Alarm alarm;
+    alarm.label = std::move(label);
+    alarm.schedule.reset(new CronSchedule(schedule));
+    alarm.shared_callback = std::make_shared<Callback>(std::move(callback));
+    return InsertLocal(local_seconds, std::move(zone), std::move(alarm));
+}
+
+AlarmScheduler::Id AlarmScheduler::InsertLocal(int64_t local_seconds, std::shared_ptr<const TimeZone> zone, Alarm alarm) {
+    bool is_earliest;
+    Id id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        
+        // One queue per zone object: two loads under one name may hold
+        // different rules (a file updated in between, a POSIX string that
+        // shadows a zoneinfo name), so names alone do not identify a zone
+        int index = 0;
+        while (index < static_cast<int>(zones_.size()) && zones_[index].zone != zone) {
+            ++index;
+        }
+        if (index == static_cast<int>(zones_.size())) {
+            zones_.emplace_back();
+            zones_.back().zone = std::move(zone);
+        }
+        
+        alarm.zone = index;
+        alarm.key = local_seconds;
+        alarms_[id] = std::move(alarm);
+        
+        ZoneQueue& queue = zones_[index];
+        is_earliest = queue.heap.empty() || local_seconds < queue.heap.front().key;
+        if (is_earliest) {
+            queue.head_resolved = false;
+        }
+        Push(queue.heap, { local_seconds, id });
+    }
+    
+    if (is_earliest) {
+        Wake();
+    }
+    return id;
+}
+
+bool AlarmScheduler::Cancel(Id id) {
+    // Heap entries are dropped lazily when they reach the top
+    std::lock_guard<std::mutex> lock(mutex_);
+    return alarms_.erase(id) > 0;
+}
+
+void AlarmScheduler::SetExecutor(CallbackExecutor* executor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_ = executor;
+}
+
+void AlarmScheduler::NotifyClockChanged() {
+    clock_changed_ = true;
+    Wake();
+}
+
+size_t AlarmScheduler::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return alarms_.size();
+}
+
+std::vector<AlarmScheduler::Info> AlarmScheduler::List() const {
+    std::vector<Info> list;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        list.reserve(alarms_.size());
+        for (const auto& entry : alarms_) {
+            const Alarm& alarm = entry.second;
+            Info info;
+            info.id = entry.first;
+            info.is_local = alarm.zone >= 0;
+            info.is_recurring = alarm.schedule != nullptr;
+            info.utc_seconds = info.is_local ? zones_[alarm.zone].zone->LocalToUtc(alarm.key) : FloorSeconds(alarm.key);
+            info.label = alarm.label;
+            list.push_back(std::move(info));
+        }
+    }
+    
+    std::sort(list.begin(), list.end(), [](const Info& a, const Info& b) {
+        return a.utc_seconds != b.utc_seconds ? a.utc_seconds < b.utc_seconds : a.id < b.id;
+    });
+    return list;
+}
+
+AlarmScheduler::Stats AlarmScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+int64_t AlarmScheduler::NowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void AlarmScheduler::Push(std::vector<HeapEntry>& heap, HeapEntry entry) {
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+}
+
+void AlarmScheduler::Pop(std::vector<HeapEntry>& heap) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+    heap.pop_back();
+}
+
+bool AlarmScheduler::PruneHead(std::vector<HeapEntry>& heap) {
+    bool pruned = false;
+    while (!heap.empty() && alarms_.find(heap.front().id) == alarms_.end()) {
+        Pop(heap);
+        pruned = true;
+    }
+    return pruned;
+}
+
+int64_t AlarmScheduler::ResolveHead(ZoneQueue& queue) {
+    if (PruneHead(queue.heap)) {
+        queue.head_resolved = false;
+    }
+    if (queue.heap.empty()) {
+        return NO_DEADLINE;
+    }
+    
+    if (!queue.head_resolved) {
+        queue.head_utc = queue.zone->LocalToUtc(queue.heap.front().key) * NANOSECONDS_PER_SECOND;
+        queue.head_resolved = true;
+        ++stats_.heads_resolved;
+    }
+    return queue.head_utc;
+}
+
+int64_t AlarmScheduler::NextDeadline() {
+    PruneHead(utc_heap_);
+    int64_t next = utc_heap_.empty() ? NO_DEADLINE : utc_heap_.front().key;
+    for (ZoneQueue& queue : zones_) {
+        next = std::min(next, ResolveHead(queue));
+    }
+    return next;
+}
+
+void AlarmScheduler::CollectDue(int64_t now, std::vector<Callback>& due) {
+    auto take = [this, &due](Id id) {
+        auto it = alarms_.find(id);
+        due.push_back(std::move(it->second.callback));
+        alarms_.erase(it);
+    };
+    
+    PruneHead(utc_heap_);
+    while (!utc_heap_.empty() && utc_heap_.front().key <= now) {
+        Id id = utc_heap_.front().id;
+        Pop(utc_heap_);
+        take(id);
+        PruneHead(utc_heap_);
+    }
+    
+    for (ZoneQueue& queue : zones_) {
+        while (ResolveHead(queue) <= now) {
+            Id id = queue.heap.front().id;
+            Pop(queue.heap);
+            queue.head_resolved = false;
+            
+            Alarm& alarm = alarms_.find(id)->second;
+            if (!alarm.schedule) {
+                take(id);
+                continue;
+            }
+            
+            std::shared_ptr<Callback> callback = alarm.shared_callback;
+            due.push_back([callback]() { (*callback)(); });
+            
+            // Re-key from now rather than from the last occurrence, so a
+            // machine waking from sleep fires once instead of catching up
+            int64_t next;
+            if (alarm.schedule->Next(FloorSeconds(now), *queue.zone, &next) == CronSchedule::NO_MATCH) {
+                alarms_.erase(id);
+                continue;
+            }
+            alarm.key = next;
+            Push(queue.heap, { next, id });
+        }
+    }
+    
+    stats_.fired += due.size();
+}
+
+void AlarmScheduler::Run() {
+    std::vector<Callback> due;
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (!stop_) {
+        if (clock_changed_.exchange(false)) {
+            // Heap order survives any clock step; only the heads' UTC times
+            // are recomputed in case the zone settings changed with it
+            auto start = std::chrono::steady_clock::now();
+            for (ZoneQueue& queue : zones_) {
+                queue.head_resolved = false;
+            }
+            NextDeadline();
+            auto took = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            
+            ++stats_.clock_changes;
+            stats_.last_clock_change_rearm = took;
+            stats_.max_clock_change_rearm = std::max(stats_.max_clock_change_rearm, took);
+        }
+        
+        CollectDue(NowNanoseconds(), due);
+        if (!due.empty()) {
+            CallbackExecutor* executor = executor_;
+            lock.unlock();
+            
+            for (Callback& callback : due) {
+                if (executor && executor->Post(std::move(callback))) continue;
+                if (callback) {
+                    callback();
+                }
+            }
+            due.clear();
+            
+            lock.lock();
+            continue;
+        }
+        
+        ArmOsTimer(NextDeadline());
+        lock.unlock();
+        WaitForWakeup();
+        lock.lock();
+    }
+}
+
+#ifdef _WIN32
+
+void AlarmScheduler::ArmOsTimer(int64_t deadline) {
+    if (!timer_handle_) return;
+    
+    if (deadline == NO_DEADLINE) {
+        CancelWaitableTimer(timer_handle_);
+        return;
+    }
+    
+    // Positive due time is absolute: 100 ns units since 1601-01-01 UTC
+    LARGE_INTEGER due;
+    due.QuadPart = deadline / 100 + 116444736000000000LL;
+    SetWaitableTimer(timer_handle_, &due, 0, nullptr, nullptr, FALSE);
+}
+
+void AlarmScheduler::WaitForWakeup() {
+    HANDLE handles[2] = { wake_event_, timer_handle_ };
+    WaitForMultipleObjects(timer_handle_ ? 2 : 1, handles, FALSE, INFINITE);
+}
+
+void AlarmScheduler::Wake() {
+    SetEvent(wake_event_);
+}
+
+#elif defined(__linux__)
+
+void AlarmScheduler::ArmOsTimer(int64_t deadline) {
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    
+    if (deadline != NO_DEADLINE) {
+        int64_t ns = std::max<int64_t>(deadline, 1); // all zeroes would disarm
+        spec.it_value.tv_sec = static_cast<time_t>(ns / NANOSECONDS_PER_SECOND);
+        spec.it_value.tv_nsec = static_cast<long>(ns % NANOSECONDS_PER_SECOND);
+    }
+    // CANCEL_ON_SET makes read() fail with ECANCELED whenever the realtime
+    // clock is set, so steps are noticed without polling
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, nullptr);
+}
+
+void AlarmScheduler::WaitForWakeup() {
+    pollfd fds[2] = {
+        { wake_fd_, POLLIN, 0 },
+        { timer_fd_, POLLIN, 0 }
+    };
+    if (poll(fds, 2, -1) <= 0) {
+        return;
+    }
+    
+    uint64_t value;
+    if (fds[0].revents & POLLIN) {
+        (void)!read(wake_fd_, &value, sizeof(value));
+    }
+    if (fds[1].revents & POLLIN) {
+        if (read(timer_fd_, &value, sizeof(value)) < 0 && errno == ECANCELED) {
+            clock_changed_ = true;
+        }
+    }
+}
+
+void AlarmScheduler::Wake() {
+    uint64_t one = 1;
+    (void)!write(wake_fd_, &one, sizeof(one));
+}
+
+#else
+
+void AlarmScheduler::ArmOsTimer(int64_t deadline) {
+    armed_deadline_ = deadline;
+}
+
+void AlarmScheduler::WaitForWakeup() {
+    auto limit = std::chrono::system_clock::now() + CLOCK_POLL_INTERVAL;
+    if (armed_deadline_ != NO_DEADLINE) {
+        auto deadline = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{armed_deadline_}));
+        limit = std::min(limit, deadline);
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_cv_.wait_until(lock, limit, [this]() { return wake_pending_; });
+    wake_pending_ = false;
+}
+
+void AlarmScheduler::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_pending_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "CallbackExecutor.h"
+#include "CronSchedule.h"
+#include "InlineCallback.h"
+#include "TimeZone.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Alarms on absolute wall time, fired from a dedicated thread that sleeps on
+// an OS timer tied to the system clock (CLOCK_REALTIME timerfd with
+// TFD_TIMER_CANCEL_ON_SET on Linux, an absolute waitable timer on Windows).
+//
+// UTC alarms sit in one min-heap. Local-time alarms sit in a min-heap per
+// zone keyed on local wall time, which a DST transition or clock step never
+// reorders; only each heap's head is converted to UTC, on demand. A clock
+// step therefore re-arms in O(zones), independent of the alarm count.
+// Recurring alarms live in the zone heaps too and are re-keyed to their next
+// local occurrence each time they fire.
+class AlarmScheduler {
+public:
+    using Id = uint64_t;
+    using Callback = InlineCallback;
+    
+    struct Info {
+        Id id;
+        int64_t utc_seconds;  // when it will fire, as currently resolved
+        bool is_local;
+        bool is_recurring;
+        std::string label;
+    };
+    
+    struct Stats {
+        uint64_t fired = 0;
+        uint64_t clock_changes = 0;   // system clock set underneath us
+        uint64_t heads_resolved = 0;  // local -> UTC conversions, all zones
+        std::chrono::nanoseconds last_clock_change_rearm{0};
+        std::chrono::nanoseconds max_clock_change_rearm{0};
+    };
+    
+    AlarmScheduler();
+    ~AlarmScheduler();
+    
+    AlarmScheduler(const AlarmScheduler&) = delete;
+    AlarmScheduler& operator=(const AlarmScheduler&) = delete;
+    
+    // Fires when the system clock reaches `time`
+    Id AddAt(std::chrono::system_clock::time_point time, Callback callback, std::string label = std::string());
+    
+    // Fires when the wall clock in `zone` shows `local_seconds` (seconds
+    // since 1970-01-01 00:00 local). Skipped times fire after the gap,
+    // repeated ones on their first pass.
+    Id AddLocal(int64_t local_seconds, std::shared_ptr<const TimeZone> zone, Callback callback,
+                std::string label = std::string());
+    
+    // Fires every time `schedule` matches the wall clock in `zone`, until
+    // cancelled. Returns 0 if the schedule never matches.
+    Id AddRecurring(const CronSchedule& schedule, std::shared_ptr<const TimeZone> zone, Callback callback,
+                    std::string label = std::string());
+    
+    bool Cancel(Id id);
+    
+    // Runs callbacks on `executor` instead of the scheduler thread
+    void SetExecutor(CallbackExecutor* executor);
+    
+    // For platforms that report clock changes as events (WM_TIMECHANGE)
+    void NotifyClockChanged();
+    
+    size_t Size() const;
+    
+    // Pending alarms by firing time. Sorts a copy; meant for short UI lists.
+    std::vector<Info> List() const;
+    
+    Stats GetStats() const;
+
+private:
+    struct HeapEntry {
+        int64_t key; // UTC nanoseconds, or local seconds in a zone heap
+        Id id;
+        bool operator>(const HeapEntry& other) const { return key > other.key; }
+    };
+    
+    struct ZoneQueue {
+        std::shared_ptr<const TimeZone> zone;
+        std::vector<HeapEntry> heap;
+        bool head_resolved = false;
+        int64_t head_utc = 0; // nanoseconds
+    };
+    
+    struct Alarm {
+        Callback callback;
+        std::string label;
+        int zone = -1; // index into zones_, -1 for UTC alarms
+        int64_t key = 0;
+        
+        // Recurring alarms share their callback with each posted firing
+        std::unique_ptr<CronSchedule> schedule;
+        std::shared_ptr<Callback> shared_callback;
+    };
+    
+    static int64_t NowNanoseconds();
+    
+    Id InsertLocal(int64_t local_seconds, std::shared_ptr<const TimeZone> zone, Alarm alarm);
+    
+    void Run();
+    void Push(std::vector<HeapEntry>& heap, HeapEntry entry);
+    void Pop(std::vector<HeapEntry>& heap);
+    bool PruneHead(std::vector<HeapEntry>& heap); // true if the head changed
+    int64_t ResolveHead(ZoneQueue& queue);
+    int64_t NextDeadline();
+    void CollectDue(int64_t now, std::vector<Callback>& due);
+    
+    void ArmOsTimer(int64_t deadline);
+    void WaitForWakeup();
+    void Wake();
+    
+    mutable std::mutex mutex_;
+    std::vector<HeapEntry> utc_heap_;
+    std::vector<ZoneQueue> zones_;
+    std::unordered_map<Id, Alarm> alarms_;
+    Id next_id_;
+    CallbackExecutor* executor_;
+    Stats stats_;
+    
+    std::atomic<bool> clock_changed_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+
+#ifdef _WIN32
+    void* timer_handle_;
+    void* wake_event_;
+#elif defined(__linux__)
+    int timer_fd_;
+    int wake_fd_;
+#else
+    std::condition_variable wake_cv_;
+    bool wake_pending_;
+    int64_t armed_deadline_;
+#endif
+};
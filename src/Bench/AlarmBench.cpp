@@ -0,0 +1,194 @@
+#include "Bench.h"
+#include "../AlarmScheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // POSIX rules, so every machine has them: northern and southern DST,
+    // a half-hour offset without DST, and Chatham's 45-minute offsets
+    const char* const ZONES[] = {
+        "EST5EDT,M3.2.0,M11.1.0",
+        "CET-1CEST,M3.5.0,M10.5.0/3",
+        "AEST-10AEDT,M10.1.0,M4.1.0/3",
+        "IST-5:30",
+        "<+1245>-12:45<+1345>,M9.5.0/2:45,M4.1.0/3:45",
+    };
+    constexpr int ZONE_COUNT = sizeof(ZONES) / sizeof(ZONES[0]);
+    
+    constexpr int JUMPS = 50;
+    constexpr int64_t SECONDS_PER_DAY = 86400;
+    constexpr int64_t SECONDS_PER_YEAR = 365 * SECONDS_PER_DAY;
+    constexpr int FIRING_UTC = 2000;
+    constexpr int FIRING_LOCAL = 1000;
+    constexpr auto FIRING_SPREAD = std::chrono::milliseconds(1500);
+    
+    int64_t NowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    // The first UTC second the wall clock shows `local` at, found from the
+    // zone's offsets rather than through LocalToUtc(); a skipped time gets
+    // the offset from before the gap, which moves it forward
+    int64_t ReferenceUtc(const TimeZone& zone, int64_t local, const std::vector<int32_t>& offsets) {
+        int64_t best = INT64_MAX;
+        for (int32_t offset : offsets) {
+            int64_t candidate = local - offset;
+            if (zone.GetOffset(candidate) == offset) best = std::min(best, candidate);
+        }
+        return best != INT64_MAX ? best : local - zone.GetOffset(local - SECONDS_PER_DAY);
+    }
+    
+    struct Firing {
+        int queue;      // -1 for UTC alarms, else the zone
+        int64_t target; // UTC nanoseconds
+        int64_t fired;
+    };
+    
+    struct FiringLog {
+        std::mutex mutex;
+        std::vector<Firing> firings;
+        
+        void Record(int queue, int64_t target) {
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            std::lock_guard<std::mutex> lock(mutex);
+            firings.push_back({ queue, target, now });
+        }
+    };
+}
+
+int Bench::RunAlarms(size_t count) {
+    if (count == 0) count = 100000;
+    
+    std::vector<std::shared_ptr<const TimeZone>> zones;
+    std::vector<std::vector<int32_t>> offsets(ZONE_COUNT);
+    std::vector<std::vector<int64_t>> transitions(ZONE_COUNT);
+    int64_t now = NowSeconds();
+    for (int z = 0; z < ZONE_COUNT; ++z) {
+        zones.push_back(TimeZone::Load(ZONES[z]));
+        if (!zones.back()) return 1;
+        for (int64_t t = now; t < now + SECONDS_PER_YEAR; ) {
+            int64_t until = 0;
+            int32_t offset = zones[z]->GetOffset(t, &until);
+            if (std::find(offsets[z].begin(), offsets[z].end(), offset) == offsets[z].end()) offsets[z].push_back(offset);
+            if (until >= now + SECONDS_PER_YEAR) break;
+            transitions[z].push_back(until);
+            t = until;
+        }
+    }
+    
+    // Local alarms over the coming year, one in three within two hours of
+    // a DST transition, so skipped and repeated wall times are common
+    AlarmScheduler scheduler;
+    std::vector<int64_t> locals(count);
+    Clock::time_point start = Clock::now();
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int z = static_cast<int>(i % ZONE_COUNT);
+        int64_t offset = static_cast<int64_t>((state >> 33) % (4 * 3600)) - 2 * 3600;
+        int64_t local;
+        if (i % 3 == 0 && !transitions[z].empty()) {
+            int64_t transition = transitions[z][(state >> 20) % transitions[z].size()];
+            local = transition + zones[z]->GetOffset(transition) + offset;
+        } else {
+            local = now + SECONDS_PER_DAY + static_cast<int64_t>((state >> 11) % SECONDS_PER_YEAR);
+        }
+        locals[i] = local;
+        scheduler.AddLocal(local, zones[z], []() {});
+    }
+    double insert_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    
+    // Each clock step recomputes the zone heads only
+    Series rearm;
+    AlarmScheduler::Stats before = scheduler.GetStats();
+    for (int jump = 0; jump < JUMPS; ++jump) {
+        uint64_t seen = scheduler.GetStats().clock_changes;
+        scheduler.NotifyClockChanged();
+        AlarmScheduler::Stats stats;
+        while ((stats = scheduler.GetStats()).clock_changes == seen) std::this_thread::yield();
+        rearm.Add(Microseconds(stats.last_clock_change_rearm));
+    }
+    AlarmScheduler::Stats after = scheduler.GetStats();
+    double heads_per_jump = static_cast<double>(after.heads_resolved - before.heads_resolved) / JUMPS;
+    
+    // What a single UTC heap would have to do instead: convert every alarm
+    Series reconvert;
+    for (int run = 0; run < 5; ++run) {
+        int64_t sum = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < count; ++i) sum += zones[i % ZONE_COUNT]->LocalToUtc(locals[i]);
+        reconvert.Add(Microseconds(Clock::now() - start));
+        Consume(&sum);
+    }
+    
+    // Resolved firing times against the reference conversion
+    size_t mismatches = 0;
+    std::vector<AlarmScheduler::Info> list = scheduler.List();
+    for (const AlarmScheduler::Info& info : list) {
+        size_t i = static_cast<size_t>(info.id - 1);
+        int z = static_cast<int>(i % ZONE_COUNT);
+        if (info.utc_seconds != ReferenceUtc(*zones[z], locals[i], offsets[z]) && ++mismatches <= 3) {
+            std::printf("  %s: local %lld resolved to %lld\n", ZONES[z], static_cast<long long>(locals[i]),
+                        static_cast<long long>(info.utc_seconds));
+        }
+    }
+    
+    // Real firings: UTC alarms spread over the next 1.5 s and local ones on
+    // the next two whole seconds, with clock steps signalled throughout
+    FiringLog log;
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t spread = std::chrono::duration_cast<std::chrono::nanoseconds>(FIRING_SPREAD).count();
+    for (int i = 0; i < FIRING_UTC; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t target = now_ns + 100000000 + static_cast<int64_t>((state >> 11) % static_cast<uint64_t>(spread));
+        auto time = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(target)));
+        scheduler.AddAt(time, [&log, target]() { log.Record(-1, target); });
+    }
+    int64_t first_second = now_ns / 1000000000 + 1;
+    for (int i = 0; i < FIRING_LOCAL; ++i) {
+        int z = i % ZONE_COUNT;
+        int64_t utc = first_second + i % 2;
+        scheduler.AddLocal(utc + zones[z]->GetOffset(utc), zones[z],
+                           [&log, z, utc]() { log.Record(z, utc * 1000000000); });
+    }
+    Clock::time_point until = Clock::now() + FIRING_SPREAD + std::chrono::milliseconds(1000);
+    while (Clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        scheduler.NotifyClockChanged();
+    }
+    
+    // Each queue fires in order; a batch may interleave queues
+    Series lateness;
+    size_t early = 0, out_of_order = 0;
+    std::vector<int64_t> last_target(ZONE_COUNT + 1, INT64_MIN);
+    {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        for (const Firing& firing : log.firings) {
+            if (firing.fired < firing.target) ++early;
+            int64_t& last = last_target[firing.queue + 1];
+            if (firing.target < last) ++out_of_order;
+            last = firing.target;
+            lateness.Add(static_cast<double>(firing.fired - firing.target) / 1000.0);
+        }
+    }
+    size_t fired = lateness.values.size();
+    size_t expected = FIRING_UTC + FIRING_LOCAL;
+    
+    std::printf("AlarmScheduler, %zu local alarms over %d zones, a third next to DST transitions:\n", count, ZONE_COUNT);
+    std::printf("  insert         %.0f ns/alarm\n", insert_ns);
+    rearm.Print("rearm per jump", "us");
+    reconvert.Print("convert all", "us");
+    std::printf("  %.1f heads resolved per jump (%d zones), %zu of %zu resolved times differ from the reference\n",
+                heads_per_jump, ZONE_COUNT, mismatches, list.size());
+    std::printf("  firing %zu of %zu with a clock step every 50 ms: %zu early, %zu out of order\n",
+                fired, expected, early, out_of_order);
+    lateness.Print("lateness", "us");
+    
+    bool ok = mismatches == 0 && heads_per_jump <= ZONE_COUNT && fired == expected && early == 0 && out_of_order == 0;
+    return ok ? 0 : 1;
+}
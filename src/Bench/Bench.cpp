@@ -0,0 +1,35 @@
+#include "Bench.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+double Bench::Series::Percentile(double q) const {
+    if (values.empty()) return 0.0;
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()))];
+}
+
+void Bench::Series::Print(const char* name, const char* unit) const {
+    if (values.empty()) return;
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double value : sorted) total += value;
+    auto at = [&](double q) { return sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()))]; };
+    std::printf("  %-14s mean %9.2f  p50 %9.2f  p99 %9.2f  max %9.2f  %s\n",
+                name, total / sorted.size(), at(0.50), at(0.99), sorted.back(), unit);
+}
+
+double Bench::Microseconds(Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+double Bench::Nanoseconds(Clock::duration d) {
+    return std::chrono::duration<double, std::nano>(d).count();
+}
+
+void Bench::Consume(const void* value) {
+    static std::atomic<const void*> sink{nullptr};
+    sink.store(value, std::memory_order_relaxed);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Benchmarks and checks of the non-UI subsystems, run as TimeAppHeadless
+// modes. Each prints its report to stdout and returns the process exit
+// code, nonzero when a check finds a mismatch.
+namespace Bench {
+    using Clock = std::chrono::steady_clock;
+    
+    struct Series {
+        std::vector<double> values;
+        
+        void Add(double value) { values.push_back(value); }
+        
+        double Percentile(double q) const;
+        
+        // One line: mean, p50, p99 and max
+        void Print(const char* name, const char* unit) const;
+    };
+    
+    double Microseconds(Clock::duration d);
+    double Nanoseconds(Clock::duration d);
+    
+    // Keeps the optimizer from dropping a computed result
+    void Consume(const void* value);
+    
+    int RunExpiry(size_t timers);     // --expiry N: TimerService lateness vs frame polling
+    int RunLaps(size_t laps);         // --laps N: LapStore insert cost and memory per lap
+    int RunFormat(size_t count);      // --format N: TimeFormat vs the ostringstream formatting
+    int RunZoneCheck(size_t samples); // --tz-check N: TimeZone against glibc localtime_r, and lookup cost
+    int RunTsc(size_t seconds);       // --tsc N: TscClock read cost, and drift from steady_clock over N s
+    int RunRestore(size_t count);     // --restore N: TimerStore startup with N persisted timers
+    int RunPool(size_t count);        // --pool N: TimerPool batch evaluation vs Timer objects
+    int RunExecutor(size_t count);    // --executor N: callback registration and executor dispatch
+    int RunAlarms(size_t count);      // --alarms N: AlarmScheduler rearm on clock steps, DST resolution, firing order
+    int RunCronCheck(size_t samples); // --cron-check N: CronSchedule against a brute-force search
+    int RunCron(size_t count);        // --cron N: next-fire cost over N schedules
+    int RunSequences(size_t count);   // --sequences N: SequenceTimer drift, live and over a simulated day
+    int RunCapture(size_t count);     // --capture N: EventCapture cost with 1, 4 and 16 producers of N events
+    int RunTimerStress(size_t seconds); // --timer-stress N: Timer readers against control threads for N s, torn reads
+    int RunTimerReads(size_t count);  // --timer-read N: Timer read cost with 0, 1 and 3 control threads
+    int RunProfiler(size_t frames);   // --profiler N: FrameProfiler overhead over N frames of real scopes
+}
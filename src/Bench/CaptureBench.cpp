@@ -0,0 +1,104 @@
+#include "Bench.h"
+#include "../EventCapture.h"
+#include "../Timer.h"
+#include "../TscClock.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int PRODUCER_COUNTS[] = { 1, 4, 16 };
+    constexpr size_t RING_CAPACITY = 1 << 16;
+    
+    // Captures are timed in batches: one clock pair per batch keeps the
+    // timing out of the cost, and a batch cut by preemption shows up as an
+    // outlier instead of raising every sample. A batch that found the ring
+    // full waited for the owner thread, so it is counted, not timed.
+    constexpr size_t BATCH = 256;
+}
+
+int Bench::RunCapture(size_t count) {
+    if (count == 0) count = 200000;
+    
+    TscClock tsc;
+    std::printf("EventCapture, %zu captures per producer, ring of %zu, TscClock %s:\n", count, RING_CAPACITY,
+                tsc.IsAvailable() ? "on the TSC" : "on steady_clock");
+    
+    bool ok = true;
+    for (int producers : PRODUCER_COUNTS) {
+        EventCapture capture(RING_CAPACITY);
+        capture.SetClockSource(&tsc);
+        Timer stopwatch(Timer::Type::Stopwatch);
+        stopwatch.SetClockSource(&tsc);
+        stopwatch.Start();
+        
+        // The owner thread drains as the UI would, as fast as it can
+        std::atomic<bool> done{false};
+        std::thread owner([&]() {
+            while (!done.load(std::memory_order_acquire)) {
+                if (capture.Drain(stopwatch) == 0) std::this_thread::yield();
+            }
+            capture.Drain(stopwatch);
+        });
+        
+        std::vector<Series> costs(static_cast<size_t>(producers));
+        std::vector<uint64_t> full(static_cast<size_t>(producers)), waited(static_cast<size_t>(producers));
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                size_t index = static_cast<size_t>(p);
+                for (size_t done_count = 0; done_count < count; done_count += BATCH) {
+                    size_t batch = std::min(BATCH, count - done_count);
+                    uint64_t failures = 0;
+                    Clock::time_point start = Clock::now();
+                    for (size_t i = 0; i < batch; ++i) {
+                        while (!capture.Capture(EventCapture::Action::Lap, static_cast<uint32_t>(p))) {
+                            ++failures;
+                            std::this_thread::yield();
+                        }
+                    }
+                    if (failures == 0) {
+                        costs[index].Add(Nanoseconds(Clock::now() - start) / static_cast<double>(batch));
+                    } else {
+                        full[index] += failures;
+                        ++waited[index];
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        done.store(true, std::memory_order_release);
+        owner.join();
+        
+        Series cost;
+        uint64_t full_total = 0, waited_total = 0;
+        for (size_t p = 0; p < costs.size(); ++p) {
+            cost.values.insert(cost.values.end(), costs[p].values.begin(), costs[p].values.end());
+            full_total += full[p];
+            waited_total += waited[p];
+        }
+        
+        // Applied in timestamp order, every lap ends at or after the one
+        // before it; every capture is applied, and every full-ring refusal
+        // is counted as a drop
+        EventCapture::Stats stats = capture.GetStats();
+        const LapStore& laps = stopwatch.GetLaps();
+        size_t backwards = 0;
+        for (size_t i = 0; i < laps.Size(); ++i) backwards += laps.GetLap(i).count() < 0;
+        size_t total = count * static_cast<size_t>(producers);
+        bool accounted = stats.applied == total && laps.Size() == total && stats.dropped == full_total;
+        ok = ok && accounted && backwards == 0;
+        
+        std::printf("  %2d producer%s\n", producers, producers == 1 ? "" : "s");
+        cost.Print("per Capture()", "ns");
+        std::printf("  %llu applied, %llu dropped and retried in %llu batches, %llu reordered across drains, "
+                    "max drain %zu; %zu laps out of order%s\n",
+                    static_cast<unsigned long long>(stats.applied), static_cast<unsigned long long>(stats.dropped),
+                    static_cast<unsigned long long>(waited_total), static_cast<unsigned long long>(stats.reordered),
+                    stats.max_batch, backwards, accounted ? "" : ", captures unaccounted for");
+    }
+    std::printf("  %u hardware threads\n", std::thread::hardware_concurrency());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,364 @@
+#include "Bench.h"
+#include "../AlarmScheduler.h"
+#include "../CronSchedule.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    // POSIX rules: northern and southern DST, a gap at 2:45, and one whose
+    // transitions fall at negative hours of the day
+    const char* const ZONES[] = {
+        "EST5EDT,M3.2.0,M11.1.0",
+        "CET-1CEST,M3.5.0,M10.5.0/3",
+        "AEST-10AEDT,M10.1.0,M4.1.0/3",
+        "<+1245>-12:45<+1345>,M9.5.0/2:45,M4.1.0/3:45",
+        "<-02>2<-01>,M3.5.0/-1,M10.5.0/0",
+    };
+    constexpr int ZONE_COUNT = sizeof(ZONES) / sizeof(ZONES[0]);
+    
+    // What alarms and reminders usually look like
+    const char* const COMMON[] = {
+        "0 9 * * MON-FRI", "30 13 * * 1-5", "*/15 * * * *", "0 * * * *", "@daily", "0 8 1 * *", "45 6 * * SAT,SUN",
+    };
+    constexpr size_t COMMON_COUNT = sizeof(COMMON) / sizeof(COMMON[0]);
+    
+    const char* const MONTH_NAMES[] = {
+        "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+    };
+    const char* const WEEKDAY_NAMES[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT" };
+    
+    constexpr int64_t MINUTES_PER_DAY = 1440;
+    constexpr int64_t SECONDS_PER_DAY = 86400;
+    constexpr int64_t SEARCH_DAYS = 400 * 366;
+    constexpr int64_t ZONE_WINDOW = 3 * SECONDS_PER_DAY;
+    
+    // Bits first, first + step, ... up to last
+    uint64_t BitsOf(int first, int last, int step) {
+        uint64_t bits = 0;
+        for (int value = first; value <= last; value += step) bits |= 1ULL << value;
+        return bits;
+    }
+    
+    bool IsLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+    
+    int DaysInMonth(int year, int month) {
+        static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && IsLeapYear(year) ? 29 : DAYS[month - 1];
+    }
+    
+    int64_t FloorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+    
+    struct Random {
+        uint64_t state;
+        
+        uint64_t Next() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return state >> 11;
+        }
+        
+        int Range(int first, int last) {
+            return first + static_cast<int>(Next() % static_cast<uint64_t>(last - first + 1));
+        }
+    };
+    
+    // A random expression together with the sets it should compile to,
+    // built independently of the parser
+    struct Expression {
+        std::string text;
+        uint64_t minutes = 0, hours = 0, days = 0, months = 0, weekdays = 0;
+        bool days_restricted = false, weekdays_restricted = false;
+    };
+    
+    void AppendValue(std::string& text, int value, int min, const char* const* names, int name_count, Random& random) {
+        if (names && value - min < name_count && random.Range(0, 2) == 0) {
+            std::string name = names[value - min];
+            if (random.Range(0, 1)) name[1] = static_cast<char>(name[1] - 'A' + 'a');
+            text += name;
+        } else {
+            text += std::to_string(value);
+        }
+    }
+    
+    // One field: "*" alone, or a list of N, A-B, */S, A-B/S and N/S
+    uint64_t RandomField(std::string& text, int min, int max, const char* const* names, int name_count, Random& random) {
+        uint64_t set = 0;
+        if (random.Range(0, 4) < 2) {
+            text += "*";
+            return BitsOf(min, max, 1);
+        }
+        int items = random.Range(1, 3);
+        for (int item = 0; item < items; ++item) {
+            if (item > 0) text += ",";
+            int first = random.Range(min, max);
+            int last = random.Range(first, max);
+            int step = random.Range(1, std::max(1, (max - min) / 2));
+            switch (random.Range(0, 4)) {
+            case 0:
+                AppendValue(text, first, min, names, name_count, random);
+                set |= BitsOf(first, first, 1);
+                break;
+            case 1:
+                AppendValue(text, first, min, names, name_count, random);
+                text += "-";
+                AppendValue(text, last, min, names, name_count, random);
+                set |= BitsOf(first, last, 1);
+                break;
+            case 2:
+                text += "*/" + std::to_string(step);
+                set |= BitsOf(min, max, step);
+                break;
+            case 3:
+                AppendValue(text, first, min, names, name_count, random);
+                text += "-";
+                AppendValue(text, last, min, names, name_count, random);
+                text += "/" + std::to_string(step);
+                set |= BitsOf(first, last, step);
+                break;
+            default:
+                AppendValue(text, first, min, names, name_count, random);
+                text += "/" + std::to_string(step);
+                set |= BitsOf(first, max, step);
+                break;
+            }
+        }
+        return set;
+    }
+    
+    Expression RandomExpression(Random& random, bool every_day) {
+        Expression e;
+        e.minutes = RandomField(e.text, 0, 59, nullptr, 0, random);
+        e.text += " ";
+        e.hours = RandomField(e.text, 0, 23, nullptr, 0, random);
+        e.text += random.Range(0, 1) ? " " : "\t ";
+        size_t day_field = e.text.size();
+        e.days = every_day ? (e.text += "*", BitsOf(1, 31, 1)) : RandomField(e.text, 1, 31, nullptr, 0, random);
+        e.days_restricted = e.text[day_field] != '*';
+        e.text += " ";
+        e.months = every_day ? (e.text += "*", BitsOf(1, 12, 1)) : RandomField(e.text, 1, 12, MONTH_NAMES, 12, random);
+        e.text += " ";
+        size_t weekday_field = e.text.size();
+        e.weekdays = RandomField(e.text, 0, 7, WEEKDAY_NAMES, 7, random);
+        e.weekdays_restricted = e.text[weekday_field] != '*';
+        if (e.weekdays & (1ULL << 7)) e.weekdays |= 1;
+        return e;
+    }
+    
+    bool DayMatches(const Expression& e, int month, int day, int weekday) {
+        if (!(e.months & (1ULL << month))) return false;
+        bool by_day = (e.days >> day) & 1;
+        bool by_weekday = (e.weekdays >> weekday) & 1;
+        return e.days_restricted && e.weekdays_restricted ? (by_day || by_weekday) : (by_day && by_weekday);
+    }
+    
+    bool MinuteMatches(const Expression& e, int minute_of_day) {
+        return ((e.hours >> (minute_of_day / 60)) & 1) && ((e.minutes >> (minute_of_day % 60)) & 1);
+    }
+    
+    bool Matches(const Expression& e, int64_t local_seconds) {
+        int64_t days = FloorDiv(local_seconds, SECONDS_PER_DAY);
+        int year, month, day;
+        TimeZone::CivilFromDays(days, year, month, day);
+        return DayMatches(e, month, day, TimeZone::WeekdayFromDays(days))
+            && MinuteMatches(e, static_cast<int>((local_seconds - days * SECONDS_PER_DAY) / 60));
+    }
+    
+    // Day by day through 400 years, minute by minute within a matching day
+    int64_t ReferenceNextLocal(const Expression& e, int64_t local_seconds) {
+        int64_t minute_count = FloorDiv(local_seconds, 60) + 1;
+        int64_t days = FloorDiv(minute_count, MINUTES_PER_DAY);
+        int first_minute = static_cast<int>(minute_count - days * MINUTES_PER_DAY);
+        int year, month, day;
+        TimeZone::CivilFromDays(days, year, month, day);
+        int weekday = TimeZone::WeekdayFromDays(days);
+        
+        for (int64_t i = 0; i < SEARCH_DAYS; ++i) {
+            if (DayMatches(e, month, day, weekday)) {
+                for (int minute = i == 0 ? first_minute : 0; minute < MINUTES_PER_DAY; ++minute) {
+                    if (MinuteMatches(e, minute)) return ((days + i) * MINUTES_PER_DAY + minute) * 60;
+                }
+            }
+            weekday = (weekday + 1) % 7;
+            if (++day > DaysInMonth(year, month)) {
+                day = 1;
+                if (++month > 12) {
+                    month = 1;
+                    ++year;
+                }
+            }
+        }
+        return CronSchedule::NO_MATCH;
+    }
+    
+    // UTC minute by minute up to `last`. A wall time fires on its first
+    // pass only; the instant a gap ends fires once if the gap skipped
+    // anything that matches. NO_MATCH if nothing fires by `last`.
+    int64_t ReferenceNext(const Expression& e, const TimeZone& zone, const std::vector<int32_t>& offsets,
+                          int64_t utc_seconds, int64_t last, int64_t& local, bool& in_gap) {
+        for (int64_t u = FloorDiv(utc_seconds, 60) * 60 + 60; u <= last; u += 60) {
+            int32_t offset = zone.GetOffset(u);
+            int32_t before = zone.GetOffset(u - 1);
+            local = u + offset;
+            in_gap = false;
+            for (int64_t skipped = u + before; skipped < local && !in_gap; skipped += 60) {
+                in_gap = Matches(e, skipped);
+            }
+            if (in_gap) return u;
+            if (!Matches(e, local)) continue;
+            
+            bool shown_before = false;
+            for (int32_t other : offsets) {
+                shown_before |= other != offset && local - other < u && zone.GetOffset(local - other) == other;
+            }
+            if (!shown_before) return u;
+        }
+        return CronSchedule::NO_MATCH;
+    }
+    
+    // Start times: anywhere in 1970-2100, or in the last two days of a
+    // month, which covers month ends, leap days and year ends
+    int64_t RandomStart(Random& random) {
+        if (random.Range(0, 1)) return static_cast<int64_t>(random.Next() % 4102444800ULL);
+        int year = random.Range(1970, 2099);
+        int month = random.Range(1, 12);
+        int64_t end = (TimeZone::DaysFromCivil(year, month, 1) + DaysInMonth(year, month)) * SECONDS_PER_DAY;
+        return end - 1 - static_cast<int64_t>(random.Next() % (2 * SECONDS_PER_DAY));
+    }
+}
+
+int Bench::RunCronCheck(size_t samples) {
+    if (samples == 0) samples = 20000;
+    Random random{ 0x9E3779B97F4A7C15ULL };
+    
+    // Next local match against the calendar walk
+    size_t local_mismatches = 0, never = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        Expression e = RandomExpression(random, false);
+        CronSchedule schedule(e.text.c_str());
+        int64_t start = RandomStart(random);
+        int64_t expected = ReferenceNextLocal(e, start);
+        int64_t got = schedule.IsValid() ? schedule.NextLocal(start) : -1;
+        never += expected == CronSchedule::NO_MATCH;
+        if (got != expected && ++local_mismatches <= 5) {
+            std::printf("  \"%s\" after %lld: %lld, expected %lld\n", e.text.c_str(), static_cast<long long>(start),
+                        static_cast<long long>(got), static_cast<long long>(expected));
+        }
+    }
+    
+    // Next firing in a zone, starting up to two days before a transition
+    std::vector<std::shared_ptr<const TimeZone>> zones;
+    std::vector<std::vector<int32_t>> offsets(ZONE_COUNT);
+    std::vector<std::vector<int64_t>> transitions(ZONE_COUNT);
+    for (int z = 0; z < ZONE_COUNT; ++z) {
+        zones.push_back(TimeZone::Load(ZONES[z]));
+        if (!zones.back()) return 1;
+        int64_t end = TimeZone::DaysFromCivil(2040, 1, 1) * SECONDS_PER_DAY;
+        for (int64_t t = TimeZone::DaysFromCivil(2000, 1, 1) * SECONDS_PER_DAY; t < end; ) {
+            int64_t until = 0;
+            int32_t offset = zones[z]->GetOffset(t, &until);
+            if (std::find(offsets[z].begin(), offsets[z].end(), offset) == offsets[z].end()) offsets[z].push_back(offset);
+            transitions[z].push_back(until);
+            t = until;
+        }
+    }
+    
+    size_t zone_mismatches = 0, gap_firings = 0, fired = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        int z = static_cast<int>(i % ZONE_COUNT);
+        Expression e = RandomExpression(random, random.Range(0, 1) == 0);
+        CronSchedule schedule(e.text.c_str());
+        int64_t transition = transitions[z][random.Next() % transitions[z].size()];
+        int64_t start = transition - static_cast<int64_t>(random.Next() % (2 * SECONDS_PER_DAY));
+        
+        int64_t expected_local = 0, got_local = 0;
+        bool in_gap = false;
+        int64_t expected = ReferenceNext(e, *zones[z], offsets[z], start, start + ZONE_WINDOW, expected_local, in_gap);
+        int64_t got = schedule.Next(start, *zones[z], &got_local);
+        bool agree = expected == CronSchedule::NO_MATCH ? got > start + ZONE_WINDOW
+                                                        : got == expected && got_local == expected_local;
+        fired += expected != CronSchedule::NO_MATCH;
+        gap_firings += in_gap && expected != CronSchedule::NO_MATCH;
+        if (!agree && ++zone_mismatches <= 5) {
+            std::printf("  \"%s\" in %s after %lld: %lld (local %lld), expected %lld (local %lld)\n", e.text.c_str(),
+                        ZONES[z], static_cast<long long>(start), static_cast<long long>(got),
+                        static_cast<long long>(got_local), static_cast<long long>(expected),
+                        static_cast<long long>(expected_local));
+        }
+    }
+    
+    std::printf("CronSchedule against brute force, %zu random expressions each:\n", samples);
+    std::printf("  next local     %zu mismatches (%zu never match)\n", local_mismatches, never);
+    std::printf("  next in zone   %zu mismatches over %d zones (%zu fire within 3 days, %zu at the end of a DST gap)\n",
+                zone_mismatches, ZONE_COUNT, fired, gap_firings);
+    return local_mismatches == 0 && zone_mismatches == 0 ? 0 : 1;
+}
+
+int Bench::RunCron(size_t count) {
+    if (count == 0) count = 100000;
+    Random random{ 0x2545F4914F6CDD1DULL };
+    
+    std::vector<Expression> expressions;
+    expressions.reserve(count);
+    for (size_t i = 0; i < count; ++i) expressions.push_back(RandomExpression(random, false));
+    
+    Clock::time_point start = Clock::now();
+    std::vector<CronSchedule> schedules;
+    schedules.reserve(count);
+    for (const Expression& e : expressions) schedules.emplace_back(e.text.c_str());
+    double compile_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    
+    std::shared_ptr<const TimeZone> zone = TimeZone::Load(ZONES[1]);
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t local_now = now + zone->GetOffset(now);
+    
+    int64_t sum = 0;
+    start = Clock::now();
+    for (const CronSchedule& schedule : schedules) sum += schedule.NextLocal(local_now);
+    double local_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    
+    start = Clock::now();
+    for (const CronSchedule& schedule : schedules) sum += schedule.Next(now, *zone);
+    double zone_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    
+    // Common schedules, each asked from successive minutes of the next week
+    std::vector<CronSchedule> common(COMMON, COMMON + COMMON_COUNT);
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) sum += common[i % COMMON_COUNT].Next(now + static_cast<int64_t>(i % 10080) * 60, *zone);
+    double common_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    
+    // The calendar walk, on a slice; it also checks the same answers
+    size_t slice = std::min<size_t>(count, 2000);
+    size_t mismatches = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < slice; ++i) {
+        int64_t expected = ReferenceNextLocal(expressions[i], local_now);
+        sum += expected;
+        mismatches += expected != schedules[i].NextLocal(local_now);
+    }
+    double reference_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(slice);
+    Consume(&sum);
+    
+    size_t added = 0;
+    double add_ns;
+    {
+        AlarmScheduler scheduler;
+        start = Clock::now();
+        for (const CronSchedule& schedule : schedules) added += scheduler.AddRecurring(schedule, zone, []() {}) != 0;
+        add_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(count);
+    }
+    
+    std::printf("CronSchedule, %zu random expressions:\n", count);
+    std::printf("  compile        %.0f ns\n", compile_ns);
+    std::printf("  next local     %.0f ns (calendar walk %.0f ns, %zu of %zu differ)\n", local_ns, reference_ns,
+                mismatches, slice);
+    std::printf("  next in zone   %.0f ns (%s), %.0f ns for %zu common schedules\n", zone_ns,
+                zone->GetName().c_str(), common_ns, COMMON_COUNT);
+    std::printf("  AddRecurring   %.0f ns (%zu of %zu ever match)\n", add_ns, added, count);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include "Bench.h"
+#include "../TimerService.h"
+#include <cstdio>
+#include <thread>
+
+namespace {
+    constexpr auto SPREAD = std::chrono::seconds(2);         // deadlines fall over this long
+    constexpr auto LEAD = std::chrono::milliseconds(50);     // first deadline after scheduling
+    constexpr auto FRAME = std::chrono::microseconds(16667); // the polling loop's 60 Hz
+    
+    // Deadlines in order, spaced unevenly so they do not line up with frames
+    std::vector<Bench::Clock::time_point> Deadlines(size_t count) {
+        Bench::Clock::time_point start = Bench::Clock::now() + LEAD;
+        auto step = std::chrono::duration_cast<Bench::Clock::duration>(SPREAD) / static_cast<int64_t>(count);
+        std::vector<Bench::Clock::time_point> deadlines(count);
+        for (size_t i = 0; i < count; ++i) {
+            deadlines[i] = start + step * static_cast<int64_t>(i) + step * static_cast<int64_t>((i * 7919) % 97) / 97;
+        }
+        return deadlines;
+    }
+}
+
+int Bench::RunExpiry(size_t timers) {
+    if (timers == 0) timers = 1000;
+    
+    // Each callback notes when it started; lateness is that minus its deadline
+    std::vector<Clock::time_point> deadlines = Deadlines(timers);
+    std::vector<Clock::time_point> fired(timers);
+    TimerService::LatenessStats stats;
+    {
+        TimerService service;
+        for (size_t i = 0; i < timers; ++i) {
+            Clock::time_point* slot = &fired[i];
+            service.Schedule(deadlines[i], [slot]() { *slot = Clock::now(); });
+        }
+        std::this_thread::sleep_until(deadlines.back() + std::chrono::milliseconds(20));
+        stats = service.GetLatenessStats();
+    }
+    
+    Series service_lateness;
+    size_t missed = 0;
+    for (size_t i = 0; i < timers; ++i) {
+        if (fired[i] == Clock::time_point()) {
+            ++missed;
+        } else {
+            service_lateness.Add(Microseconds(fired[i] - deadlines[i]));
+        }
+    }
+    
+    // What the countdown had before: a 60 Hz loop polling every timer once a frame
+    deadlines = Deadlines(timers);
+    Series poll_lateness;
+    size_t next = 0;
+    for (Clock::time_point frame = Clock::now(); next < timers; frame += FRAME) {
+        std::this_thread::sleep_until(frame);
+        Clock::time_point now = Clock::now();
+        for (; next < timers && deadlines[next] <= now; ++next) {
+            poll_lateness.Add(Microseconds(now - deadlines[next]));
+        }
+    }
+    
+    std::printf("Countdown expiry lateness, %zu deadlines over %lld ms:\n", timers,
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(SPREAD).count()));
+    service_lateness.Print("TimerService", "us");
+    poll_lateness.Print("60 Hz polling", "us");
+    std::printf("  TimerService histogram: %llu fired, p99 < %lld us, %zu not fired\n",
+                static_cast<unsigned long long>(stats.count),
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(stats.Percentile(0.99)).count()),
+                missed);
+    return missed == 0 ? 0 : 1;
+}
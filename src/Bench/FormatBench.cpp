@@ -0,0 +1,107 @@
+#include "Bench.h"
+#include "../TimeFormat.h"
+#include "../TimeZone.h"
+#include "../Timer.h"
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+    const TimeFormat DURATION_FORMAT("[HH:]MM:SS.fff");
+    const TimeFormat CLOCK_FORMAT("%H:%M:%S.fff");
+    
+    // Timer::FormatTimeWithMilliseconds() before TimeFormat, minus the two clock reads
+    std::string OldDuration(std::chrono::nanoseconds elapsed) {
+        auto total_seconds = std::chrono::duration_cast<std::chrono::seconds>(elapsed);
+        auto hours = std::chrono::duration_cast<std::chrono::hours>(total_seconds);
+        auto minutes = std::chrono::duration_cast<std::chrono::minutes>(total_seconds - hours);
+        auto seconds = total_seconds - hours - minutes;
+        
+        std::ostringstream oss;
+        if (hours.count() > 0) {
+            oss << std::setfill('0') << std::setw(2) << hours.count() << ":";
+        }
+        oss << std::setfill('0') << std::setw(2) << minutes.count() << ":"
+            << std::setfill('0') << std::setw(2) << seconds.count();
+        std::string base_time = oss.str();
+        
+        std::ostringstream with_ms;
+        with_ms << base_time << "." << std::setfill('0') << std::setw(3)
+                << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() % 1000;
+        return with_ms.str();
+    }
+    
+    // MainWindow::FormatCurrentTime() before TimeZone and TimeFormat
+    std::string OldClock(std::chrono::system_clock::time_point time) {
+        auto time_t = std::chrono::system_clock::to_time_t(time);
+        std::ostringstream oss;
+        oss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) % 1000;
+        oss << "." << std::setfill('0') << std::setw(3) << ms.count();
+        return oss.str();
+    }
+    
+    std::chrono::nanoseconds Duration(size_t i) {
+        return std::chrono::nanoseconds{static_cast<int64_t>((i * 2654435761u) % 36000000) * 1000000 + 123456};
+    }
+    
+    std::chrono::system_clock::time_point ClockTime(std::chrono::system_clock::time_point base, size_t i) {
+        return base + std::chrono::milliseconds(static_cast<int64_t>(i) * 37);
+    }
+    
+    void Report(const char* name, size_t count, Bench::Clock::duration elapsed) {
+        double ns = Bench::Nanoseconds(elapsed) / static_cast<double>(count);
+        std::printf("  %-26s %8.1f ns  %7.2f M formats/s\n", name, ns, 1000.0 / ns);
+    }
+}
+
+int Bench::RunFormat(size_t count) {
+    if (count == 0) count = 1000000;
+    char buffer[32];
+    size_t length = 0;
+    
+    std::printf("Time formatting, %zu calls each:\n", count);
+    
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; ++i) length += OldDuration(Duration(i)).size();
+    Report("duration, ostringstream", count, Clock::now() - start);
+    
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        length += DURATION_FORMAT.Format(TimeFields::FromDuration(Duration(i)), buffer, sizeof(buffer));
+    }
+    Report("duration, TimeFormat", count, Clock::now() - start);
+    
+    // The real call: lock, one clock read, format
+    Timer stopwatch(Timer::Type::Stopwatch);
+    stopwatch.Start();
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) length += stopwatch.FormatTime(buffer, sizeof(buffer), true);
+    Report("Timer::FormatTime", count, Clock::now() - start);
+    
+    auto base = std::chrono::system_clock::now();
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) length += OldClock(ClockTime(base, i)).size();
+    Report("clock, localtime+put_time", count, Clock::now() - start);
+    
+    std::shared_ptr<const TimeZone> zone = TimeZone::LoadLocal();
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        length += CLOCK_FORMAT.Format(zone->ToLocal(ClockTime(base, i)).fields, buffer, sizeof(buffer));
+    }
+    Report("clock, TimeZone+TimeFormat", count, Clock::now() - start);
+    Consume(&length);
+    
+    // Both paths must print the same text
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; i += 101) {
+        DURATION_FORMAT.Format(TimeFields::FromDuration(Duration(i)), buffer, sizeof(buffer));
+        if (OldDuration(Duration(i)) != buffer) ++mismatches;
+        CLOCK_FORMAT.Format(zone->ToLocal(ClockTime(base, i)).fields, buffer, sizeof(buffer));
+        if (OldClock(ClockTime(base, i)) != buffer) ++mismatches;
+    }
+    std::printf("  %zu mismatches against the old output (zone %s)\n", mismatches, zone->GetName().c_str());
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include "Bench.h"
+#include "../LapStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    constexpr int RUNS = 5;
+    constexpr size_t SPLIT_READS = 100000;
+    
+    // Laps of 50-150 ms with some jitter
+    int64_t LapNanoseconds(size_t i) {
+        return 50000000 + static_cast<int64_t>((i * 2654435761u) % 100000000);
+    }
+}
+
+int Bench::RunLaps(size_t laps) {
+    if (laps == 0) laps = 5000000;
+    
+    // The first run allocates the chunks; Clear() keeps them for the others
+    LapStore store;
+    Series fresh, reused;
+    for (int run = 0; run < RUNS; ++run) {
+        store.Clear();
+        int64_t split = 0;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < laps; ++i) {
+            split += LapNanoseconds(i);
+            store.Record(std::chrono::nanoseconds{split});
+        }
+        double ns = Nanoseconds(Clock::now() - start) / static_cast<double>(laps);
+        (run == 0 ? fresh : reused).Add(ns);
+    }
+    Consume(&store.GetStats());
+    
+    // Splits are read back as chunk base plus a partial sum
+    Clock::time_point start = Clock::now();
+    int64_t sum = 0;
+    for (size_t i = 0; i < SPLIT_READS; ++i) {
+        sum += store.GetSplit((i * 2654435761u) % laps).count();
+    }
+    double split_ns = Nanoseconds(Clock::now() - start) / static_cast<double>(SPLIT_READS);
+    Consume(&sum);
+    
+    // The running statistics must match a rescan of the history
+    const LapStore::Stats& stats = store.GetStats();
+    int64_t min = INT64_MAX, max = 0, total = 0;
+    int64_t expected_split = 0;
+    size_t errors = 0;
+    for (size_t i = 0; i < laps; ++i) {
+        int64_t lap = LapNanoseconds(i);
+        min = std::min(min, lap);
+        max = std::max(max, lap);
+        total += lap;
+        expected_split += lap;
+        if (store.GetLap(i).count() != lap) ++errors;
+        if (i % 997 == 0 && store.GetSplit(i).count() != expected_split) ++errors;
+    }
+    int64_t mean = total / static_cast<int64_t>(laps);
+    if (stats.count != laps || stats.min.count() != min || stats.max.count() != max
+        || std::llabs(stats.mean.count() - mean) > 1) {
+        ++errors;
+    }
+    
+    std::printf("LapStore, %zu laps:\n", laps);
+    fresh.Print("Record, new", "ns/lap");
+    reused.Print("Record, reused", "ns/lap");
+    std::printf("  GetSplit       %.1f ns (random index)\n", split_ns);
+    std::printf("  memory         %.2f bytes/lap (%zu KB)\n",
+                static_cast<double>(store.GetMemoryUsage()) / static_cast<double>(laps), store.GetMemoryUsage() / 1024);
+    std::printf("  stats          min %lld max %lld mean %lld stddev %lld ns; %zu mismatches against a rescan\n",
+                static_cast<long long>(stats.min.count()), static_cast<long long>(stats.max.count()),
+                static_cast<long long>(stats.mean.count()), static_cast<long long>(stats.stddev.count()), errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "Bench.h"
+#include "../TimerPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+namespace {
+    constexpr int PASSES = 200;
+    constexpr auto FRAME = std::chrono::milliseconds(16);
+    
+    // A third are countdowns of up to two hours, all started up to ten
+    // minutes ago, so some expire during the run; one in four is paused
+    struct Setup {
+        bool countdown;
+        bool paused;
+        std::chrono::nanoseconds duration;
+        std::chrono::nanoseconds age;
+    };
+    
+    Setup Describe(size_t i) {
+        return Setup{
+            i % 3 == 0,
+            i % 4 == 1,
+            std::chrono::seconds(1 + (i * 7919) % 7200),
+            std::chrono::milliseconds((i * 104729) % 600000)
+        };
+    }
+}
+
+int Bench::RunPool(size_t count) {
+    if (count == 0) count = 100000;
+    
+    Clock::time_point t0 = Clock::now();
+    TimerPool pool;
+    std::vector<std::unique_ptr<Timer>> timers;
+    timers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Setup setup = Describe(i);
+        Timer::Type type = setup.countdown ? Timer::Type::Countdown : Timer::Type::Stopwatch;
+        TimerPool::Index index = pool.Add(type, setup.duration);
+        pool.Start(index, t0 - setup.age);
+        if (setup.paused) pool.Pause(index, t0);
+        
+        timers.push_back(std::make_unique<Timer>(type));
+        timers.back()->SetDuration(std::chrono::duration_cast<std::chrono::seconds>(setup.duration));
+        timers.back()->Start(t0 - setup.age);
+        if (setup.paused) timers.back()->Pause(t0);
+    }
+    
+    // Each pass is one dashboard frame, 16 ms after the last
+    std::vector<TimerPool::Index> expired;
+    Series pooled;
+    Clock::time_point now = t0;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        now += FRAME;
+        Clock::time_point start = Clock::now();
+        pool.Evaluate(now, expired);
+        pooled.Add(Microseconds(Clock::now() - start));
+    }
+    
+    // The same reads through Timer objects: a lock and a clock read each
+    Series per_object;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        int64_t sum = 0;
+        Clock::time_point start = Clock::now();
+        for (const std::unique_ptr<Timer>& timer : timers) {
+            sum += timer->GetElapsedNanoseconds().count();
+            if (timer->GetType() == Timer::Type::Countdown) sum += timer->GetRemainingTime().count();
+        }
+        per_object.Add(Microseconds(Clock::now() - start));
+        Consume(&sum);
+    }
+    
+    // Against the arithmetic done one slot at a time, at the last pass
+    std::vector<bool> was_expired(count);
+    for (TimerPool::Index index : expired) was_expired[index] = true;
+    size_t errors = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Setup setup = Describe(i);
+        auto elapsed = setup.paused ? setup.age : std::chrono::nanoseconds(now - t0) + setup.age;
+        bool expires = setup.countdown && !setup.paused && elapsed >= setup.duration;
+        auto index = static_cast<TimerPool::Index>(i);
+        if (expires != was_expired[i]) {
+            ++errors;
+        } else if (!expires && pool.GetElapsed(index) != elapsed) {
+            ++errors;
+        } else if (!expires && setup.countdown && pool.GetRemaining(index) != std::max(setup.duration - elapsed, std::chrono::nanoseconds{0})) {
+            ++errors;
+        }
+    }
+    
+    std::printf("TimerPool vs Timer objects, %zu timers, %d passes 16 ms apart (%s):\n",
+                count, PASSES, TimerPool::GetBackendName());
+    pooled.Print("TimerPool", "us/pass");
+    per_object.Print("Timer objects", "us/pass");
+    std::printf("  %.2f vs %.2f ns/timer at p50; %zu expired, %zu mismatches against per-slot arithmetic\n",
+                pooled.Percentile(0.5) * 1000.0 / static_cast<double>(count),
+                per_object.Percentile(0.5) * 1000.0 / static_cast<double>(count),
+                expired.size(), errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include "Bench.h"
+#include "../TscClock.h"
+#include "../UI/FrameProfiler.h"
+#include <cstdio>
+
+namespace {
+    constexpr size_t BATCH = 64;   // frames per timed batch
+    constexpr int SCOPES_PER_FRAME = 10;
+    
+    // The scopes of one drawn frame on the Stopwatch tab, as MainWindow and
+    // TimeAppView open them, and the EndFrame that commits them
+    void Frame(FrameProfiler* profiler) {
+        { PROFILE_SCOPE(profiler, Messages); }
+        { PROFILE_SCOPE(profiler, FrameWait); }
+        { PROFILE_SCOPE(profiler, NewFrame); }
+        { PROFILE_SCOPE(profiler, TimeDisplay); }
+        { PROFILE_SCOPE(profiler, NTPControls); }
+        { PROFILE_SCOPE(profiler, Stopwatch); }
+        { PROFILE_SCOPE(profiler, StatusBar); }
+        { PROFILE_SCOPE(profiler, ImGuiRender); }
+        { PROFILE_SCOPE(profiler, Submit); }
+        { PROFILE_SCOPE(profiler, Present); }
+        if (profiler) {
+            PROFILE_END_FRAME(profiler);
+        }
+    }
+    
+    Bench::Series Run(FrameProfiler* profiler, size_t frames) {
+        Bench::Series cost;
+        for (size_t done = 0; done < frames; done += BATCH) {
+            Bench::Clock::time_point start = Bench::Clock::now();
+            for (size_t i = 0; i < BATCH; ++i) Frame(profiler);
+            cost.Add(Bench::Nanoseconds(Bench::Clock::now() - start) / BATCH);
+        }
+        return cost;
+    }
+}
+
+int Bench::RunProfiler(size_t frames) {
+    if (frames == 0) frames = 200000;
+    
+    TscClock tsc;
+#ifdef ENABLE_PROFILER
+    std::printf("FrameProfiler, %d scopes and EndFrame per frame, %zu frames:\n", SCOPES_PER_FRAME, frames);
+#else
+    std::printf("FrameProfiler compiled out (ENABLE_PROFILER off), %zu frames:\n", frames);
+#endif
+    
+    FrameProfiler on_tsc(&tsc);
+    FrameProfiler on_steady;
+    Series tsc_cost = Run(&on_tsc, frames);
+    Series steady_cost = Run(&on_steady, frames);
+    Series detached_cost = Run(nullptr, frames);
+    
+    tsc_cost.Print(tsc.IsAvailable() ? "TscClock" : "TscClock (off)", "ns/frame");
+    steady_cost.Print("steady_clock", "ns/frame");
+    detached_cost.Print("no profiler", "ns/frame");
+    
+    std::printf("  %d frames in the ring, p50 total %.2f us on the TSC\n", on_tsc.GetFrameCount(),
+                on_tsc.Summarize(FrameProfiler::TOTAL).p50);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "Bench.h"
+#include "../SequenceTimer.h"
+#include "../TimerService.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace {
+    constexpr size_t LIVE_SEQUENCES = 1000;
+    constexpr auto LIVE_RUN = std::chrono::seconds(2);
+    constexpr auto DAY = std::chrono::hours(24);
+    constexpr auto DAY_OFFSET = std::chrono::milliseconds(500); // keeps the check clear of a phase end
+    
+    using std::chrono::minutes;
+    using std::chrono::seconds;
+    
+    struct Profile {
+        const char* name;
+        std::vector<std::chrono::nanoseconds> durations;
+    };
+    
+    const Profile PROFILES[] = {
+        { "pomodoro 25/5, 15", { minutes(25), minutes(5), minutes(25), minutes(5), minutes(25), minutes(5), minutes(25), minutes(15) } },
+        { "intervals 30/10 s", { seconds(30), seconds(10) } },
+        { "tabata 20/10 s", { seconds(20), seconds(10) } },
+        { "intervals 45/15 s", { seconds(45), seconds(15) } },
+    };
+    constexpr size_t PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+    
+    std::vector<SequenceTimer::Phase> PhasesOf(const std::vector<std::chrono::nanoseconds>& durations) {
+        std::vector<SequenceTimer::Phase> phases;
+        for (std::chrono::nanoseconds duration : durations) phases.push_back({ "", duration });
+        return phases;
+    }
+    
+    // What a phase change sees, filled in on the service thread
+    struct Live {
+        SequenceTimer* timer = nullptr;
+        SequenceTimer::Clock::time_point anchor;
+        std::vector<std::chrono::nanoseconds> ends; // prefix sums
+        std::chrono::nanoseconds lateness_sum{0};   // the drift of restart-at-now chaining
+        uint64_t wrong_ends = 0;
+        std::vector<double> lateness;
+        
+        void OnPhaseChange() {
+            SequenceTimer::Stats stats = timer->GetStats();
+            lateness_sum += stats.last_lateness;
+            lateness.push_back(static_cast<double>(stats.last_lateness.count()) / 1000.0);
+            
+            // The next end must still sit exactly on the anchor's grid
+            uint64_t number = stats.transitions + stats.coalesced;
+            uint64_t count = ends.size();
+            auto expected = anchor + ends.back() * static_cast<int64_t>(number / count) + ends[number % count];
+            if (timer->GetPhaseEnd() != expected) ++wrong_ends;
+        }
+    };
+}
+
+int Bench::RunSequences(size_t count) {
+    if (count == 0) count = 10000;
+    
+    // Live: short phases on a real TimerService, lateness as it happens
+    Series lateness, chained_drift;
+    uint64_t wrong_ends = 0, transitions = 0, coalesced = 0;
+    {
+        TimerService service;
+        size_t live_count = std::min(count, LIVE_SEQUENCES);
+        std::vector<Live> live(live_count);
+        std::vector<std::unique_ptr<SequenceTimer>> timers;
+        Clock::time_point t0 = Clock::now() + std::chrono::milliseconds(10);
+        for (size_t i = 0; i < live_count; ++i) {
+            std::vector<std::chrono::nanoseconds> durations = {
+                std::chrono::milliseconds(5 + i % 7), std::chrono::milliseconds(3 + i % 5), std::chrono::milliseconds(11 + i % 3)
+            };
+            timers.push_back(std::make_unique<SequenceTimer>());
+            Live& state = live[i];
+            state.timer = timers.back().get();
+            state.anchor = t0 + std::chrono::microseconds(97 * (i % 50));
+            std::chrono::nanoseconds end{0};
+            for (std::chrono::nanoseconds d : durations) state.ends.push_back(end += d);
+            
+            state.timer->SetPhases(PhasesOf(durations));
+            state.timer->SetOnPhaseChange([&state]() { state.OnPhaseChange(); });
+            state.timer->AttachService(&service);
+            state.timer->Start(state.anchor);
+        }
+        std::this_thread::sleep_for(LIVE_RUN);
+        for (auto& timer : timers) timer->Stop();
+        
+        for (size_t i = 0; i < live_count; ++i) {
+            for (double value : live[i].lateness) lateness.Add(value);
+            chained_drift.Add(static_cast<double>(live[i].lateness_sum.count()) / 1000.0);
+            wrong_ends += live[i].wrong_ends;
+            SequenceTimer::Stats stats = timers[i]->GetStats();
+            transitions += stats.transitions;
+            coalesced += stats.coalesced;
+        }
+    }
+    
+    // A simulated day: each phase change lands late by a lateness drawn from
+    // the live run. Anchored, each end only carries its own; chained, every
+    // phase starts when the last change was noticed, and the errors add up.
+    std::vector<Series> day_drift(PROFILE_COUNT);
+    std::vector<double> phases_per_day(PROFILE_COUNT);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < count; ++i) {
+        const Profile& profile = PROFILES[i % PROFILE_COUNT];
+        std::chrono::nanoseconds chained{0}, anchored{0};
+        size_t phases = 0;
+        while (anchored < DAY) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            double late_us = lateness.values.empty() ? 0.0 : lateness.values[(state >> 11) % lateness.values.size()];
+            std::chrono::nanoseconds duration = profile.durations[phases++ % profile.durations.size()];
+            anchored += duration;
+            chained += duration + std::chrono::nanoseconds(static_cast<int64_t>(late_us * 1000.0));
+        }
+        day_drift[i % PROFILE_COUNT].Add(Microseconds(chained - anchored) / 1000.0);
+        phases_per_day[i % PROFILE_COUNT] += static_cast<double>(phases);
+    }
+    
+    // The timer itself, started a day ago: position straight from the anchor
+    size_t wrong_positions = 0;
+    for (size_t p = 0; p < PROFILE_COUNT; ++p) {
+        const Profile& profile = PROFILES[p];
+        SequenceTimer timer;
+        timer.SetPhases(PhasesOf(profile.durations));
+        timer.Start(Clock::now() - DAY - DAY_OFFSET);
+        SequenceTimer::Position position = timer.GetPosition();
+        
+        std::chrono::nanoseconds cycle{0};
+        for (std::chrono::nanoseconds d : profile.durations) cycle += d;
+        std::chrono::nanoseconds within = (DAY + DAY_OFFSET) % cycle;
+        size_t phase = 0;
+        for (std::chrono::nanoseconds end = profile.durations[0]; within >= end; end += profile.durations[++phase]) {}
+        if (position.phase != phase || position.cycle != static_cast<uint64_t>((DAY + DAY_OFFSET) / cycle)) ++wrong_positions;
+    }
+    
+    std::printf("SequenceTimer, %zu live sequences for %lld s on a TimerService:\n", std::min(count, LIVE_SEQUENCES),
+                static_cast<long long>(LIVE_RUN.count()));
+    lateness.Print("lateness", "us");
+    chained_drift.Print("chained drift", "us");
+    std::printf("  %llu phase changes (%llu coalesced), %llu next ends off the anchor grid\n",
+                static_cast<unsigned long long>(transitions), static_cast<unsigned long long>(coalesced),
+                static_cast<unsigned long long>(wrong_ends));
+    std::printf("Simulated 24 h, %zu sequences, each phase change late by a live sample:\n", count);
+    for (size_t p = 0; p < PROFILE_COUNT; ++p) {
+        std::printf("  %s, %.0f phases:\n", PROFILES[p].name,
+                    phases_per_day[p] / static_cast<double>(std::max<size_t>(1, day_drift[p].values.size())));
+        day_drift[p].Print("chained drift", "ms");
+    }
+    std::printf("  anchored drift 0; each end is off by its own lateness only (p99 %.0f us)\n", lateness.Percentile(0.99));
+    std::printf("  %zu of %zu timers started a day ago report the wrong phase\n", wrong_positions, PROFILE_COUNT);
+    return wrong_ends == 0 && wrong_positions == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "Bench.h"
+#include "../TimerStore.h"
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+namespace {
+    constexpr int RUNS = 5;
+    constexpr auto DOWNTIME = std::chrono::hours(1);
+    constexpr auto TOLERANCE = std::chrono::seconds(1);
+    
+    // Half stopwatches, half countdowns; one in four paused. Every running
+    // one started an hour ago; a third were saved in an earlier boot, so
+    // only their wall clock anchor means anything.
+    Timer::Snapshot MakeSnapshot(uint32_t i, std::chrono::steady_clock::time_point steady_now,
+                                 std::chrono::system_clock::time_point wall_now) {
+        Timer::Snapshot snapshot;
+        snapshot.type = i % 2 ? Timer::Type::Countdown : Timer::Type::Stopwatch;
+        snapshot.state = i % 4 == 3 ? Timer::State::Paused : Timer::State::Running;
+        snapshot.accumulated = std::chrono::seconds(i % 600);
+        snapshot.duration = std::chrono::hours(2);
+        snapshot.anchor_wall = wall_now - DOWNTIME;
+        snapshot.anchor_steady = i % 3 == 0 ? steady_now + std::chrono::hours(240) : steady_now - DOWNTIME;
+        return snapshot;
+    }
+}
+
+int Bench::RunRestore(size_t count) {
+    if (count == 0) count = 100000;
+    auto slots = static_cast<uint32_t>(count);
+    std::string path = (std::filesystem::temp_directory_path() / "timeapp-restore-bench.bin").string();
+    
+    TimerStore store;
+    if (!store.Open(path, slots)) return 1;
+    auto steady_now = std::chrono::steady_clock::now();
+    auto wall_now = std::chrono::system_clock::now();
+    Clock::time_point start = Clock::now();
+    for (uint32_t i = 0; i < slots; ++i) store.Write(i, MakeSnapshot(i, steady_now, wall_now));
+    double write_us = Microseconds(Clock::now() - start);
+    store.Close();
+    
+    std::vector<std::unique_ptr<Timer>> timers;
+    timers.reserve(count);
+    for (uint32_t i = 0; i < slots; ++i) {
+        timers.push_back(std::make_unique<Timer>(i % 2 ? Timer::Type::Countdown : Timer::Type::Stopwatch));
+    }
+    
+    // Startup: map the existing file, then read and restore every slot. The
+    // reads are also timed alone, to split the store's share from Timer's.
+    Series open, read, restore;
+    size_t restored = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        start = Clock::now();
+        if (!store.Open(path, slots)) return 1;
+        Clock::time_point opened = Clock::now();
+        open.Add(Microseconds(opened - start));
+        Timer::Snapshot snapshot;
+        int64_t sum = 0;
+        for (uint32_t i = 0; i < slots; ++i) {
+            if (store.Read(i, snapshot)) sum += snapshot.accumulated.count();
+        }
+        Consume(&sum);
+        read.Add(Microseconds(Clock::now() - opened));
+        
+        opened = Clock::now();
+        restored = 0;
+        for (uint32_t i = 0; i < slots; ++i) {
+            if (store.Read(i, snapshot)) {
+                timers[i]->Restore(snapshot);
+                ++restored;
+            }
+        }
+        restore.Add(Microseconds(Clock::now() - opened));
+        store.Close();
+    }
+    
+    // Running timers must have been credited with the downtime, by either
+    // clock; the wall clock one is only as exact as the two clocks agree
+    size_t errors = count - restored;
+    for (uint32_t i = 0; i < slots; ++i) {
+        Timer::Snapshot expected = MakeSnapshot(i, steady_now, wall_now);
+        auto got = timers[i]->GetElapsedNanoseconds();
+        auto want = expected.accumulated;
+        if (expected.state == Timer::State::Running) want += std::chrono::nanoseconds(Clock::now() - steady_now) + DOWNTIME;
+        if (timers[i]->GetState() != expected.state || got > want + TOLERANCE || got < want - TOLERANCE) ++errors;
+    }
+    std::error_code error;
+    uintmax_t file_size = std::filesystem::file_size(path, error);
+    std::filesystem::remove(path, error);
+    
+    std::printf("TimerStore, %zu timers, %llu KB file (page cache warm):\n", count,
+                static_cast<unsigned long long>(file_size / 1024));
+    std::printf("  write all      %.0f us\n", write_us);
+    open.Print("open", "us");
+    read.Print("read only", "us");
+    restore.Print("read+restore", "us");
+    std::printf("  %zu restored, %zu errors (state or downtime not accounted)\n", restored, errors);
+    return errors == 0 ? 0 : 1;
+}
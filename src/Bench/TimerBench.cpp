@@ -0,0 +1,202 @@
+#include "Bench.h"
+#include "../Timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int CONTROL_COUNTS[] = { 0, 1, 3 };
+    constexpr int STRESS_CONTROLS = 3;
+    constexpr int STRESS_READERS = 2;
+    constexpr size_t BATCH = 256;
+    
+    struct Random {
+        uint64_t state;
+        
+        uint32_t Next() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<uint32_t>(state >> 33);
+        }
+    };
+    
+    // What readers saw that a consistent timer cannot show
+    struct Violations {
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> backwards{0};   // elapsed fell, or remaining rose, within one revision
+        std::atomic<uint64_t> out_of_range{0};
+    };
+    
+    // Hammers `timer` from control threads while readers check every sample
+    // against what the timer can legally show. Within one revision (no
+    // control call in between) elapsed only grows and remaining only falls;
+    // a torn read mixes two publishes and breaks one or the other.
+    template <typename Control, typename Check>
+    void Stress(Timer& timer, std::chrono::seconds length, Control control, Check check, Violations& violations) {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int c = 0; c < STRESS_CONTROLS; ++c) {
+            threads.emplace_back([&, c]() {
+                Random random{ 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(c + 1) };
+                while (!stop.load(std::memory_order_relaxed)) control(random.Next());
+            });
+        }
+        for (int r = 0; r < STRESS_READERS; ++r) {
+            threads.emplace_back([&]() {
+                uint64_t last_revision = ~0ULL;
+                std::chrono::nanoseconds last{0};
+                uint64_t reads = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    uint64_t before = timer.GetRevision();
+                    std::chrono::nanoseconds value{0};
+                    bool valid = check(value);
+                    uint64_t after = timer.GetRevision();
+                    ++reads;
+                    if (!valid) violations.out_of_range.fetch_add(1, std::memory_order_relaxed);
+                    if (before != after) {
+                        last_revision = ~0ULL;
+                        continue;
+                    }
+                    if (before == last_revision && value < last) violations.backwards.fetch_add(1, std::memory_order_relaxed);
+                    last_revision = before;
+                    last = value;
+                }
+                violations.reads.fetch_add(reads, std::memory_order_relaxed);
+            });
+        }
+        std::this_thread::sleep_for(length);
+        stop = true;
+        for (std::thread& thread : threads) thread.join();
+    }
+    
+    std::chrono::nanoseconds LockedElapsed(const Timer& timer) {
+        Timer::Snapshot snapshot = timer.GetSnapshot();
+        if (snapshot.state != Timer::State::Running) return snapshot.accumulated;
+        return snapshot.accumulated + (std::chrono::steady_clock::now() - snapshot.anchor_steady);
+    }
+    
+    void PrintViolations(const char* name, const Violations& violations) {
+        std::printf("  %-10s %llu reads, %llu backwards within a revision, %llu out of range\n", name,
+                    static_cast<unsigned long long>(violations.reads.load()),
+                    static_cast<unsigned long long>(violations.backwards.load()),
+                    static_cast<unsigned long long>(violations.out_of_range.load()));
+    }
+}
+
+int Bench::RunTimerStress(size_t seconds) {
+    if (seconds == 0) seconds = 2;
+    auto length = std::chrono::seconds(static_cast<int64_t>(seconds));
+    std::printf("Timer under %d control threads and %d readers, %zu s each:\n", STRESS_CONTROLS, STRESS_READERS, seconds);
+    
+    // Stopwatch: pause, resume and restart; elapsed never exceeds the time
+    // since the run began
+    Violations stopwatch_violations;
+    {
+        Timer stopwatch(Timer::Type::Stopwatch);
+        Clock::time_point began = Clock::now();
+        stopwatch.Start();
+        Stress(stopwatch, length, [&](uint32_t choice) {
+            switch (choice % 8) {
+                case 0: stopwatch.Reset(); stopwatch.Start(); break;
+                case 1: case 2: case 3: stopwatch.Pause(); break;
+                default: stopwatch.Resume(); break;
+            }
+        }, [&](std::chrono::nanoseconds& value) {
+            Timer::State state = stopwatch.GetState();
+            value = stopwatch.GetElapsedNanoseconds();
+            char text[32];
+            size_t length = stopwatch.FormatTime(text, sizeof(text), true);
+            return value.count() >= 0 && value <= Clock::now() - began && length >= 9
+                && (state == Timer::State::Running || state == Timer::State::Paused || state == Timer::State::Stopped);
+        }, stopwatch_violations);
+    }
+    
+    // Countdown: durations change underneath the readers; remaining stays
+    // within the longest one, and counts down (negated for the check)
+    Violations countdown_violations;
+    {
+        Timer countdown(Timer::Type::Countdown);
+        countdown.SetDuration(std::chrono::seconds(20));
+        countdown.Start();
+        Stress(countdown, length, [&](uint32_t choice) {
+            switch (choice % 8) {
+                case 0: countdown.Stop(); countdown.Start(); break;
+                case 1: countdown.SetDuration(std::chrono::seconds(10 + choice % 11)); break;
+                case 2: case 3: countdown.Pause(); break;
+                default: countdown.Resume(); break;
+            }
+        }, [&](std::chrono::nanoseconds& value) {
+            std::chrono::seconds remaining = countdown.GetRemainingTime();
+            value = -std::chrono::nanoseconds(remaining);
+            return remaining.count() >= 0 && remaining <= std::chrono::seconds(20);
+        }, countdown_violations);
+    }
+    
+    PrintViolations("stopwatch", stopwatch_violations);
+    PrintViolations("countdown", countdown_violations);
+    bool clean = stopwatch_violations.backwards == 0 && stopwatch_violations.out_of_range == 0
+        && countdown_violations.backwards == 0 && countdown_violations.out_of_range == 0;
+    return clean ? 0 : 1;
+}
+
+int Bench::RunTimerReads(size_t count) {
+    if (count == 0) count = 1000000;
+    std::printf("Timer reads while control threads pause and resume it, %zu reads each:\n", count);
+    
+    for (int controls : CONTROL_COUNTS) {
+        Timer stopwatch(Timer::Type::Stopwatch);
+        stopwatch.Start();
+        
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> transitions{0};
+        std::vector<std::thread> threads;
+        for (int c = 0; c < controls; ++c) {
+            threads.emplace_back([&]() {
+                uint64_t done = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    stopwatch.Pause();
+                    stopwatch.Resume();
+                    done += 2;
+                }
+                transitions += done;
+            });
+        }
+        
+        // The lock-free path the UI draws through, against the same elapsed
+        // time worked out from GetSnapshot(), which takes the timer's mutex
+        // like every read used to. Batches cut by preemption land in the
+        // tail, not in p50.
+        Series lock_free, locked;
+        int64_t sum = 0;
+        Clock::time_point start = Clock::now();
+        for (size_t done = 0; done < count; done += BATCH) {
+            Clock::time_point batch_start = Clock::now();
+            for (size_t i = 0; i < BATCH; ++i) sum += stopwatch.GetElapsedNanoseconds().count();
+            lock_free.Add(Nanoseconds(Clock::now() - batch_start) / BATCH);
+        }
+        double lock_free_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        start = Clock::now();
+        for (size_t done = 0; done < count; done += BATCH) {
+            Clock::time_point batch_start = Clock::now();
+            for (size_t i = 0; i < BATCH; ++i) sum += LockedElapsed(stopwatch).count();
+            locked.Add(Nanoseconds(Clock::now() - batch_start) / BATCH);
+        }
+        double locked_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        stop = true;
+        for (std::thread& thread : threads) thread.join();
+        Consume(&sum);
+        
+        size_t reads = (count + BATCH - 1) / BATCH * BATCH;
+        std::printf("  %d control thread%s, %llu transitions\n", controls, controls == 1 ? "" : "s",
+                    static_cast<unsigned long long>(transitions.load()));
+        lock_free.Print("seqlock read", "ns");
+        locked.Print("mutex read", "ns");
+        std::printf("  %-14s seqlock %.2f M/s, mutex %.2f M/s of wall time\n", "throughput",
+                    static_cast<double>(reads) / lock_free_seconds / 1e6, static_cast<double>(reads) / locked_seconds / 1e6);
+    }
+    std::printf("  %u hardware threads\n", std::thread::hardware_concurrency());
+    return 0;
+}
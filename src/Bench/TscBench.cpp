@@ -0,0 +1,54 @@
+#include "Bench.h"
+#include "../TscClock.h"
+#include <cstdio>
+#include <thread>
+
+namespace {
+    constexpr int READS = 10000000;
+    constexpr auto DRIFT_STEP = std::chrono::milliseconds(100);
+    
+    template <typename Read>
+    double ReadCost(Read read) {
+        int64_t sum = 0;
+        Bench::Clock::time_point start = Bench::Clock::now();
+        for (int i = 0; i < READS; ++i) sum += read().time_since_epoch().count();
+        double ns = Bench::Nanoseconds(Bench::Clock::now() - start) / READS;
+        Bench::Consume(&sum);
+        return ns;
+    }
+}
+
+int Bench::RunTsc(size_t seconds) {
+    if (seconds == 0) seconds = 10;
+    
+    TscClock tsc;
+    std::printf("TscClock: %s\n", tsc.IsAvailable() ? "invariant TSC" : "no invariant TSC, steady_clock fallback");
+    std::printf("  read cost      steady_clock %.1f ns, TscClock %.1f ns (%d reads each)\n",
+                ReadCost([]() { return std::chrono::steady_clock::now(); }),
+                ReadCost([&tsc]() { return tsc.Now(); }), READS);
+    
+    // TSC time minus steady_clock, with the steady read bracketed by two TSC reads
+    Series error, bracket;
+    Clock::time_point next = Clock::now();
+    auto samples = std::chrono::seconds(seconds) / DRIFT_STEP;
+    for (int64_t i = 0; i < samples; ++i) {
+        next += DRIFT_STEP;
+        std::this_thread::sleep_until(next);
+        Clock::time_point before = tsc.Now();
+        Clock::time_point steady = Clock::now();
+        Clock::time_point after = tsc.Now();
+        error.Add(Microseconds(before + (after - before) / 2 - steady));
+        bracket.Add(Microseconds(after - before));
+    }
+    
+    TscClock::Status status = tsc.GetStatus();
+    std::printf("  drift over %zu s, sampled every %lld ms:\n", seconds,
+                static_cast<long long>(DRIFT_STEP.count()));
+    error.Print("TSC - steady", "us");
+    bracket.Print("read bracket", "us");
+    std::printf("  %.3f MHz, %llu rechecks, last error %lld ns, max %lld ns, correction %.2f ppm\n",
+                status.frequency_hz / 1e6, static_cast<unsigned long long>(status.checks),
+                static_cast<long long>(status.last_error.count()), static_cast<long long>(status.max_error.count()),
+                status.correction_ppm);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "Bench.h"
+#include "../TimeZone.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    // Zones with odd offsets, southern DST, half-hour DST and rule changes
+    const char* const ZONES[] = {
+        "Europe/Sofia",
+        "Europe/London",
+        "America/New_York",
+        "America/St_Johns",
+        "America/Sao_Paulo",
+        "Asia/Kolkata",
+        "Australia/Lord_Howe",
+        "Pacific/Chatham",
+        "Africa/Casablanca",
+    };
+    
+    // 1901 to 2106: the whole 32-bit range and a good stretch of the POSIX footer rule
+    constexpr int64_t FIRST = -2147483648LL;
+    constexpr int64_t LAST = 4294967295LL;
+    constexpr int TIMING_CALLS = 1000000;
+}
+
+#ifdef _WIN32
+int Bench::RunZoneCheck(size_t) {
+    std::printf("Time zone check: needs localtime_r and TZif zoneinfo, skipped\n");
+    return 0;
+}
+#else
+namespace {
+    // A one-type TZif whose abbreviation index points past its characters
+    bool RejectsBadAbbreviation() {
+        char path[] = "/tmp/tzcheckXXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0) return true;
+        unsigned char data[44 + 6 + 4] = { 'T', 'Z', 'i', 'f' };
+        data[20 + 4 * 4 + 3] = 1; // typecnt
+        data[20 + 5 * 4 + 3] = 4; // charcnt
+        data[44 + 5] = 9;         // abbreviation index
+        std::memcpy(data + 50, "UTC", 4);
+        bool written = write(fd, data, sizeof(data)) == static_cast<ssize_t>(sizeof(data));
+        close(fd);
+        bool rejected = !written || !TimeZone::Load(path);
+        unlink(path);
+        return rejected;
+    }
+    
+    void SetTz(const char* name) {
+        setenv("TZ", name, 1);
+        tzset();
+    }
+    
+    // True when the two agree
+    bool Matches(const TimeZone& zone, int64_t t) {
+        time_t value = static_cast<time_t>(t);
+        struct tm expected;
+        if (!localtime_r(&value, &expected)) return true; // outside what glibc handles
+        
+        TimeZone::LocalTime local = zone.ToLocal(t);
+        return local.fields.year == expected.tm_year + 1900
+            && local.fields.month == expected.tm_mon + 1
+            && local.fields.day == expected.tm_mday
+            && local.fields.weekday == expected.tm_wday
+            && local.fields.hours == expected.tm_hour
+            && local.fields.minutes == expected.tm_min
+            && local.fields.seconds == expected.tm_sec
+            && local.offset == expected.tm_gmtoff
+            && local.is_dst == (expected.tm_isdst > 0)
+            && std::strcmp(local.abbreviation, expected.tm_zone) == 0;
+    }
+}
+
+int Bench::RunZoneCheck(size_t samples) {
+    if (samples == 0) samples = 200000;
+    
+    const char* saved = std::getenv("TZ");
+    std::string saved_tz = saved ? saved : "";
+    
+    size_t checked = 0, mismatches = 0, zones = 0;
+    std::printf("TimeZone against glibc localtime_r, %zu random times per zone plus both sides of every transition:\n",
+                samples);
+    for (const char* name : ZONES) {
+        std::shared_ptr<const TimeZone> zone = TimeZone::Load(name);
+        if (!zone) {
+            std::printf("  %-22s not installed, skipped\n", name);
+            continue;
+        }
+        ++zones;
+        SetTz(name);
+        
+        size_t zone_mismatches = 0, transitions = 0;
+        auto check = [&](int64_t t) {
+            ++checked;
+            if (Matches(*zone, t)) return;
+            if (++zone_mismatches <= 3) std::printf("  %-22s differs at %lld\n", name, static_cast<long long>(t));
+        };
+        
+        // Walk the offset windows; each ends at the next transition
+        for (int64_t t = FIRST; t < LAST; ) {
+            int64_t until = 0;
+            zone->GetOffset(t, &until);
+            if (until >= LAST) break;
+            check(until - 1);
+            check(until);
+            ++transitions;
+            t = until;
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < samples; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            check(FIRST + static_cast<int64_t>((state >> 11) % static_cast<uint64_t>(LAST - FIRST)));
+        }
+        
+        // A clock ticking one second at a time: the cached window vs glibc
+        int64_t now = static_cast<int64_t>(std::time(nullptr));
+        Clock::time_point start = Clock::now();
+        int sum = 0;
+        for (int i = 0; i < TIMING_CALLS; ++i) sum += zone->ToLocal(now + i).fields.seconds;
+        double engine_ns = Nanoseconds(Clock::now() - start) / TIMING_CALLS;
+        start = Clock::now();
+        for (int i = 0; i < TIMING_CALLS; ++i) sum += zone->GetOffset(now + i);
+        double offset_ns = Nanoseconds(Clock::now() - start) / TIMING_CALLS;
+        start = Clock::now();
+        for (int i = 0; i < TIMING_CALLS; ++i) {
+            time_t value = static_cast<time_t>(now + i);
+            struct tm fields;
+            localtime_r(&value, &fields);
+            sum += fields.tm_sec;
+        }
+        double glibc_ns = Nanoseconds(Clock::now() - start) / TIMING_CALLS;
+        Consume(&sum);
+        
+        std::printf("  %-22s %4zu transitions, %zu mismatches; ToLocal %5.1f ns, GetOffset %4.1f ns, localtime_r %6.1f ns\n",
+                    name, transitions, zone_mismatches, engine_ns, offset_ns, glibc_ns);
+        mismatches += zone_mismatches;
+    }
+    
+    if (saved) {
+        SetTz(saved_tz.c_str());
+    } else {
+        unsetenv("TZ");
+        tzset();
+    }
+    if (!RejectsBadAbbreviation()) {
+        std::printf("  TZif with an out-of-range abbreviation index was accepted\n");
+        ++mismatches;
+    }
+    std::printf("  %zu zones, %zu times checked, %zu mismatches\n", zones, checked, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,98 @@
+#include "CallbackExecutor.h"
+#include <iostream>
+
+CallbackExecutor::CallbackExecutor(size_t capacity)
+    : queue_(capacity) {
+    thread_ = std::thread(&CallbackExecutor::Run, this);
+}
+
+CallbackExecutor::~CallbackExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        sleeping_.store(false);
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool CallbackExecutor::Post(InlineCallback&& callback) {
+    if (!queue_.TryPush(std::move(callback))) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    
+    size_t depth = queue_.SizeApprox();
+    size_t max_depth = max_depth_.load(std::memory_order_relaxed);
+    while (depth > max_depth && !max_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+    }
+    
+    // Pairs with the fence in Run(): either the worker sees the new item
+    // before sleeping, or we see it asleep and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sleeping_.store(false, std::memory_order_relaxed);
+        wake_.notify_one();
+    }
+    return true;
+}
+
+void CallbackExecutor::Drain() {
+    if (IsExecutorThread()) return;
+    
+    uint64_t target = posted_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this, target]() {
+        return executed_.load(std::memory_order_acquire) >= target || stop_;
+    });
+}
+
+CallbackExecutor::Stats CallbackExecutor::GetStats() const {
+    Stats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.executed = executed_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.max_depth = max_depth_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CallbackExecutor::Run() {
+    InlineCallback callback;
+    for (;;) {
+        while (queue_.TryPop(callback)) {
+            Execute(callback);
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.notify_all();
+        if (stop_) break;
+        
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.SizeApprox() > 0) {
+            sleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        wake_.wait(lock, [this]() { return !sleeping_.load(std::memory_order_relaxed); });
+    }
+    
+    // Anything posted during shutdown still runs
+    while (queue_.TryPop(callback)) {
+        Execute(callback);
+    }
+}
+
+void CallbackExecutor::Execute(InlineCallback& callback) {
+    try {
+        callback();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Timer callback error: " << e.what() << std::endl;
+    }
+    callback.Reset();
+    executed_.fetch_add(1, std::memory_order_release);
+}
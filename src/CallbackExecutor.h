@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InlineCallback.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Runs completion callbacks on its own thread, so a slow user callback holds
+// up neither the UI nor the timer service. Posting is lock-free and
+// allocation-free; the worker only takes a lock to go to sleep.
+class CallbackExecutor {
+public:
+    struct Stats {
+        uint64_t posted = 0;
+        uint64_t executed = 0;
+        uint64_t rejected = 0;   // queue was full
+        size_t max_depth = 0;
+    };
+    
+    explicit CallbackExecutor(size_t capacity = 1024);
+    ~CallbackExecutor(); // runs whatever is still queued
+    
+    CallbackExecutor(const CallbackExecutor&) = delete;
+    CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+    
+    // Any thread. Returns false (leaving `callback` intact) if the queue is full.
+    bool Post(InlineCallback&& callback);
+    
+    // Blocks until everything posted before the call has run. Returns
+    // immediately on the executor thread itself.
+    void Drain();
+    
+    bool IsExecutorThread() const { return std::this_thread::get_id() == thread_.get_id(); }
+    
+    Stats GetStats() const;
+
+private:
+    void Run();
+    void Execute(InlineCallback& callback);
+    
+    BoundedMpscQueue<InlineCallback> queue_;
+    
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<size_t> max_depth_{0};
+    
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::atomic<bool> sleeping_{false};
+    bool stop_ = false;
+    std::thread thread_;
+};
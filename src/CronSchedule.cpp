@@ -0,0 +1,354 @@
+#include "CronSchedule.h"
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    constexpr int64_t MINUTES_PER_DAY = 1440;
+    
+    // Wall times repeated by a backward transition lie within this much of
+    // it. The largest step back on record is Alaska's 1867 change of date.
+    constexpr int64_t REPEAT_MARGIN = 2 * 86400;
+    
+    // Every month/day/weekday combination recurs within the 400-year
+    // Gregorian cycle, and each month costs at most a couple of steps
+    constexpr int MAX_SEARCH_STEPS = 400 * 12 * 2 + 8;
+    
+    const char* const MONTH_NAMES[] = {
+        "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+    };
+    const char* const WEEKDAY_NAMES[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT" };
+    
+    struct Shorthand {
+        const char* name;
+        const char* expression;
+    };
+    
+    const Shorthand SHORTHANDS[] = {
+        { "@yearly", "0 0 1 1 *" },
+        { "@annually", "0 0 1 1 *" },
+        { "@monthly", "0 0 1 * *" },
+        { "@weekly", "0 0 * * 0" },
+        { "@daily", "0 0 * * *" },
+        { "@midnight", "0 0 * * *" },
+        { "@hourly", "0 * * * *" }
+    };
+    
+    int64_t FloorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+    
+    bool IsLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+    
+    int DaysInMonth(int year, int month) {
+        static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && IsLeapYear(year) ? 29 : DAYS[month - 1];
+    }
+    
+    // Bits `first` and up; empty once `first` runs off the end
+    uint64_t BitsFrom(int first) {
+        return first < 64 ? ~0ULL << first : 0;
+    }
+    
+    uint64_t BitRange(int first, int last) {
+        return BitsFrom(first) & ~BitsFrom(last + 1);
+    }
+    
+    int Lowest(uint64_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+    
+    bool IsSpace(char c) {
+        return c == ' ' || c == '\t';
+    }
+    
+    char ToUpper(char c) {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    
+    // A number or, when `names` is given, a three-letter name. Returns the
+    // position after it, or nullptr.
+    const char* ParseValue(const char* p, int min, int max, const char* const* names, int name_count, int& value) {
+        if (names && ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))) {
+            for (int i = 0; i < name_count; ++i) {
+                if (ToUpper(p[0]) == names[i][0] && ToUpper(p[1]) == names[i][1] && ToUpper(p[2]) == names[i][2]) {
+                    value = min + i;
+                    return p + 3;
+                }
+            }
+            return nullptr;
+        }
+        
+        if (*p < '0' || *p > '9') return nullptr;
+        value = 0;
+        while (*p >= '0' && *p <= '9') {
+            value = value * 10 + (*p++ - '0');
+            if (value > max) return nullptr;
+        }
+        return value >= min ? p : nullptr;
+    }
+    
+    // One whitespace-delimited field: a comma list of *, N, A-B, */S, A-B/S.
+    // Sets the matching bits in `mask`; returns the position after the field.
+    const char* ParseField(const char* p, int min, int max, const char* const* names, int name_count, uint64_t& mask) {
+        mask = 0;
+        for (;;) {
+            int first = min;
+            int last = max;
+            bool single = false;
+            
+            if (*p == '*') {
+                ++p;
+            } else {
+                p = ParseValue(p, min, max, names, name_count, first);
+                if (!p) return nullptr;
+                last = first;
+                single = true;
+                if (*p == '-') {
+                    p = ParseValue(p + 1, min, max, names, name_count, last);
+                    if (!p || last < first) return nullptr;
+                    single = false;
+                }
+            }
+            
+            int step = 1;
+            if (*p == '/') {
+                p = ParseValue(p + 1, 1, max, nullptr, 0, step);
+                if (!p) return nullptr;
+                // "N/S" means N through the end of the range
+                if (single) last = max;
+            }
+            
+            for (int value = first; value <= last; value += step) {
+                mask |= 1ULL << value;
+            }
+            
+            if (*p != ',') break;
+            ++p;
+        }
+        return (*p == '\0' || IsSpace(*p)) ? p : nullptr;
+    }
+    
+    const char* SkipSpaces(const char* p) {
+        while (IsSpace(*p)) ++p;
+        return p;
+    }
+}
+
+CronSchedule::CronSchedule()
+    : minutes_(0)
+    , hours_(0)
+    , days_(0)
+    , months_(0)
+    , weekdays_(0)
+    , either_day_(false)
+    , valid_(false) {
+    std::memset(weekday_days_, 0, sizeof(weekday_days_));
+}
+
+CronSchedule::CronSchedule(const char* expression)
+    : CronSchedule() {
+    Compile(expression);
+}
+
+bool CronSchedule::Compile(const char* expression) {
+    *this = CronSchedule();
+    if (!expression) return false;
+    
+    const char* p = SkipSpaces(expression);
+    if (*p == '@') {
+        size_t length = 0;
+        while (p[length] && !IsSpace(p[length])) ++length;
+        
+        const char* expanded = nullptr;
+        for (const Shorthand& shorthand : SHORTHANDS) {
+            if (std::strlen(shorthand.name) == length && std::strncmp(shorthand.name, p, length) == 0) {
+                expanded = shorthand.expression;
+            }
+        }
+        if (!expanded || *SkipSpaces(p + length) != '\0') return false;
+        p = expanded;
+    }
+    
+    uint64_t minutes, hours, days, months, weekdays;
+    
+    // Cron only counts a day field as unrestricted if it starts with '*'
+    bool any_day = false;
+    bool any_weekday = false;
+    
+    p = ParseField(SkipSpaces(p), 0, 59, nullptr, 0, minutes);
+    if (p) p = ParseField(SkipSpaces(p), 0, 23, nullptr, 0, hours);
+    if (p) {
+        p = SkipSpaces(p);
+        any_day = *p == '*';
+        p = ParseField(p, 1, 31, nullptr, 0, days);
+    }
+    if (p) p = ParseField(SkipSpaces(p), 1, 12, MONTH_NAMES, 12, months);
+    if (p) {
+        p = SkipSpaces(p);
+        any_weekday = *p == '*';
+        p = ParseField(p, 0, 7, WEEKDAY_NAMES, 7, weekdays);
+    }
+    if (!p || *SkipSpaces(p) != '\0') return false;
+    
+    // 7 is Sunday too
+    if (weekdays & (1ULL << 7)) {
+        weekdays = (weekdays | 1) & ~(1ULL << 7);
+    }
+    
+    minutes_ = minutes;
+    hours_ = static_cast<uint32_t>(hours);
+    days_ = static_cast<uint32_t>(days);
+    months_ = static_cast<uint16_t>(months);
+    weekdays_ = static_cast<uint8_t>(weekdays);
+    either_day_ = !any_day && !any_weekday;
+    
+    for (int first = 0; first < 7; ++first) {
+        uint32_t mask = 0;
+        for (int day = 1; day <= 31; ++day) {
+            if (weekdays_ & (1u << ((first + day - 1) % 7))) {
+                mask |= 1u << day;
+            }
+        }
+        weekday_days_[first] = mask;
+    }
+    
+    valid_ = true;
+    return true;
+}
+
+uint64_t CronSchedule::DayMask(int year, int month, int64_t first_day) const {
+    uint64_t by_weekday = weekday_days_[TimeZone::WeekdayFromDays(first_day)];
+    uint64_t days = either_day_ ? (days_ | by_weekday) : (days_ & by_weekday);
+    return days & BitRange(1, DaysInMonth(year, month));
+}
+
+int64_t CronSchedule::NextLocal(int64_t local_seconds) const {
+    if (!valid_) return NO_MATCH;
+    
+    int64_t minute_count = FloorDiv(local_seconds, 60) + 1;
+    int64_t days = FloorDiv(minute_count, MINUTES_PER_DAY);
+    int minute_of_day = static_cast<int>(minute_count - days * MINUTES_PER_DAY);
+    int hour = minute_of_day / 60;
+    int minute = minute_of_day % 60;
+    int year, month, day;
+    TimeZone::CivilFromDays(days, year, month, day);
+    
+    // Day number of the 1st of `month`; recomputed only when the month moves
+    int64_t first_day = days - (day - 1);
+    bool first_day_known = true;
+    
+    // Narrow one field at a time; a field with nothing left rolls the next
+    // larger one over and resets everything below it
+    for (int step = 0; step < MAX_SEARCH_STEPS; ++step) {
+        uint64_t month_bits = months_ & BitsFrom(month);
+        if (!month_bits) {
+            ++year;
+            month = 1;
+            day = 1;
+            hour = minute = 0;
+            first_day_known = false;
+            continue;
+        }
+        int next_month = Lowest(month_bits);
+        if (next_month != month) {
+            month = next_month;
+            day = 1;
+            hour = minute = 0;
+            first_day_known = false;
+        }
+        if (!first_day_known) {
+            first_day = TimeZone::DaysFromCivil(year, month, 1);
+            first_day_known = true;
+        }
+        
+        uint64_t day_bits = DayMask(year, month, first_day) & BitsFrom(day);
+        if (!day_bits) {
+            first_day += DaysInMonth(year, month);
+            if (++month > 12) {
+                month = 1;
+                ++year;
+            }
+            day = 1;
+            hour = minute = 0;
+            continue;
+        }
+        int next_day = Lowest(day_bits);
+        if (next_day != day) {
+            day = next_day;
+            hour = minute = 0;
+        }
+        
+        uint64_t hour_bits = hours_ & BitsFrom(hour);
+        if (!hour_bits) {
+            ++day;
+            hour = minute = 0;
+            continue;
+        }
+        int next_hour = Lowest(hour_bits);
+        if (next_hour != hour) {
+            hour = next_hour;
+            minute = 0;
+        }
+        
+        uint64_t minute_bits = minutes_ & BitsFrom(minute);
+        if (!minute_bits) {
+            ++hour;
+            minute = 0;
+            continue;
+        }
+        minute = Lowest(minute_bits);
+        
+        return ((first_day + day - 1) * MINUTES_PER_DAY + hour * 60 + minute) * 60;
+    }
+    return NO_MATCH;
+}
+
+int64_t CronSchedule::Next(int64_t utc_seconds, const TimeZone& zone, int64_t* local_seconds) const {
+    TimeZone::OffsetRange range = zone.GetOffsetRange(utc_seconds);
+    int64_t local = utc_seconds + range.offset;
+    for (;;) {
+        local = NextLocal(local);
+        if (local == NO_MATCH) return NO_MATCH;
+        
+        // Most matches fall in the window already in hand, or in the one
+        // they land in under its offset. Away from the window's start (where
+        // a backward transition repeats wall times), that offset maps the
+        // match back exactly.
+        int64_t utc = local - range.offset;
+        if (utc >= range.until) {
+            range = zone.FindOffsetRange(utc);
+            utc = local - range.offset;
+        }
+        if (utc < range.until && utc - REPEAT_MARGIN >= range.from) {
+            if (local_seconds) *local_seconds = local;
+            return utc;
+        }
+        
+        // Near a transition. LocalToUtc() maps a repeated time to its first
+        // pass, which is behind us while we are inside the second one.
+        utc = zone.LocalToUtc(local);
+        if (utc <= utc_seconds) continue;
+        
+        // A skipped time comes back pushed forward by the gap; fire at the
+        // transition instead, under the wall time shown from then on
+        int32_t offset = zone.GetOffset(utc);
+        if (utc + offset != local) {
+            zone.GetOffset(local - offset, &utc);
+            local = utc + offset;
+        }
+        if (local_seconds) *local_seconds = local;
+        return utc;
+    }
+}
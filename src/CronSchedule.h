@@ -0,0 +1,51 @@
+#pragma once
+
+#include "TimeZone.h"
+#include <cstdint>
+
+// A cron-style recurring schedule compiled to one bitset per field. The next
+// matching minute is found with a few bit scans (month, then day, hour,
+// minute) instead of stepping through the calendar, and nothing allocates.
+//
+// Expression: "minute hour day-of-month month day-of-week". Each field is a
+// comma list of *, N, A-B, */S or A-B/S. Months and weekdays also accept
+// three-letter names (JAN, MON); weekday 7 is Sunday as well. As in cron,
+// when both day fields are restricted a day matches if either one does.
+// Shorthands: @yearly, @monthly, @weekly, @daily, @hourly.
+class CronSchedule {
+public:
+    static constexpr int64_t NO_MATCH = INT64_MAX;
+    
+    CronSchedule();
+    explicit CronSchedule(const char* expression);
+    
+    // Returns false (and leaves the schedule empty) on a malformed expression
+    bool Compile(const char* expression);
+    bool IsValid() const { return valid_; }
+    
+    // First matching local wall time strictly after `local_seconds`, both in
+    // seconds since 1970-01-01 00:00 local. NO_MATCH if the fields can never
+    // line up (e.g. February 30th).
+    int64_t NextLocal(int64_t local_seconds) const;
+    
+    // First firing strictly after `utc_seconds` in `zone`, in UTC seconds.
+    // Times skipped by a DST gap fire once at the end of the gap; times
+    // repeated by a backward transition fire on their first pass only.
+    // Optionally reports the local wall time it fires at.
+    int64_t Next(int64_t utc_seconds, const TimeZone& zone, int64_t* local_seconds = nullptr) const;
+
+private:
+    // Matching days of `month` (bits 1-31); `first_day` is the day number of the 1st
+    uint64_t DayMask(int year, int month, int64_t first_day) const;
+    
+    uint64_t minutes_;   // bits 0-59
+    uint32_t hours_;     // bits 0-23
+    uint32_t days_;      // bits 1-31
+    uint16_t months_;    // bits 1-12
+    uint8_t weekdays_;   // bits 0-6, 0 = Sunday
+    bool either_day_;    // both day fields restricted: match on either
+    bool valid_;
+    
+    // Days of a month matching weekdays_, indexed by the weekday of the 1st
+    uint32_t weekday_days_[7];
+};
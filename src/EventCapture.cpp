@@ -0,0 +1,90 @@
+#include "EventCapture.h"
+#include <algorithm>
+
+EventCapture::EventCapture(size_t capacity)
+    : queue_(capacity)
+    , last_applied_(Clock::time_point::min()) {
+    batch_.reserve(queue_.Capacity());
+}
+
+bool EventCapture::Capture(Action action, uint32_t source) {
+    // Timestamp first; everything after this is bookkeeping
+    return Capture(action, clock_ ? clock_->Now() : Clock::now(), source);
+}
+
+bool EventCapture::Capture(Action action, Clock::time_point time, uint32_t source) {
+    Event event;
+    event.time = time;
+    event.action = action;
+    event.source = source;
+    
+    if (!queue_.TryPush(std::move(event))) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t EventCapture::Drain(Timer& timer) {
+    // Bounded by the ring size so producers cannot keep us here forever
+    Event event;
+    while (batch_.size() < queue_.Capacity() && queue_.TryPop(event)) {
+        batch_.push_back(event);
+    }
+    if (batch_.empty()) return 0;
+    
+    // Producers race between reading the clock and pushing, so ring order
+    // is only roughly time order
+    std::stable_sort(batch_.begin(), batch_.end(), [](const Event& a, const Event& b) {
+        return a.time < b.time;
+    });
+    
+    for (Event& pending : batch_) {
+        if (pending.time < last_applied_) {
+            // Older than something already applied in an earlier batch
+            pending.time = last_applied_;
+            ++stats_.reordered;
+        }
+        Apply(timer, pending);
+        last_applied_ = pending.time;
+    }
+    
+    size_t count = batch_.size();
+    stats_.applied += count;
+    stats_.max_batch = std::max(stats_.max_batch, count);
+    batch_.clear();
+    return count;
+}
+
+EventCapture::Stats EventCapture::GetStats() const {
+    Stats stats = stats_;
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventCapture::Apply(Timer& timer, const Event& event) {
+    switch (event.action) {
+        case Action::Lap:
+            timer.Lap(event.time);
+            break;
+        case Action::Start:
+            timer.Start(event.time);
+            break;
+        case Action::Pause:
+            timer.Pause(event.time);
+            break;
+        case Action::Resume:
+            timer.Resume(event.time);
+            break;
+        case Action::Stop:
+            timer.Stop();
+            break;
+        case Action::Toggle:
+            switch (timer.GetState()) {
+                case Timer::State::Stopped: timer.Start(event.time); break;
+                case Timer::State::Running: timer.Pause(event.time); break;
+                case Timer::State::Paused: timer.Resume(event.time); break;
+            }
+            break;
+    }
+}
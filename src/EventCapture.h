@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "MpscQueue.h"
+#include "Timer.h"
+#include "TscClock.h"
+
+// Timestamps stopwatch events (hotkeys, IPC triggers, scripted marks) on
+// whatever thread sees them and hands them to the thread that owns the
+// Timer. Capture() reads the clock before anything else and pushes into a
+// lock-free ring, so an event carries the time it happened rather than the
+// time the UI got round to it. Drain() applies a batch in timestamp order.
+class EventCapture {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class Action : uint8_t {
+        Lap,
+        Start,
+        Pause,
+        Resume,
+        Stop,
+        Toggle // Start, Pause or Resume, whichever fits the timer's state
+    };
+    
+    struct Event {
+        Clock::time_point time;
+        Action action = Action::Lap;
+        uint32_t source = 0; // caller-defined, e.g. a hotkey id
+    };
+    
+    struct Stats {
+        uint64_t applied = 0;
+        uint64_t dropped = 0;   // ring was full
+        uint64_t reordered = 0; // arrived after a newer event was applied
+        size_t max_batch = 0;
+    };
+    
+    explicit EventCapture(size_t capacity = 4096);
+    
+    EventCapture(const EventCapture&) = delete;
+    EventCapture& operator=(const EventCapture&) = delete;
+    
+    // Must match the timer's clock source; set before producers start
+    void SetClockSource(const TscClock* clock) { clock_ = clock; }
+    
+    // Any thread. Returns false if the ring is full.
+    bool Capture(Action action, uint32_t source = 0);
+    
+    // Any thread, for events that come with their own timestamp
+    bool Capture(Action action, Clock::time_point time, uint32_t source = 0);
+    
+    // Owner thread. Applies everything captured so far to `timer` and
+    // returns the number of events applied.
+    size_t Drain(Timer& timer);
+    
+    Stats GetStats() const;
+
+private:
+    void Apply(Timer& timer, const Event& event);
+    
+    BoundedMpscQueue<Event> queue_;
+    const TscClock* clock_ = nullptr;
+    std::atomic<uint64_t> dropped_{0};
+    
+    // Owner thread only
+    std::vector<Event> batch_;
+    Clock::time_point last_applied_;
+    Stats stats_;
+};
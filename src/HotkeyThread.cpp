@@ -0,0 +1,126 @@
+#include "HotkeyThread.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include "WindowsHeaders.h"
+#endif
+
+namespace {
+#ifdef _WIN32
+    struct Binding {
+        int id;
+        UINT key;
+        EventCapture::Action action;
+    };
+    
+    const Binding BINDINGS[] = {
+        { 1, 'S', EventCapture::Action::Toggle },
+        { 2, 'L', EventCapture::Action::Lap },
+        { 3, 'X', EventCapture::Action::Stop }
+    };
+    
+    const UINT HOTKEY_MODIFIERS = MOD_CONTROL | MOD_ALT | MOD_NOREPEAT;
+#endif
+}
+
+HotkeyThread::HotkeyThread(EventCapture& events, const TscClock* clock)
+    : events_(events)
+    , clock_(clock) {
+}
+
+HotkeyThread::~HotkeyThread() {
+    Stop();
+}
+
+bool HotkeyThread::Start() {
+#ifdef _WIN32
+    if (thread_.joinable()) return true;
+    
+    running_ = true;
+    thread_ = std::thread(&HotkeyThread::Run, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HotkeyThread::Stop() {
+    if (!thread_.joinable()) return;
+    
+#ifdef _WIN32
+    // The thread may not have created its queue yet; keep posting until it has
+    while (running_ && !PostThreadMessageW(thread_id_.load(), WM_QUIT, 0, 0)) {
+        std::this_thread::yield();
+    }
+#endif
+    thread_.join();
+    running_ = false;
+}
+
+HotkeyThread::Stats HotkeyThread::GetStats() const {
+    Stats stats;
+    stats.events = event_count_.load(std::memory_order_relaxed);
+    stats.registered = registered_.load(std::memory_order_relaxed);
+    stats.last_queue_delay = std::chrono::nanoseconds{last_queue_delay_.load(std::memory_order_relaxed)};
+    stats.max_queue_delay = std::chrono::nanoseconds{max_queue_delay_.load(std::memory_order_relaxed)};
+    return stats;
+}
+
+void HotkeyThread::SetOnEvent(InlineCallback&& callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_event_ = std::move(callback);
+}
+
+void HotkeyThread::Run() {
+#ifdef _WIN32
+    // Hotkey messages for a null window go to this thread's queue; force the
+    // queue into existence before anyone posts to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    thread_id_ = GetCurrentThreadId();
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+    
+    for (const Binding& binding : BINDINGS) {
+        if (RegisterHotKey(nullptr, binding.id, HOTKEY_MODIFIERS, binding.key)) {
+            registered_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::cerr << "Hotkey Ctrl+Alt+" << static_cast<char>(binding.key) << " is already in use" << std::endl;
+        }
+    }
+    
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        if (msg.message != WM_HOTKEY) continue;
+        
+        // Timestamp before anything else, then back-date by the time the
+        // message spent queued (GetTickCount resolution)
+        auto now = clock_ ? clock_->Now() : std::chrono::steady_clock::now();
+        DWORD age = GetTickCount() - msg.time;
+        auto delay = std::chrono::milliseconds(age < 1000 ? age : 0);
+        
+        for (const Binding& binding : BINDINGS) {
+            if (binding.id == static_cast<int>(msg.wParam)) {
+                events_.Capture(binding.action, now - delay, static_cast<uint32_t>(binding.id));
+                event_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (on_event_) {
+                on_event_();
+            }
+        }
+        
+        int64_t delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+        last_queue_delay_.store(delay_ns, std::memory_order_relaxed);
+        if (delay_ns > max_queue_delay_.load(std::memory_order_relaxed)) {
+            max_queue_delay_.store(delay_ns, std::memory_order_relaxed);
+        }
+    }
+    
+    for (const Binding& binding : BINDINGS) {
+        UnregisterHotKey(nullptr, binding.id);
+    }
+    running_ = false;
+#endif
+}
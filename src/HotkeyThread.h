@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "EventCapture.h"
+#include "InlineCallback.h"
+#include "TscClock.h"
+
+// System-wide stopwatch hotkeys handled on their own thread, so a key press
+// is timestamped the moment Windows delivers WM_HOTKEY instead of whenever
+// the UI thread next gets through a frame. Events go through an
+// EventCapture, which applies them with that timestamp.
+//
+// Ctrl+Alt+S start/pause/resume, Ctrl+Alt+L lap, Ctrl+Alt+X stop.
+// Windows only; Start() returns false elsewhere.
+class HotkeyThread {
+public:
+    struct Stats {
+        uint64_t events = 0;
+        uint64_t registered = 0;  // hotkeys we own; others may be taken by another app
+        std::chrono::nanoseconds last_queue_delay{0}; // WM_HOTKEY post to dispatch, tick resolution
+        std::chrono::nanoseconds max_queue_delay{0};
+    };
+    
+    HotkeyThread(EventCapture& events, const TscClock* clock);
+    ~HotkeyThread();
+    
+    HotkeyThread(const HotkeyThread&) = delete;
+    HotkeyThread& operator=(const HotkeyThread&) = delete;
+    
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_relaxed); }
+    
+    Stats GetStats() const;
+    
+    // Runs on the hotkey thread after each captured event, e.g. to wake a UI
+    // that sleeps between frames. Must not call SetOnEvent() itself.
+    void SetOnEvent(InlineCallback&& callback);
+
+private:
+    void Run();
+    
+    EventCapture& events_;
+    const TscClock* clock_;
+    
+    std::mutex callback_mutex_; // guards on_event_
+    InlineCallback on_event_;
+    
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<unsigned long> thread_id_{0};
+    
+    std::atomic<uint64_t> event_count_{0};
+    std::atomic<uint64_t> registered_{0};
+    std::atomic<int64_t> last_queue_delay_{0};
+    std::atomic<int64_t> max_queue_delay_{0};
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only `void()` callable stored inline. Unlike std::function it never
+// allocates: a callable that does not fit CAPACITY bytes fails to compile.
+// The whole object is one cache line.
+class InlineCallback {
+public:
+    static constexpr size_t CAPACITY = 48;
+    
+    InlineCallback() noexcept = default;
+    
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlineCallback>::value>>
+    InlineCallback(F&& function) {
+        using Stored = std::decay_t<F>;
+        static_assert(sizeof(Stored) <= CAPACITY, "callable too large for InlineCallback; capture less");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "callable over-aligned for InlineCallback");
+        static_assert(std::is_nothrow_move_constructible<Stored>::value, "callable must be nothrow movable");
+        
+        new (&storage_) Stored(std::forward<F>(function));
+        ops_ = &OpsFor<Stored>::ops;
+    }
+    
+    InlineCallback(InlineCallback&& other) noexcept {
+        MoveFrom(other);
+    }
+    
+    InlineCallback& operator=(InlineCallback&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+    
+    InlineCallback(const InlineCallback&) = delete;
+    InlineCallback& operator=(const InlineCallback&) = delete;
+    
+    ~InlineCallback() {
+        Reset();
+    }
+    
+    void operator()() {
+        ops_->invoke(&storage_);
+    }
+    
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+    
+    void Reset() noexcept {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to) noexcept; // move-constructs into `to`, destroys `from`
+        void (*destroy)(void* storage) noexcept;
+    };
+    
+    template <typename Stored>
+    struct OpsFor {
+        static void Invoke(void* storage) {
+            (*static_cast<Stored*>(storage))();
+        }
+        static void Move(void* from, void* to) noexcept {
+            new (to) Stored(std::move(*static_cast<Stored*>(from)));
+            static_cast<Stored*>(from)->~Stored();
+        }
+        static void Destroy(void* storage) noexcept {
+            static_cast<Stored*>(storage)->~Stored();
+        }
+        static constexpr Ops ops = { Invoke, Move, Destroy };
+    };
+    
+    void MoveFrom(InlineCallback& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(&other.storage_, &storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+    
+    const Ops* ops_ = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[CAPACITY];
+};
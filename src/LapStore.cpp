@@ -0,0 +1,76 @@
+#include "LapStore.h"
+#include <cmath>
+
+LapStore::LapStore()
+    : count_(0)
+    , last_split_(0)
+    , mean_(0.0)
+    , m2_(0.0) {
+}
+
+void LapStore::Record(std::chrono::nanoseconds split) {
+    size_t chunk_index = count_ / CHUNK_SIZE;
+    size_t offset = count_ % CHUNK_SIZE;
+    
+    if (offset == 0) {
+        if (chunk_index == chunks_.size()) {
+            chunks_.push_back(std::make_unique<Chunk>());
+        }
+        chunks_[chunk_index]->base_split = last_split_;
+    }
+    
+    int64_t lap = split.count() - last_split_;
+    chunks_[chunk_index]->deltas[offset] = lap;
+    last_split_ = split.count();
+    
+    size_t index = count_++;
+    
+    // Running statistics
+    if (index == 0 || lap < stats_.min.count()) {
+        stats_.min = std::chrono::nanoseconds{lap};
+        stats_.best_index = index;
+    }
+    if (index == 0 || lap > stats_.max.count()) {
+        stats_.max = std::chrono::nanoseconds{lap};
+        stats_.worst_index = index;
+    }
+    
+    double delta = static_cast<double>(lap) - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (static_cast<double>(lap) - mean_);
+    
+    stats_.count = count_;
+    stats_.mean = std::chrono::nanoseconds{std::llround(mean_)};
+    stats_.stddev = std::chrono::nanoseconds{
+        count_ > 1 ? std::llround(std::sqrt(m2_ / static_cast<double>(count_ - 1))) : 0};
+}
+
+void LapStore::Clear() {
+    count_ = 0;
+    last_split_ = 0;
+    stats_ = Stats{};
+    mean_ = 0.0;
+    m2_ = 0.0;
+}
+
+std::chrono::nanoseconds LapStore::GetLap(size_t index) const {
+    if (index >= count_) return std::chrono::nanoseconds{0};
+    return std::chrono::nanoseconds{chunks_[index / CHUNK_SIZE]->deltas[index % CHUNK_SIZE]};
+}
+
+std::chrono::nanoseconds LapStore::GetSplit(size_t index) const {
+    if (index >= count_) return std::chrono::nanoseconds{0};
+    
+    const Chunk& chunk = *chunks_[index / CHUNK_SIZE];
+    int64_t split = chunk.base_split;
+    for (size_t i = 0; i <= index % CHUNK_SIZE; ++i) {
+        split += chunk.deltas[i];
+    }
+    return std::chrono::nanoseconds{split};
+}
+
+size_t LapStore::GetMemoryUsage() const {
+    return sizeof(*this)
+        + chunks_.capacity() * sizeof(std::unique_ptr<Chunk>)
+        + chunks_.size() * sizeof(Chunk);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Append-only lap history for the stopwatch. Lap durations are stored as
+// 64-bit nanosecond deltas in fixed-size chunks; each chunk also records the
+// split at which it starts, so any split is a chunk base plus a partial sum.
+// Statistics are updated on every Record() so readers never rescan history.
+class LapStore {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+    
+    struct Stats {
+        size_t count = 0;
+        std::chrono::nanoseconds min{0};
+        std::chrono::nanoseconds max{0};
+        std::chrono::nanoseconds mean{0};
+        std::chrono::nanoseconds stddev{0};
+        size_t best_index = 0;  // shortest lap
+        size_t worst_index = 0; // longest lap
+    };
+    
+    LapStore();
+    
+    // Records a lap ending at `split` (total elapsed time since the start)
+    void Record(std::chrono::nanoseconds split);
+    
+    // Drops all laps but keeps the allocated chunks for reuse
+    void Clear();
+    
+    size_t Size() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+    
+    std::chrono::nanoseconds GetLap(size_t index) const;
+    std::chrono::nanoseconds GetSplit(size_t index) const;
+    std::chrono::nanoseconds GetLastSplit() const { return std::chrono::nanoseconds{last_split_}; }
+    
+    const Stats& GetStats() const { return stats_; }
+    
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Chunk {
+        int64_t base_split;
+        int64_t deltas[CHUNK_SIZE];
+    };
+    
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    size_t count_;
+    int64_t last_split_;
+    
+    // Welford's running mean / sum of squared differences
+    Stats stats_;
+    double mean_;
+    double m2_;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for many producers and one consumer (Vyukov's
+// array queue). Each cell carries a sequence number that says whose turn it
+// is, so producers only contend on the tail counter and never block; a full
+// queue makes TryPush() fail instead of allocating.
+template <typename T>
+class BoundedMpscQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit BoundedMpscQueue(size_t capacity)
+        : mask_(RoundUp(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , tail_(0)
+        , head_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+    
+    size_t Capacity() const { return mask_ + 1; }
+    
+    // Any thread. Leaves `value` untouched when the queue is full.
+    bool TryPush(T&& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // the consumer has not freed this cell yet
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Consumer thread only
+    bool TryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != head + 1) return false;
+        
+        value = std::move(cell.value);
+        cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    // Snapshot for statistics; exact only while producers are idle
+    size_t SizeApprox() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    
+    static size_t RoundUp(size_t value) {
+        size_t result = 2;
+        while (result < value) result <<= 1;
+        return result;
+    }
+    
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    
+    // Producers and consumer on separate cache lines
+    alignas(64) std::atomic<size_t> tail_;
+    alignas(64) std::atomic<size_t> head_;
+};
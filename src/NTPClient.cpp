@@ -1,8 +1,45 @@
 #include "NTPClient.h"
+#include <cstring>
 #include <iostream>
 #include <thread>
 
-// Remove all Windows/Winsock includes since they're in WindowsHeaders.h
+// Winsock comes in through WindowsHeaders.h; elsewhere the BSD socket API
+// differs only in names and the timeout type
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    using SocketLength = int;
+    
+    void SetSocketTimeouts(SOCKET sock, int timeout_ms) {
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout_ms, sizeof(timeout_ms));
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeout_ms, sizeof(timeout_ms));
+    }
+#else
+    using SOCKET = int;
+    using SocketLength = socklen_t;
+    constexpr SOCKET INVALID_SOCKET = -1;
+    constexpr int SOCKET_ERROR = -1;
+    
+    int closesocket(SOCKET sock) {
+        return close(sock);
+    }
+    
+    void SetSocketTimeouts(SOCKET sock, int timeout_ms) {
+        timeval timeout{};
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_usec = (timeout_ms % 1000) * 1000;
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+#endif
+}
 
 NTPClient::NTPClient() 
     : winsock_initialized_(false)
@@ -26,15 +63,22 @@ void NTPClient::SetDefaultServers() {
 }
 
 bool NTPClient::InitializeWinsock() {
+#ifdef _WIN32
     WSADATA wsaData;
     int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
     winsock_initialized_ = (result == 0);
+#else
+    // Sockets need no setup outside Windows
+    winsock_initialized_ = true;
+#endif
     return winsock_initialized_;
 }
 
 void NTPClient::CleanupWinsock() {
     if (winsock_initialized_) {
+#ifdef _WIN32
         WSACleanup();
+#endif
         winsock_initialized_ = false;
     }
 }
@@ -68,8 +112,7 @@ NTPClient::NTPResult NTPClient::QueryServer(const std::string& server, int timeo
     }
     
     // Set timeout
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout_ms, sizeof(timeout_ms));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeout_ms, sizeof(timeout_ms));
+    SetSocketTimeouts(sock, timeout_ms);
     
     // Resolve server address
     sockaddr_in server_addr{};
@@ -102,7 +145,7 @@ NTPClient::NTPResult NTPClient::QueryServer(const std::string& server, int timeo
     
     // Receive response
     NTPPacket response{};
-    int addr_len = sizeof(server_addr);
+    SocketLength addr_len = sizeof(server_addr);
     if (recvfrom(sock, (char*)&response, sizeof(response), 0, 
                  (sockaddr*)&server_addr, &addr_len) == SOCKET_ERROR) {
         result.error_message = "Failed to receive NTP response";
@@ -1,6 +1,9 @@
 #pragma once
 
+#ifdef _WIN32
 #include "WindowsHeaders.h"  // Use common header
+#endif
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -0,0 +1,312 @@
+#include "SequenceTimer.h"
+#include <algorithm>
+
+SequenceTimer::SequenceTimer()
+    : state_(State::Stopped) {
+}
+
+SequenceTimer::~SequenceTimer() {
+    TimerService::Id pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending = pending_deadline_;
+        pending_deadline_ = 0;
+        ++generation_;
+    }
+    CancelDeadline(pending);
+    
+    // Posted callbacks point at this timer
+    if (executor_) {
+        executor_->Drain();
+    }
+}
+
+void SequenceTimer::SetPhases(std::vector<Phase> phases, uint64_t cycles) {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        phases_.clear();
+        phase_ends_.clear();
+        cycle_length_ = Clock::duration{0};
+        
+        for (Phase& phase : phases) {
+            if (phase.duration.count() <= 0) continue;
+            cycle_length_ += std::chrono::duration_cast<Clock::duration>(phase.duration);
+            phase_ends_.push_back(cycle_length_);
+            phases_.push_back(std::move(phase));
+        }
+        
+        cycles_ = cycles;
+        state_ = State::Stopped;
+        current_ = 0;
+        stale = RearmLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void SequenceTimer::Start() {
+    Start(Clock::now());
+}
+
+void SequenceTimer::Start(Clock::time_point anchor) {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (phases_.empty()) return;
+        
+        anchor_ = anchor;
+        state_ = State::Running;
+        
+        // An anchor in the past starts part-way through the sequence
+        uint64_t total = TotalPhasesLocked();
+        current_ = PhaseNumberAt(Clock::now() - anchor_);
+        if (total && current_ >= total) {
+            current_ = total;
+            state_ = State::Finished;
+        }
+        stale = RearmLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void SequenceTimer::Stop() {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = State::Stopped;
+        current_ = 0;
+        stale = RearmLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void SequenceTimer::Pause() {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Running) return;
+        
+        pause_time_ = Clock::now();
+        state_ = State::Paused;
+        stale = RearmLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void SequenceTimer::Resume() {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Paused) return;
+        
+        // Every later phase end moves by the pause, and only by the pause
+        anchor_ += Clock::now() - pause_time_;
+        state_ = State::Running;
+        stale = RearmLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void SequenceTimer::Skip() {
+    TimerService::Id stale = 0;
+    CallbackExecutor* executor;
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Running && state_ != State::Paused) return;
+        
+        auto now = state_ == State::Running ? Clock::now() : pause_time_;
+        anchor_ -= PhaseEndLocked(current_) - now;
+        changed = AdvanceLocked(now);
+        if (state_ != State::Paused) {
+            stale = RearmLocked();
+        }
+        executor = executor_;
+    }
+    CancelDeadline(stale);
+    
+    if (changed) {
+        NotifyPhaseChange(executor);
+    }
+}
+
+void SequenceTimer::Update() {
+    TimerService::Id stale = 0;
+    CallbackExecutor* executor;
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Running) return;
+        
+        changed = AdvanceLocked(Clock::now());
+        if (changed) {
+            stale = RearmLocked();
+        }
+        executor = executor_;
+    }
+    CancelDeadline(stale);
+    
+    if (changed) {
+        NotifyPhaseChange(executor);
+    }
+}
+
+void SequenceTimer::AttachService(TimerService* service) {
+    TimerService* previous;
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = service_;
+        stale = pending_deadline_;
+        pending_deadline_ = 0;
+        service_ = service;
+        RearmLocked();
+    }
+    // The old deadline belongs to the previous service
+    if (previous && stale) {
+        previous->Cancel(stale);
+    }
+}
+
+void SequenceTimer::SetExecutor(CallbackExecutor* executor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_ = executor;
+}
+
+void SequenceTimer::SetOnPhaseChange(InlineCallback&& callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_phase_change_ = std::move(callback);
+}
+
+SequenceTimer::State SequenceTimer::GetState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+SequenceTimer::Position SequenceTimer::GetPosition() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Position position;
+    if (state_ == State::Stopped || phases_.empty()) {
+        return position;
+    }
+    
+    // Derived from the clock rather than current_, so the display is right
+    // even between a phase end and its (possibly late) notification
+    uint64_t total = TotalPhasesLocked();
+    auto now = state_ == State::Paused ? pause_time_ : Clock::now();
+    uint64_t number = state_ == State::Finished ? total : PhaseNumberAt(now - anchor_);
+    if (total && number >= total) {
+        number = total - 1;
+        now = PhaseEndLocked(number);
+    }
+    
+    Clock::time_point end = PhaseEndLocked(number);
+    position.phase = static_cast<size_t>(number % phases_.size());
+    position.cycle = number / phases_.size();
+    position.remaining = end - now;
+    position.elapsed = std::chrono::duration_cast<Clock::duration>(phases_[position.phase].duration) - position.remaining;
+    return position;
+}
+
+SequenceTimer::Clock::time_point SequenceTimer::GetPhaseEnd() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::Running) return Clock::time_point{};
+    return PhaseEndLocked(current_);
+}
+
+SequenceTimer::Stats SequenceTimer::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+uint64_t SequenceTimer::PhaseNumberAt(Clock::duration since_anchor) const {
+    if (since_anchor.count() < 0) return 0;
+    
+    uint64_t cycle = static_cast<uint64_t>(since_anchor / cycle_length_);
+    auto within = since_anchor - cycle_length_ * static_cast<int64_t>(cycle);
+    auto phase = std::upper_bound(phase_ends_.begin(), phase_ends_.end(), within) - phase_ends_.begin();
+    return cycle * phase_ends_.size() + static_cast<uint64_t>(phase);
+}
+
+SequenceTimer::Clock::time_point SequenceTimer::PhaseEndLocked(uint64_t number) const {
+    uint64_t count = phase_ends_.size();
+    return anchor_ + cycle_length_ * static_cast<int64_t>(number / count) + phase_ends_[number % count];
+}
+
+uint64_t SequenceTimer::TotalPhasesLocked() const {
+    return cycles_ * phase_ends_.size();
+}
+
+bool SequenceTimer::AdvanceLocked(Clock::time_point now) {
+    if (now < PhaseEndLocked(current_)) return false;
+    
+    // However late we are, the next phase end still comes from the anchor
+    uint64_t total = TotalPhasesLocked();
+    uint64_t number = PhaseNumberAt(now - anchor_);
+    if (total && number >= total) {
+        number = total;
+        state_ = State::Finished;
+    }
+    
+    auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - PhaseEndLocked(number - 1));
+    stats_.transitions++;
+    stats_.coalesced += number - current_ - 1;
+    stats_.last_lateness = lateness;
+    stats_.max_lateness = std::max(stats_.max_lateness, lateness);
+    
+    current_ = number;
+    return true;
+}
+
+TimerService::Id SequenceTimer::RearmLocked() {
+    // Any callback already in flight for the old deadline sees a stale generation
+    ++generation_;
+    auto stale = pending_deadline_;
+    pending_deadline_ = 0;
+    
+    if (service_ && state_ == State::Running) {
+        auto generation = generation_;
+        pending_deadline_ = service_->Schedule(PhaseEndLocked(current_), [this, generation]() {
+            OnDeadline(generation);
+        });
+    }
+    return stale;
+}
+
+void SequenceTimer::CancelDeadline(TimerService::Id id) {
+    // Must not be called with mutex_ held: Cancel waits for a running callback,
+    // and that callback takes mutex_
+    if (service_ && id) {
+        service_->Cancel(id);
+    }
+}
+
+void SequenceTimer::OnDeadline(uint64_t generation) {
+    CallbackExecutor* executor;
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_ || state_ != State::Running) return;
+        
+        pending_deadline_ = 0;
+        changed = AdvanceLocked(Clock::now());
+        RearmLocked();
+        executor = executor_;
+    }
+    
+    if (changed) {
+        NotifyPhaseChange(executor);
+    }
+}
+
+void SequenceTimer::NotifyPhaseChange(CallbackExecutor* executor) {
+    if (executor && executor->Post([this]() { InvokePhaseChange(); })) return;
+    InvokePhaseChange();
+}
+
+void SequenceTimer::InvokePhaseChange() {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (on_phase_change_) {
+        on_phase_change_();
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CallbackExecutor.h"
+#include "InlineCallback.h"
+#include "TimerService.h"
+
+// A repeating chain of phases (work / short break / ..., i.e. Pomodoro or
+// interval training) scheduled against one anchor. Phase ends are the anchor
+// plus a prefix sum of the durations, so a late wakeup or a slow callback
+// never shifts the phases after it: lateness is absorbed, not accumulated.
+// Pausing moves the anchor by the time spent paused.
+class SequenceTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class State {
+        Stopped,
+        Running,
+        Paused,
+        Finished
+    };
+    
+    struct Phase {
+        std::string name;
+        std::chrono::nanoseconds duration{0};
+    };
+    
+    struct Position {
+        size_t phase = 0;                 // index into the phase list
+        uint64_t cycle = 0;               // completed passes through the list
+        Clock::duration elapsed{0};       // into the current phase
+        Clock::duration remaining{0};     // until the current phase ends
+    };
+    
+    struct Stats {
+        uint64_t transitions = 0;         // phase changes reported
+        uint64_t coalesced = 0;           // phase ends passed during one late wakeup
+        std::chrono::nanoseconds last_lateness{0};
+        std::chrono::nanoseconds max_lateness{0};
+    };
+    
+    SequenceTimer();
+    ~SequenceTimer();
+    
+    SequenceTimer(const SequenceTimer&) = delete;
+    SequenceTimer& operator=(const SequenceTimer&) = delete;
+    
+    // Stops the sequence and replaces its phases; zero-length phases are
+    // dropped. `cycles` = 0 repeats forever.
+    void SetPhases(std::vector<Phase> phases, uint64_t cycles = 0);
+    
+    void Start();
+    void Start(Clock::time_point anchor); // first phase begins at `anchor`
+    void Stop();
+    void Pause();
+    void Resume();
+    void Skip(); // ends the current phase now; later phases shift with it
+    
+    // Polling fallback, like Timer::Update()
+    void Update();
+    
+    void AttachService(TimerService* service);
+    void SetExecutor(CallbackExecutor* executor);
+    
+    // Runs once per wakeup that crosses one or more phase ends, and when the
+    // last cycle completes. Must not call SetOnPhaseChange() itself.
+    void SetOnPhaseChange(InlineCallback&& callback);
+    
+    State GetState() const;
+    Position GetPosition() const;
+    Clock::time_point GetPhaseEnd() const; // absolute end of the current phase
+    Stats GetStats() const;
+    
+    // Phases change only through SetPhases(), on the thread that owns the timer
+    const std::vector<Phase>& GetPhases() const { return phases_; }
+    uint64_t GetCycles() const { return cycles_; }
+
+private:
+    mutable std::mutex mutex_;
+    
+    State state_;
+    std::vector<Phase> phases_;
+    std::vector<Clock::duration> phase_ends_; // prefix sums within one cycle
+    Clock::duration cycle_length_{0};
+    uint64_t cycles_ = 0;
+    
+    Clock::time_point anchor_;
+    Clock::time_point pause_time_;
+    uint64_t current_ = 0; // phase number since the anchor, across cycles
+    Stats stats_;
+    
+    std::mutex callback_mutex_; // guards on_phase_change_, taken without mutex_ held
+    InlineCallback on_phase_change_;
+    CallbackExecutor* executor_ = nullptr;
+    
+    TimerService* service_ = nullptr;
+    TimerService::Id pending_deadline_ = 0;
+    uint64_t generation_ = 0;
+    
+    // Callers hold mutex_
+    uint64_t PhaseNumberAt(Clock::duration since_anchor) const;
+    Clock::time_point PhaseEndLocked(uint64_t number) const;
+    uint64_t TotalPhasesLocked() const; // 0 when endless
+    bool AdvanceLocked(Clock::time_point now); // true if a phase change is due
+    TimerService::Id RearmLocked();
+    
+    void CancelDeadline(TimerService::Id id);
+    void OnDeadline(uint64_t generation);
+    void NotifyPhaseChange(CallbackExecutor* executor);
+    void InvokePhaseChange();
+};
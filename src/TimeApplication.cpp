@@ -4,10 +4,68 @@
 
 const std::chrono::minutes TimeApplication::NTP_SYNC_INTERVAL{30};
 
-TimeApplication::TimeApplication() 
+const char* const TimeApplication::DEFAULT_WORLD_CLOCK_ZONES[] = {
+    "UTC",
+    "America/Los_Angeles",
+    "America/New_York",
+    "Europe/London",
+    "Europe/Sofia",
+    "Asia/Kolkata",
+    "Asia/Tokyo",
+    "Australia/Sydney"
+};
+
+TimeApplication::TimeApplication()
+    : TimeApplication(Options()) {
+}
+
+TimeApplication::TimeApplication(const Options& options)
     : is_ntp_sync_in_progress_(false)
     , stopwatch_(Timer::Type::Stopwatch)
-    , countdown_(Timer::Type::Countdown) {
+    , countdown_(Timer::Type::Countdown)
+    , hotkeys_(stopwatch_events_, &tsc_clock_) {
+    
+    // Stopwatch and lap reads go through the calibrated TSC when present
+    stopwatch_.SetClockSource(&tsc_clock_);
+    stopwatch_events_.SetClockSource(&tsc_clock_);
+    
+    // Global hotkeys are timestamped on their own thread as they arrive
+    if (options.global_hotkeys) {
+        hotkeys_.Start();
+    }
+    
+    // Countdown expiry fires from the timer service thread; the finished
+    // callback runs on the executor so it cannot delay other deadlines
+    countdown_.AttachService(&timer_service_);
+    countdown_.SetExecutor(&callback_executor_);
+    countdown_.SetOnFinished([]() {
+        std::cout << "Countdown finished" << std::endl;
+    });
+    
+    interval_timer_.AttachService(&timer_service_);
+    interval_timer_.SetExecutor(&callback_executor_);
+    interval_timer_.SetOnPhaseChange([this]() {
+        auto position = interval_timer_.GetPosition();
+        std::cout << "Interval timer: phase " << position.phase + 1
+                  << ", cycle " << position.cycle + 1 << std::endl;
+    });
+    SetPomodoro(std::chrono::minutes(25), std::chrono::minutes(5), std::chrono::minutes(15), 4);
+    
+    // Timers pick up where the previous run left off
+    if (options.persist_timers && timer_store_.Open(TimerStore::DefaultPath(), TIMER_SLOTS)) {
+        RestoreTimers();
+    }
+    
+    local_zone_ = TimeZone::LoadLocal();
+    std::cout << "Local time zone: " << local_zone_->GetName() << std::endl;
+    
+    alarm_scheduler_.SetExecutor(&callback_executor_);
+    
+    // Zones missing from the zoneinfo database are skipped
+    world_clock_.AddZone(local_zone_, "Local (" + local_zone_->GetName() + ")");
+    for (const char* zone : DEFAULT_WORLD_CLOCK_ZONES) {
+        world_clock_.AddZone(zone);
+    }
     
     // Initialize NTP client
     ntp_client_ = std::make_unique<NTPClient>();
@@ -17,13 +75,106 @@ TimeApplication::TimeApplication()
     last_ntp_sync_ = std::chrono::system_clock::now();
     
     // Perform initial NTP sync
-    SyncTimeWithNTP();
+    if (options.initial_ntp_sync) {
+        SyncTimeWithNTP();
+    }
     
     std::cout << "TimeApplication initialized successfully" << std::endl;
 }
 
 TimeApplication::~TimeApplication() {
-    // Cleanup handled by smart pointers automatically
+    PersistTimers();
+}
+
+void TimeApplication::Update() {
+    stopwatch_events_.Drain(stopwatch_);
+    PersistTimers();
+}
+
+AlarmScheduler::Id TimeApplication::AddLocalAlarm(int hour, int minute, const std::string& label) {
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto today = local_zone_->ToLocal(now).fields;
+    
+    int64_t target = TimeZone::DaysFromCivil(today.year, today.month, today.day) * 86400
+        + hour * 3600 + minute * 60;
+    if (local_zone_->LocalToUtc(target) <= now) {
+        target += 86400;
+    }
+    
+    std::string text = label.empty() ? "Alarm" : label;
+    return alarm_scheduler_.AddLocal(target, local_zone_, [text]() {
+        std::cout << "Alarm: " << text << std::endl;
+    }, text);
+}
+
+AlarmScheduler::Id TimeApplication::AddRecurringAlarm(const std::string& expression, const std::string& zone_name,
+                                                     const std::string& label) {
+    CronSchedule schedule(expression.c_str());
+    if (!schedule.IsValid()) {
+        std::cerr << "Invalid schedule: " << expression << std::endl;
+        return 0;
+    }
+    
+    // The scheduler keeps a queue per zone object, so each name is loaded once
+    std::shared_ptr<const TimeZone> zone = local_zone_;
+    if (!zone_name.empty()) {
+        std::shared_ptr<const TimeZone>& loaded = alarm_zones_[zone_name];
+        if (!loaded) loaded = TimeZone::Load(zone_name);
+        zone = loaded;
+    }
+    if (!zone) {
+        std::cerr << "Unknown time zone: " << zone_name << std::endl;
+        return 0;
+    }
+    
+    std::string text = label.empty() ? expression : label;
+    return alarm_scheduler_.AddRecurring(schedule, std::move(zone), [text]() {
+        std::cout << "Alarm: " << text << std::endl;
+    }, text);
+}
+
+void TimeApplication::SetPomodoro(std::chrono::minutes work, std::chrono::minutes short_break,
+                                  std::chrono::minutes long_break, int rounds) {
+    std::vector<SequenceTimer::Phase> phases;
+    for (int round = 0; round < rounds; ++round) {
+        phases.push_back({ "Work", work });
+        phases.push_back({ round + 1 < rounds ? "Short break" : "Long break",
+                           round + 1 < rounds ? short_break : long_break });
+    }
+    interval_timer_.SetPhases(std::move(phases));
+}
+
+void TimeApplication::RestoreTimers() {
+    Timer::Snapshot snapshot;
+    
+    if (timer_store_.Read(STOPWATCH_SLOT, snapshot)) {
+        stopwatch_.Restore(snapshot);
+    }
+    if (timer_store_.Read(COUNTDOWN_SLOT, snapshot)) {
+        countdown_.Restore(snapshot);
+    }
+    persisted_revisions_[STOPWATCH_SLOT] = stopwatch_.GetRevision();
+    persisted_revisions_[COUNTDOWN_SLOT] = countdown_.GetRevision();
+}
+
+void TimeApplication::PersistTimers() {
+    if (!timer_store_.IsOpen()) return;
+    
+    bool changed = false;
+    Timer* timers[] = { &stopwatch_, &countdown_ };
+    for (uint32_t slot : { STOPWATCH_SLOT, COUNTDOWN_SLOT }) {
+        uint64_t revision = timers[slot]->GetRevision();
+        if (revision != persisted_revisions_[slot]) {
+            timer_store_.Write(slot, timers[slot]->GetSnapshot());
+            persisted_revisions_[slot] = revision;
+            changed = true;
+        }
+    }
+    
+    if (changed) {
+        timer_store_.Flush();
+    }
 }
 
 std::chrono::system_clock::time_point TimeApplication::GetCurrentTime() const {
@@ -1,14 +1,34 @@
 #pragma once
 
-#include "WindowsHeaders.h"
 #include "NTPClient.h"
+#include "AlarmScheduler.h"
+#include "CallbackExecutor.h"
+#include "EventCapture.h"
+#include "HotkeyThread.h"
+#include "SequenceTimer.h"
 #include "Timer.h"
+#include "TimerPool.h"
+#include "TimerService.h"
+#include "TimerStore.h"
+#include "TscClock.h"
+#include "TimeZone.h"
+#include "WorldClock.h"
 #include <memory>
 #include <chrono>
+#include <string>
+#include <unordered_map>
 
 class TimeApplication {
 public:
+    // What touches the outside world; a headless benchmark turns it all off
+    struct Options {
+        bool persist_timers = true;   // restore and save timers across runs
+        bool initial_ntp_sync = true;
+        bool global_hotkeys = true;
+    };
+    
     TimeApplication();
+    explicit TimeApplication(const Options& options);
     ~TimeApplication();
     
     // Time management
@@ -16,15 +36,77 @@ public:
     void SyncTimeWithNTP();
     bool IsNTPSyncInProgress() const;
     
+    // Once per frame: applies captured stopwatch events and persists timers
+    // whose state changed
+    void Update();
+    
+    // Loaded once at startup; conversions are lock- and allocation-free
+    const TimeZone& GetLocalZone() const { return *local_zone_; }
+    
+    // UI thread only
+    WorldClock& GetWorldClock() { return world_clock_; }
+    
+    // Alarms follow the local wall clock through DST changes and clock steps
+    AlarmScheduler& GetAlarmScheduler() { return alarm_scheduler_; }
+    
+    // Schedules an alarm for the next time the local clock shows hour:minute
+    AlarmScheduler::Id AddLocalAlarm(int hour, int minute, const std::string& label);
+    
+    // Cron expression in `zone_name` (empty = local zone). Returns 0 if the
+    // expression or zone is invalid, or the schedule never fires.
+    AlarmScheduler::Id AddRecurringAlarm(const std::string& expression, const std::string& zone_name,
+                                         const std::string& label);
+    
     // Timer access
     Timer& GetStopwatch() { return stopwatch_; }
     Timer& GetCountdown() { return countdown_; }
+    SequenceTimer& GetIntervalTimer() { return interval_timer_; }
+    
+    // Any number of named timers; UI thread only, evaluated by whoever
+    // shows them
+    TimerPool& GetTimerPool() { return timer_pool_; }
+    
+    // Any thread may capture; events reach the stopwatch on the next Update()
+    EventCapture& GetStopwatchEvents() { return stopwatch_events_; }
+    HotkeyThread& GetHotkeys() { return hotkeys_; }
+    const HotkeyThread& GetHotkeys() const { return hotkeys_; }
+    
+    // `rounds` work phases separated by short breaks, then a long break
+    void SetPomodoro(std::chrono::minutes work, std::chrono::minutes short_break,
+                     std::chrono::minutes long_break, int rounds);
+    const TimerService& GetTimerService() const { return timer_service_; }
+    const TscClock& GetTscClock() const { return tsc_clock_; }
+    const CallbackExecutor& GetCallbackExecutor() const { return callback_executor_; }
     
 private:
     std::unique_ptr<NTPClient> ntp_client_;
+    std::shared_ptr<const TimeZone> local_zone_;
+    std::unordered_map<std::string, std::shared_ptr<const TimeZone>> alarm_zones_; // by name, for recurring alarms
+    WorldClock world_clock_;
+    
+    // Declared before the timers so they outlive them. The executor also
+    // outlives the schedulers, whose threads post to it.
+    CallbackExecutor callback_executor_;
+    AlarmScheduler alarm_scheduler_;
+    TimerService timer_service_;
+    TscClock tsc_clock_;
     
     Timer stopwatch_;
     Timer countdown_;
+    SequenceTimer interval_timer_;
+    TimerPool timer_pool_;
+    EventCapture stopwatch_events_;
+    HotkeyThread hotkeys_; // feeds stopwatch_events_
+    
+    static const uint32_t STOPWATCH_SLOT = 0;
+    static const uint32_t COUNTDOWN_SLOT = 1;
+    static const uint32_t TIMER_SLOTS = 2;
+    
+    TimerStore timer_store_;
+    uint64_t persisted_revisions_[TIMER_SLOTS] = {};
+    
+    void RestoreTimers();
+    void PersistTimers();
     
     std::chrono::system_clock::time_point current_time_;
     std::chrono::system_clock::time_point last_ntp_sync_;
@@ -32,4 +114,5 @@ private:
     bool is_ntp_sync_in_progress_;
     
     static const std::chrono::minutes NTP_SYNC_INTERVAL;
+    static const char* const DEFAULT_WORLD_CLOCK_ZONES[8];
 };
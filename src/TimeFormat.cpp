@@ -0,0 +1,303 @@
+#include "TimeFormat.h"
+#include <cstring>
+
+namespace {
+    const char TWO_DIGITS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    
+    const uint32_t POWERS_OF_TEN[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    
+    const char WEEKDAY_NAMES[7][4] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    const char MONTH_NAMES[12][4] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+    };
+    
+    // Bounded writer; output past the end of the buffer is dropped
+    struct Output {
+        char* cursor;
+        char* end; // last usable byte, reserved for the terminator
+        
+        void Put(char c) {
+            if (cursor < end) *cursor++ = c;
+        }
+        
+        void Put(const char* text, size_t length) {
+            size_t room = static_cast<size_t>(end - cursor);
+            if (length > room) length = room;
+            std::memcpy(cursor, text, length);
+            cursor += length;
+        }
+        
+        void PutTwoDigits(unsigned value) {
+            Put(&TWO_DIGITS[value * 2], 2);
+        }
+        
+        void PutNumber(uint64_t value, unsigned width) {
+            if (width == 2 && value < 100) {
+                PutTwoDigits(static_cast<unsigned>(value));
+                return;
+            }
+            
+            char digits[20];
+            char* p = digits + sizeof(digits);
+            while (value >= 100) {
+                p -= 2;
+                std::memcpy(p, &TWO_DIGITS[(value % 100) * 2], 2);
+                value /= 100;
+            }
+            if (value >= 10) {
+                p -= 2;
+                std::memcpy(p, &TWO_DIGITS[value * 2], 2);
+            } else {
+                *--p = static_cast<char>('0' + value);
+            }
+            
+            size_t length = static_cast<size_t>(digits + sizeof(digits) - p);
+            while (length < width && p > digits) {
+                *--p = '0';
+                ++length;
+            }
+            Put(p, length);
+        }
+    };
+    
+    int CountRun(const char* p, char c) {
+        int run = 0;
+        while (p[run] == c) ++run;
+        return run;
+    }
+}
+
+TimeFields TimeFields::FromDuration(std::chrono::nanoseconds duration) {
+    TimeFields fields;
+    int64_t ns = duration.count() > 0 ? duration.count() : 0;
+    int64_t total_seconds = ns / 1000000000LL;
+    
+    fields.hours = total_seconds / 3600;
+    fields.minutes = static_cast<int>((total_seconds / 60) % 60);
+    fields.seconds = static_cast<int>(total_seconds % 60);
+    fields.nanoseconds = static_cast<int>(ns % 1000000000LL);
+    return fields;
+}
+
+TimeFormat::TimeFormat()
+    : op_count_(0)
+    , literal_count_(0)
+    , valid_(false) {
+}
+
+TimeFormat::TimeFormat(const char* pattern)
+    : TimeFormat() {
+    Compile(pattern);
+}
+
+bool TimeFormat::AddOp(OpCode code, uint8_t arg) {
+    if (op_count_ == MAX_OPS) return false;
+    
+    ops_[op_count_++] = Op{ code, arg, 0, 0 };
+    return true;
+}
+
+bool TimeFormat::AddLiteral(char c) {
+    if (literal_count_ == MAX_LITERALS) return false;
+    
+    // Runs of literal characters share one op
+    if (op_count_ > 0 && ops_[op_count_ - 1].code == OpCode::Literal) {
+        literals_[literal_count_++] = c;
+        ops_[op_count_ - 1].length++;
+        return true;
+    }
+    
+    if (op_count_ == MAX_OPS) return false;
+    ops_[op_count_++] = Op{ OpCode::Literal, 0, static_cast<uint8_t>(literal_count_), 1 };
+    literals_[literal_count_++] = c;
+    return true;
+}
+
+bool TimeFormat::Compile(const char* pattern) {
+    op_count_ = 0;
+    literal_count_ = 0;
+    valid_ = false;
+    
+    if (!pattern) return false;
+    
+    int open_section = -1;
+    bool ok = true;
+    const char* p = pattern;
+    
+    while (*p && ok) {
+        char c = *p;
+        
+        if (c == '%') {
+            char spec = p[1];
+            p += spec ? 2 : 1;
+            switch (spec) {
+                case 'H': ok = AddOp(OpCode::Hours, 2); break;
+                case 'I': ok = AddOp(OpCode::Hours12, 2); break;
+                case 'M': ok = AddOp(OpCode::Minutes, 2); break;
+                case 'S': ok = AddOp(OpCode::Seconds, 2); break;
+                case 'p': ok = AddOp(OpCode::AmPm); break;
+                case 'Y': ok = AddOp(OpCode::Year, 4); break;
+                case 'y': ok = AddOp(OpCode::Year2, 2); break;
+                case 'm': ok = AddOp(OpCode::Month, 2); break;
+                case 'd': ok = AddOp(OpCode::Day, 2); break;
+                case 'a': ok = AddOp(OpCode::WeekdayName); break;
+                case 'b': ok = AddOp(OpCode::MonthName); break;
+                case '%': ok = AddLiteral('%'); break;
+                default:
+                    ok = AddLiteral('%') && (!spec || AddLiteral(spec));
+                    break;
+            }
+            continue;
+        }
+        
+        int run;
+        switch (c) {
+            case 'H':
+                run = CountRun(p, 'H');
+                ok = AddOp(OpCode::Hours, static_cast<uint8_t>(run > 20 ? 20 : run));
+                p += run;
+                break;
+            case 'M':
+                run = CountRun(p, 'M');
+                ok = AddOp(OpCode::Minutes, static_cast<uint8_t>(run > 2 ? 2 : run));
+                p += run;
+                break;
+            case 'S':
+                run = CountRun(p, 'S');
+                ok = AddOp(OpCode::Seconds, static_cast<uint8_t>(run > 2 ? 2 : run));
+                p += run;
+                break;
+            case 'f':
+                run = CountRun(p, 'f');
+                ok = run <= 9 && AddOp(OpCode::Fraction, static_cast<uint8_t>(run));
+                p += run;
+                break;
+            case '[':
+                ok = open_section < 0;
+                open_section = static_cast<int>(op_count_);
+                ok = ok && AddOp(OpCode::OptionalBegin);
+                ++p;
+                break;
+            case ']':
+                ok = open_section >= 0;
+                if (ok) {
+                    ops_[open_section].arg = static_cast<uint8_t>(op_count_);
+                    ok = AddOp(OpCode::OptionalEnd);
+                    open_section = -1;
+                }
+                ++p;
+                break;
+            default:
+                ok = AddLiteral(c);
+                ++p;
+                break;
+        }
+    }
+    
+    if (!ok || open_section >= 0) {
+        op_count_ = 0;
+        literal_count_ = 0;
+        return false;
+    }
+    
+    valid_ = true;
+    return true;
+}
+
+bool TimeFormat::SectionIsZero(size_t begin, size_t end, const TimeFields& fields) const {
+    for (size_t i = begin; i < end; ++i) {
+        switch (ops_[i].code) {
+            case OpCode::Hours:
+            case OpCode::Hours12:
+                if (fields.hours != 0) return false;
+                break;
+            case OpCode::Minutes:
+                if (fields.minutes != 0) return false;
+                break;
+            case OpCode::Seconds:
+                if (fields.seconds != 0) return false;
+                break;
+            case OpCode::Fraction:
+                if (fields.nanoseconds != 0) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+size_t TimeFormat::Format(const TimeFields& fields, char* buffer, size_t size) const {
+    if (!buffer || size == 0) return 0;
+    
+    Output out{ buffer, buffer + size - 1 };
+    
+    for (size_t i = 0; i < op_count_; ++i) {
+        const Op& op = ops_[i];
+        switch (op.code) {
+            case OpCode::Literal:
+                out.Put(&literals_[op.offset], op.length);
+                break;
+            case OpCode::Hours:
+                out.PutNumber(static_cast<uint64_t>(fields.hours > 0 ? fields.hours : 0), op.arg);
+                break;
+            case OpCode::Hours12: {
+                unsigned hour = static_cast<unsigned>(fields.hours % 12);
+                out.PutTwoDigits(hour == 0 ? 12 : hour);
+                break;
+            }
+            case OpCode::Minutes:
+                out.PutNumber(static_cast<uint64_t>(fields.minutes), op.arg);
+                break;
+            case OpCode::Seconds:
+                out.PutNumber(static_cast<uint64_t>(fields.seconds), op.arg);
+                break;
+            case OpCode::Fraction:
+                out.PutNumber(static_cast<uint64_t>(fields.nanoseconds) / POWERS_OF_TEN[9 - op.arg], op.arg);
+                break;
+            case OpCode::Year:
+                out.PutNumber(static_cast<uint64_t>(fields.year > 0 ? fields.year : 0), 4);
+                break;
+            case OpCode::Year2:
+                out.PutTwoDigits(static_cast<unsigned>(((fields.year % 100) + 100) % 100));
+                break;
+            case OpCode::Month:
+                out.PutTwoDigits(static_cast<unsigned>(fields.month % 100));
+                break;
+            case OpCode::Day:
+                out.PutTwoDigits(static_cast<unsigned>(fields.day % 100));
+                break;
+            case OpCode::WeekdayName:
+                out.Put(WEEKDAY_NAMES[((fields.weekday % 7) + 7) % 7], 3);
+                break;
+            case OpCode::MonthName:
+                out.Put(MONTH_NAMES[(((fields.month - 1) % 12) + 12) % 12], 3);
+                break;
+            case OpCode::AmPm:
+                out.Put(fields.hours % 24 < 12 ? "AM" : "PM", 2);
+                break;
+            case OpCode::OptionalBegin:
+                if (SectionIsZero(i + 1, op.arg, fields)) {
+                    i = op.arg;
+                }
+                break;
+            case OpCode::OptionalEnd:
+                break;
+        }
+    }
+    
+    *out.cursor = '\0';
+    return static_cast<size_t>(out.cursor - buffer);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Broken-down time handed to TimeFormat. For durations only the time-of-day
+// part is used and hours may exceed 23.
+struct TimeFields {
+    int64_t hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    int nanoseconds = 0;
+    
+    int year = 1970;
+    int month = 1;   // 1-12
+    int day = 1;     // 1-31
+    int weekday = 4; // 0 = Sunday
+    
+    static TimeFields FromDuration(std::chrono::nanoseconds duration);
+};
+
+// A time pattern compiled once into a flat op list. Format() writes into a
+// caller buffer using a two-digit lookup table and never allocates.
+//
+// Pattern syntax, both styles may be mixed:
+//   HH MM SS     zero-padded hours (at least 2 digits), minutes, seconds
+//   H            hours without padding
+//   f..f         1-9 fractional digits (fff = milliseconds)
+//   %H %M %S     strftime-style hours, minutes, seconds
+//   %I %p        12-hour clock and AM/PM
+//   %Y %y %m %d  year, 2-digit year, month, day
+//   %a %b        abbreviated weekday and month name
+//   %%           literal percent
+//   [ ... ]      optional section, dropped when all its fields are zero
+// Everything else is copied literally.
+class TimeFormat {
+public:
+    static constexpr size_t MAX_OPS = 32;
+    static constexpr size_t MAX_LITERALS = 64;
+    
+    TimeFormat();
+    explicit TimeFormat(const char* pattern);
+    
+    // Returns false (and leaves the format empty) if the pattern does not fit
+    bool Compile(const char* pattern);
+    bool IsValid() const { return valid_; }
+    
+    // Returns the number of characters written, excluding the terminator.
+    // Output is truncated to fit and always null-terminated when size > 0.
+    size_t Format(const TimeFields& fields, char* buffer, size_t size) const;
+
+private:
+    enum class OpCode : uint8_t {
+        Literal,
+        Hours,
+        Hours12,
+        Minutes,
+        Seconds,
+        Fraction,
+        Year,
+        Year2,
+        Month,
+        Day,
+        WeekdayName,
+        MonthName,
+        AmPm,
+        OptionalBegin, // arg = index of the matching OptionalEnd
+        OptionalEnd
+    };
+    
+    struct Op {
+        OpCode code;
+        uint8_t arg;    // width, digit count or jump target
+        uint8_t offset; // literal pool offset
+        uint8_t length; // literal length
+    };
+    
+    bool AddOp(OpCode code, uint8_t arg = 0);
+    bool AddLiteral(char c);
+    bool SectionIsZero(size_t begin, size_t end, const TimeFields& fields) const;
+    
+    Op ops_[MAX_OPS];
+    char literals_[MAX_LITERALS];
+    size_t op_count_;
+    size_t literal_count_;
+    bool valid_;
+};
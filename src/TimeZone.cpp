@@ -0,0 +1,617 @@
+#include "TimeZone.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#ifdef _WIN32
+#include "WindowsHeaders.h"
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int64_t SECONDS_PER_DAY = 86400;
+    constexpr int64_t MIN_TIME = std::numeric_limits<int64_t>::min();
+    constexpr int64_t MAX_TIME = std::numeric_limits<int64_t>::max();
+    
+    // Years whose rule transitions are expanded at load
+    constexpr int RULE_FIRST_YEAR = 1970;
+    constexpr int RULE_LAST_YEAR = 2100;
+    
+    int64_t FloorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+    
+    bool IsLeapYear(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+    
+    int DaysInMonth(int year, int month) {
+        static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && IsLeapYear(year) ? 29 : DAYS[month - 1];
+    }
+    
+    uint32_t ReadU32(const char* p) {
+        auto b = reinterpret_cast<const unsigned char*>(p);
+        return (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | uint32_t(b[3]);
+    }
+    
+    int64_t ReadI64(const char* p) {
+        return static_cast<int64_t>((uint64_t(ReadU32(p)) << 32) | ReadU32(p + 4));
+    }
+    
+    // POSIX TZ pieces; each returns nullptr on malformed input
+    const char* ParseName(const char* p, std::string& name) {
+        if (*p == '<') {
+            const char* end = std::strchr(p, '>');
+            if (!end) return nullptr;
+            name.assign(p + 1, end);
+            return end + 1;
+        }
+        const char* start = p;
+        while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) ++p;
+        if (p - start < 3) return nullptr;
+        name.assign(start, p);
+        return p;
+    }
+    
+    const char* ParseNumber(const char* p, int max, int& value) {
+        if (*p < '0' || *p > '9') return nullptr;
+        value = 0;
+        while (*p >= '0' && *p <= '9') {
+            value = value * 10 + (*p++ - '0');
+            if (value > max) return nullptr;
+        }
+        return p;
+    }
+    
+    // [+-]hh[:mm[:ss]] in seconds
+    const char* ParseTime(const char* p, int32_t& seconds) {
+        int sign = 1;
+        if (*p == '+' || *p == '-') {
+            sign = *p == '-' ? -1 : 1;
+            ++p;
+        }
+        int hours = 0, minutes = 0, secs = 0;
+        p = ParseNumber(p, 167, hours);
+        if (p && *p == ':') {
+            p = ParseNumber(p + 1, 59, minutes);
+            if (p && *p == ':') {
+                p = ParseNumber(p + 1, 59, secs);
+            }
+        }
+        seconds = sign * (hours * 3600 + minutes * 60 + secs);
+        return p;
+    }
+    
+    std::vector<std::string> ZoneinfoDirectories() {
+        std::vector<std::string> dirs;
+        if (const char* tzdir = std::getenv("TZDIR")) {
+            if (*tzdir) dirs.push_back(tzdir);
+        }
+#ifdef _WIN32
+        // Windows has no system TZif database; a copy can ship next to the executable
+        char path[MAX_PATH];
+        DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+        if (length > 0 && length < MAX_PATH) {
+            std::string exe(path, length);
+            auto slash = exe.find_last_of("\\/");
+            if (slash != std::string::npos) {
+                dirs.push_back(exe.substr(0, slash + 1) + "zoneinfo");
+            }
+        }
+#else
+        dirs.push_back("/usr/share/zoneinfo");
+        dirs.push_back("/usr/lib/zoneinfo");
+        dirs.push_back("/usr/share/lib/zoneinfo");
+#endif
+        return dirs;
+    }
+}
+
+int64_t TimeZone::DaysFromCivil(int year, int month, int day) {
+    // Howard Hinnant's days_from_civil
+    int64_t y = static_cast<int64_t>(year) - (month <= 2 ? 1 : 0);
+    int64_t era = FloorDiv(y, 400);
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void TimeZone::CivilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int64_t era = FloorDiv(days, 146097);
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+int TimeZone::WeekdayFromDays(int64_t days) {
+    // 1970-01-01 was a Thursday
+    return static_cast<int>(((days % 7) + 11) % 7);
+}
+
+int64_t TimeZone::RuleDate::LocalSecondsInYear(int year) const {
+    int64_t day_of_year = 0;
+    
+    switch (kind) {
+        case Kind::Julian:
+            // 1-365, February 29th is never counted
+            day_of_year = day - 1;
+            if (IsLeapYear(year) && day >= 60) ++day_of_year;
+            break;
+        case Kind::ZeroBasedJulian:
+            day_of_year = day;
+            break;
+        case Kind::MonthWeekDay: {
+            int64_t first = DaysFromCivil(year, month, 1);
+            int offset = (weekday - WeekdayFromDays(first) + 7) % 7 + (week - 1) * 7;
+            while (offset >= DaysInMonth(year, month)) offset -= 7; // week 5 = last
+            day_of_year = first + offset - DaysFromCivil(year, 1, 1);
+            break;
+        }
+    }
+    return day_of_year * SECONDS_PER_DAY + time;
+}
+
+uint8_t TimeZone::AddType(int32_t offset, bool is_dst, const std::string& abbreviation) {
+    size_t index = abbreviations_.size();
+    abbreviations_ += abbreviation;
+    abbreviations_.push_back('\0');
+    types_.push_back(LocalType{ offset, is_dst, static_cast<uint8_t>(index < 256 ? index : 0) });
+    return static_cast<uint8_t>(types_.size() - 1);
+}
+
+bool TimeZone::ParsePosix(const char* text) {
+    PosixRule rule;
+    std::string std_name, dst_name;
+    int32_t std_offset = 0;
+    
+    const char* p = ParseName(text, std_name);
+    if (!p) return false;
+    p = ParseTime(p, std_offset);
+    if (!p) return false;
+    
+    // POSIX offsets count westward
+    rule.std_type = AddType(-std_offset, false, std_name);
+    
+    if (*p == '\0') {
+        rule.valid = true;
+        rule_ = rule;
+        return true;
+    }
+    
+    p = ParseName(p, dst_name);
+    if (!p) return false;
+    
+    int32_t dst_offset = std_offset - 3600;
+    if (*p && *p != ',') {
+        p = ParseTime(p, dst_offset);
+        if (!p) return false;
+    }
+    rule.dst_type = AddType(-dst_offset, true, dst_name);
+    rule.has_dst = true;
+    
+    if (*p == '\0') {
+        // No rule given; POSIX leaves it implementation-defined, use the US one
+        p = ",M3.2.0,M11.1.0";
+    }
+    
+    RuleDate* dates[2] = { &rule.start, &rule.end };
+    for (RuleDate* date : dates) {
+        if (*p++ != ',') return false;
+        
+        if (*p == 'M') {
+            date->kind = RuleDate::Kind::MonthWeekDay;
+            p = ParseNumber(p + 1, 12, date->month);
+            if (!p || *p++ != '.') return false;
+            p = ParseNumber(p, 5, date->week);
+            if (!p || *p++ != '.') return false;
+            p = ParseNumber(p, 6, date->weekday);
+            if (!p || date->month < 1 || date->week < 1) return false;
+        } else if (*p == 'J') {
+            date->kind = RuleDate::Kind::Julian;
+            p = ParseNumber(p + 1, 365, date->day);
+            if (!p || date->day < 1) return false;
+        } else {
+            date->kind = RuleDate::Kind::ZeroBasedJulian;
+            p = ParseNumber(p, 365, date->day);
+            if (!p) return false;
+        }
+        
+        if (*p == '/') {
+            p = ParseTime(p + 1, date->time);
+            if (!p) return false;
+        }
+    }
+    
+    if (*p != '\0') return false;
+    
+    rule.valid = true;
+    rule_ = rule;
+    ExpandRule();
+    return true;
+}
+
+void TimeZone::ExpandRule() {
+    rule_times_.clear();
+    rule_types_.clear();
+    if (!rule_.valid || !rule_.has_dst) return;
+    
+    int32_t std_offset = types_[rule_.std_type].offset;
+    int32_t dst_offset = types_[rule_.dst_type].offset;
+    
+    struct Event { int64_t at; uint8_t type; };
+    std::vector<Event> events;
+    for (int year = RULE_FIRST_YEAR; year <= RULE_LAST_YEAR; ++year) {
+        int64_t year_start = DaysFromCivil(year, 1, 1) * SECONDS_PER_DAY;
+        events.push_back(Event{ year_start + rule_.start.LocalSecondsInYear(year) - std_offset, rule_.dst_type });
+        events.push_back(Event{ year_start + rule_.end.LocalSecondsInYear(year) - dst_offset, rule_.std_type });
+    }
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.at < b.at; });
+    
+    for (const Event& event : events) {
+        rule_times_.push_back(event.at);
+        rule_types_.push_back(event.type);
+    }
+}
+
+bool TimeZone::ParseTzif(const std::vector<char>& data) {
+    const size_t HEADER_SIZE = 44;
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), "TZif", 4) != 0) return false;
+    
+    char version = data[4];
+    size_t pos = 0;
+    size_t time_size = 4;
+    
+    auto read_counts = [&](size_t at, uint32_t counts[6]) {
+        for (int i = 0; i < 6; ++i) counts[i] = ReadU32(&data[at + 20 + i * 4]);
+    };
+    // isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt
+    uint32_t counts[6];
+    read_counts(0, counts);
+    
+    auto block_size = [](const uint32_t c[6], size_t tsize) {
+        return c[3] * tsize + c[3] + c[4] * 6 + c[5] + c[2] * (tsize + 4) + c[1] + c[0];
+    };
+    
+    if (version >= '2') {
+        // Skip the 32-bit block, the 64-bit one follows with its own header
+        pos = HEADER_SIZE + block_size(counts, 4);
+        if (data.size() < pos + HEADER_SIZE || std::memcmp(&data[pos], "TZif", 4) != 0) return false;
+        read_counts(pos, counts);
+        time_size = 8;
+    }
+    pos += HEADER_SIZE;
+    
+    uint32_t leap_count = counts[2], time_count = counts[3], type_count = counts[4], char_count = counts[5];
+    if (type_count == 0 || data.size() < pos + block_size(counts, time_size)) return false;
+    
+    transition_times_.resize(time_count);
+    transition_types_.resize(time_count);
+    for (uint32_t i = 0; i < time_count; ++i) {
+        const char* p = &data[pos + i * time_size];
+        transition_times_[i] = time_size == 8 ? ReadI64(p) : static_cast<int32_t>(ReadU32(p));
+    }
+    pos += time_count * time_size;
+    
+    for (uint32_t i = 0; i < time_count; ++i) {
+        transition_types_[i] = static_cast<uint8_t>(data[pos + i]);
+        if (transition_types_[i] >= type_count) return false;
+    }
+    pos += time_count;
+    
+    types_.resize(type_count);
+    for (uint32_t i = 0; i < type_count; ++i) {
+        const char* p = &data[pos + i * 6];
+        types_[i].offset = static_cast<int32_t>(ReadU32(p));
+        types_[i].is_dst = p[4] != 0;
+        types_[i].abbreviation_index = static_cast<uint8_t>(p[5]);
+        if (types_[i].abbreviation_index >= char_count) return false;
+    }
+    pos += type_count * 6;
+    
+    abbreviations_.assign(&data[pos], char_count);
+    abbreviations_.push_back('\0');
+    pos += char_count;
+    pos += leap_count * (time_size + 4) + counts[1] + counts[0];
+    
+    // Footer: "\n<POSIX TZ>\n" describing times after the last transition
+    if (version >= '2' && pos < data.size() && data[pos] == '\n') {
+        auto end = std::find(data.begin() + pos + 1, data.end(), '\n');
+        std::string footer(data.begin() + pos + 1, end);
+        if (!footer.empty()) {
+            ParsePosix(footer.c_str());
+        }
+    }
+    return true;
+}
+
+TimeZone::Window TimeZone::LookupRule(int64_t utc_seconds, int64_t lower_bound) const {
+    if (!rule_.has_dst) {
+        return Window{ lower_bound, MAX_TIME, rule_.std_type };
+    }
+    
+    if (!rule_times_.empty() && utc_seconds >= rule_times_.front() && utc_seconds < rule_times_.back()) {
+        auto next = std::upper_bound(rule_times_.begin(), rule_times_.end(), utc_seconds);
+        size_t index = static_cast<size_t>(next - rule_times_.begin()) - 1;
+        return Window{ std::max(rule_times_[index], lower_bound), *next, rule_types_[index] };
+    }
+    
+    int32_t std_offset = types_[rule_.std_type].offset;
+    int32_t dst_offset = types_[rule_.dst_type].offset;
+    
+    int64_t local_days = FloorDiv(utc_seconds + std_offset, SECONDS_PER_DAY);
+    int year, month, day;
+    CivilFromDays(local_days, year, month, day);
+    
+    // Transitions of the neighbouring years cover any window containing utc_seconds
+    struct Event { int64_t at; uint8_t type; };
+    Event events[6];
+    int count = 0;
+    for (int y = year - 1; y <= year + 1; ++y) {
+        int64_t year_start = DaysFromCivil(y, 1, 1) * SECONDS_PER_DAY;
+        events[count++] = Event{ year_start + rule_.start.LocalSecondsInYear(y) - std_offset, rule_.dst_type };
+        events[count++] = Event{ year_start + rule_.end.LocalSecondsInYear(y) - dst_offset, rule_.std_type };
+    }
+    std::sort(events, events + count, [](const Event& a, const Event& b) { return a.at < b.at; });
+    
+    Window window{ lower_bound, MAX_TIME, rule_.std_type };
+    for (int i = 0; i < count; ++i) {
+        if (events[i].at <= utc_seconds) {
+            window.from = std::max(events[i].at, lower_bound);
+            window.type = events[i].type;
+        } else {
+            window.until = events[i].at;
+            break;
+        }
+    }
+    return window;
+}
+
+TimeZone::Window TimeZone::Lookup(int64_t utc_seconds) const {
+    if (transition_times_.empty()) {
+        if (rule_.valid) return LookupRule(utc_seconds, MIN_TIME);
+        return Window{ MIN_TIME, MAX_TIME, 0 };
+    }
+    
+    auto next = std::upper_bound(transition_times_.begin(), transition_times_.end(), utc_seconds);
+    if (next == transition_times_.begin()) {
+        return Window{ MIN_TIME, transition_times_.front(), 0 };
+    }
+    
+    size_t index = static_cast<size_t>(next - transition_times_.begin()) - 1;
+    if (next == transition_times_.end()) {
+        if (rule_.valid) return LookupRule(utc_seconds, transition_times_.back());
+        return Window{ transition_times_.back(), MAX_TIME, transition_types_[index] };
+    }
+    return Window{ transition_times_[index], *next, transition_types_[index] };
+}
+
+TimeZone::Window TimeZone::Resolve(int64_t utc_seconds, Cache& cache) const {
+    uint32_t sequence = cache.sequence.load(std::memory_order_acquire);
+    if ((sequence & 1) == 0) {
+        Window cached{
+            cache.from.load(std::memory_order_relaxed),
+            cache.until.load(std::memory_order_relaxed),
+            static_cast<uint8_t>(cache.type.load(std::memory_order_relaxed))
+        };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (cache.sequence.load(std::memory_order_relaxed) == sequence
+            && utc_seconds >= cached.from && utc_seconds < cached.until) {
+            return cached;
+        }
+    }
+    
+    Window window = Lookup(utc_seconds);
+    
+    // Publish the new window unless another thread is doing the same. The
+    // fence keeps the stores below from becoming visible before the odd
+    // sequence does.
+    if ((sequence & 1) == 0
+        && cache.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+        std::atomic_thread_fence(std::memory_order_release);
+        cache.from.store(window.from, std::memory_order_relaxed);
+        cache.until.store(window.until, std::memory_order_relaxed);
+        cache.type.store(window.type, std::memory_order_relaxed);
+        cache.sequence.store(sequence + 2, std::memory_order_release);
+    }
+    return window;
+}
+
+int32_t TimeZone::GetOffset(int64_t utc_seconds, int64_t* valid_until) const {
+    Window window = Resolve(utc_seconds, cache_);
+    if (valid_until) *valid_until = window.until;
+    return types_[window.type].offset;
+}
+
+TimeZone::OffsetRange TimeZone::GetOffsetRange(int64_t utc_seconds) const {
+    Window window = Resolve(utc_seconds, cache_);
+    return OffsetRange{ window.from, window.until, types_[window.type].offset };
+}
+
+TimeZone::OffsetRange TimeZone::FindOffsetRange(int64_t utc_seconds) const {
+    Window window = Resolve(utc_seconds, probe_cache_);
+    return OffsetRange{ window.from, window.until, types_[window.type].offset };
+}
+
+int64_t TimeZone::LocalToUtc(int64_t local_seconds) const {
+    // Looked up past the cache: these probes jump around, and would evict
+    // the window the UI's ToLocal() calls keep hitting
+    auto offset_at = [this](int64_t utc_seconds) { return types_[Lookup(utc_seconds).type].offset; };
+    
+    // Offsets in force a day either side bracket any single transition
+    int32_t before = offset_at(local_seconds - SECONDS_PER_DAY);
+    int32_t after = offset_at(local_seconds + SECONDS_PER_DAY);
+    int64_t with_before = local_seconds - before;
+    if (before == after) return with_before;
+    
+    int64_t with_after = local_seconds - after;
+    bool before_valid = offset_at(with_before) == before;
+    bool after_valid = offset_at(with_after) == after;
+    
+    if (before_valid && after_valid) {
+        return std::min(with_before, with_after); // repeated hour: first pass
+    }
+    if (after_valid) return with_after;
+    
+    // Skipped hour (or only the old offset fits): with the old offset the
+    // result lands past the transition, i.e. the wall time moves forward
+    return with_before;
+}
+
+TimeZone::LocalTime TimeZone::ToLocal(std::chrono::system_clock::time_point time) const {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    int64_t seconds = FloorDiv(ns, 1000000000LL);
+    return ToLocal(seconds, static_cast<int>(ns - seconds * 1000000000LL));
+}
+
+TimeZone::LocalTime TimeZone::ToLocal(int64_t utc_seconds, int nanoseconds) const {
+    Window window = Resolve(utc_seconds, cache_);
+    const LocalType& type = types_[window.type];
+    
+    LocalTime local;
+    local.offset = type.offset;
+    local.is_dst = type.is_dst;
+    local.abbreviation = abbreviations_.c_str() + type.abbreviation_index;
+    local.valid_until = window.until;
+    
+    int64_t local_seconds = utc_seconds + type.offset;
+    int64_t days = FloorDiv(local_seconds, SECONDS_PER_DAY);
+    int64_t second_of_day = local_seconds - days * SECONDS_PER_DAY;
+    
+    CivilFromDays(days, local.fields.year, local.fields.month, local.fields.day);
+    local.fields.weekday = WeekdayFromDays(days);
+    local.fields.hours = second_of_day / 3600;
+    local.fields.minutes = static_cast<int>((second_of_day / 60) % 60);
+    local.fields.seconds = static_cast<int>(second_of_day % 60);
+    local.fields.nanoseconds = nanoseconds;
+    return local;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::Utc() {
+    static const std::shared_ptr<const TimeZone> utc = []() {
+        std::shared_ptr<TimeZone> zone(new TimeZone());
+        zone->name_ = "UTC";
+        zone->AddType(0, false, "UTC");
+        return zone;
+    }();
+    return utc;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::LoadFile(const std::string& path, const std::string& name) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return nullptr;
+    
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    std::shared_ptr<TimeZone> zone(new TimeZone());
+    zone->name_ = name;
+    if (!zone->ParseTzif(data)) return nullptr;
+    return zone;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::Load(const std::string& name) {
+    if (name.empty() || name == "UTC" || name == "Etc/UTC" || name == "Z") {
+        return Utc();
+    }
+    
+    bool is_path = name[0] == '/' || (name.size() > 2 && name[1] == ':');
+    if (is_path) {
+        return LoadFile(name, name);
+    }
+    
+    if (name.find("..") == std::string::npos) {
+        for (const auto& dir : ZoneinfoDirectories()) {
+            if (auto zone = LoadFile(dir + "/" + name, name)) {
+                return zone;
+            }
+        }
+    }
+    
+    std::shared_ptr<TimeZone> zone(new TimeZone());
+    zone->name_ = name;
+    if (zone->ParsePosix(name.c_str())) {
+        return zone;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::LoadLocal() {
+    if (const char* tz = std::getenv("TZ")) {
+        if (*tz == ':') ++tz;
+        if (*tz) {
+            if (auto zone = Load(tz)) return zone;
+        }
+    }
+
+#ifdef _WIN32
+    return LoadWindowsLocal();
+#else
+    // Name the zone after the symlink target when there is one
+    std::string name = "localtime";
+    char target[512];
+    ssize_t length = readlink("/etc/localtime", target, sizeof(target) - 1);
+    if (length > 0) {
+        std::string link(target, static_cast<size_t>(length));
+        auto at = link.find("zoneinfo/");
+        if (at != std::string::npos) name = link.substr(at + 9);
+    }
+    
+    if (auto zone = LoadFile("/etc/localtime", name)) return zone;
+    return Utc();
+#endif
+}
+
+#ifdef _WIN32
+std::shared_ptr<const TimeZone> TimeZone::LoadWindowsLocal() {
+    DYNAMIC_TIME_ZONE_INFORMATION info{};
+    if (GetDynamicTimeZoneInformation(&info) == TIME_ZONE_ID_INVALID) {
+        return Utc();
+    }
+    
+    auto narrow = [](const wchar_t* text) {
+        char buffer[128];
+        int length = WideCharToMultiByte(CP_UTF8, 0, text, -1, buffer, sizeof(buffer), nullptr, nullptr);
+        return length > 1 ? std::string(buffer, length - 1) : std::string();
+    };
+    
+    // Only the current rule is available; express it as a POSIX rule
+    std::shared_ptr<TimeZone> zone(new TimeZone());
+    zone->name_ = narrow(info.TimeZoneKeyName);
+    
+    PosixRule rule;
+    rule.valid = true;
+    rule.std_type = zone->AddType(-(info.Bias + info.StandardBias) * 60, false, narrow(info.StandardName));
+    
+    if (info.DaylightDate.wMonth != 0 && !info.DynamicDaylightTimeDisabled) {
+        rule.has_dst = true;
+        rule.dst_type = zone->AddType(-(info.Bias + info.DaylightBias) * 60, true, narrow(info.DaylightName));
+        
+        auto to_rule = [](const SYSTEMTIME& date) {
+            RuleDate rule_date;
+            rule_date.kind = RuleDate::Kind::MonthWeekDay;
+            rule_date.month = date.wMonth;
+            rule_date.week = date.wDay; // 5 = last, as in POSIX
+            rule_date.weekday = date.wDayOfWeek;
+            rule_date.time = date.wHour * 3600 + date.wMinute * 60 + date.wSecond;
+            return rule_date;
+        };
+        rule.start = to_rule(info.DaylightDate);
+        rule.end = to_rule(info.StandardDate);
+    }
+    
+    zone->rule_ = rule;
+    zone->ExpandRule();
+    return zone;
+}
+#endif
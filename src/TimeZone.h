@@ -0,0 +1,145 @@
+#pragma once
+
+#include "TimeFormat.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// UTC -> local conversion from TZif data, loaded once. Transitions are kept
+// sorted; times past the last one follow the POSIX rule from the file footer.
+// Each zone caches the offset together with the window it is valid for, so in
+// steady state a conversion is a range check and an add. Lookups are
+// thread-safe and never allocate.
+class TimeZone {
+public:
+    struct LocalTime {
+        TimeFields fields;
+        int32_t offset = 0;            // seconds east of UTC
+        bool is_dst = false;
+        const char* abbreviation = ""; // points into the zone, e.g. "EEST"
+        int64_t valid_until = 0;       // UTC seconds when the offset next changes
+    };
+    
+    // Accepts a zoneinfo name ("Europe/Sofia"), "UTC", an absolute TZif path,
+    // or a POSIX TZ string ("EET-2EEST,M3.5.0/3,M10.5.0/4").
+    // Returns nullptr if nothing matches.
+    static std::shared_ptr<const TimeZone> Load(const std::string& name);
+    
+    // The system zone: $TZ, /etc/localtime, or the Windows time zone settings
+    static std::shared_ptr<const TimeZone> LoadLocal();
+    
+    static std::shared_ptr<const TimeZone> Utc();
+    
+    const std::string& GetName() const { return name_; }
+    
+    // Offset in seconds east of UTC at `utc_seconds`; optionally reports
+    // the UTC second at which it stops applying
+    int32_t GetOffset(int64_t utc_seconds, int64_t* valid_until = nullptr) const;
+    
+    // The offset at `utc_seconds` and the UTC window [from, until) it holds
+    // for. FindOffsetRange() caches apart from the UI's conversions, for
+    // probes that jump around and would evict the window they keep hitting.
+    struct OffsetRange {
+        int64_t from;
+        int64_t until;
+        int32_t offset;
+    };
+    OffsetRange GetOffsetRange(int64_t utc_seconds) const;
+    OffsetRange FindOffsetRange(int64_t utc_seconds) const;
+    
+    // Local wall time (seconds since 1970-01-01 00:00 local) -> UTC seconds.
+    // A time repeated by a backward transition maps to its first occurrence;
+    // a time skipped by a forward one is pushed forward by the gap.
+    int64_t LocalToUtc(int64_t local_seconds) const;
+    
+    LocalTime ToLocal(std::chrono::system_clock::time_point time) const;
+    LocalTime ToLocal(int64_t utc_seconds, int nanoseconds = 0) const;
+    
+    // Civil date helpers shared with the schedulers (proleptic Gregorian)
+    static int64_t DaysFromCivil(int year, int month, int day);
+    static void CivilFromDays(int64_t days, int& year, int& month, int& day);
+    static int WeekdayFromDays(int64_t days); // 0 = Sunday
+    
+    TimeZone(const TimeZone&) = delete;
+    TimeZone& operator=(const TimeZone&) = delete;
+
+private:
+    struct LocalType {
+        int32_t offset;
+        bool is_dst;
+        uint8_t abbreviation_index;
+    };
+    
+    // POSIX TZ rule: "Mm.w.d", "Jn" or "n" plus a local time of day
+    struct RuleDate {
+        enum class Kind : uint8_t { MonthWeekDay, Julian, ZeroBasedJulian };
+        Kind kind = Kind::MonthWeekDay;
+        int month = 0;
+        int week = 0;
+        int weekday = 0;
+        int day = 0;
+        int32_t time = 2 * 3600;
+        
+        int64_t LocalSecondsInYear(int year) const; // seconds from Jan 1 00:00 local
+    };
+    
+    struct PosixRule {
+        bool valid = false;
+        bool has_dst = false;
+        uint8_t std_type = 0;
+        uint8_t dst_type = 0;
+        RuleDate start;
+        RuleDate end;
+    };
+    
+    // Offset window: [from, until) in UTC seconds
+    struct Window {
+        int64_t from;
+        int64_t until;
+        uint8_t type;
+    };
+    
+    // Seqlock-protected cache of the last window. Readers that race a writer
+    // just take the slow path; writers that lose the race skip the update.
+    struct Cache {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<int64_t> from{1};
+        std::atomic<int64_t> until{0};
+        std::atomic<uint32_t> type{0};
+    };
+    
+    TimeZone() = default;
+    
+    bool ParseTzif(const std::vector<char>& data);
+    bool ParsePosix(const char* text);
+    uint8_t AddType(int32_t offset, bool is_dst, const std::string& abbreviation);
+    void ExpandRule();
+    Window Lookup(int64_t utc_seconds) const;
+    Window LookupRule(int64_t utc_seconds, int64_t lower_bound) const;
+    Window Resolve(int64_t utc_seconds, Cache& cache) const;
+    
+    static std::shared_ptr<const TimeZone> LoadFile(const std::string& path, const std::string& name);
+#ifdef _WIN32
+    static std::shared_ptr<const TimeZone> LoadWindowsLocal();
+#endif
+
+    std::string name_;
+    std::vector<int64_t> transition_times_;
+    std::vector<uint8_t> transition_types_;
+    std::vector<LocalType> types_;
+    std::string abbreviations_; // null-separated
+    PosixRule rule_;
+    
+    // rule_'s transitions over the years most lookups fall in, expanded at
+    // load so that finding a window there is a binary search
+    std::vector<int64_t> rule_times_;
+    std::vector<uint8_t> rule_types_;
+    
+    // The UI's conversions hit cache_; probes that jump around (schedulers
+    // looking ahead) use probe_cache_ so they do not evict it
+    mutable Cache cache_;
+    mutable Cache probe_cache_;
+};
@@ -1,129 +1,442 @@
 #include "Timer.h"
-#include <sstream>
-#include <iomanip>
+#include "TimeFormat.h"
+#include <algorithm>
 
-Timer::Timer(Type type) 
+namespace {
+    // Saved steady and wall elapsed times agree to within this when the
+    // snapshot comes from the same boot
+    constexpr auto SAME_BOOT_TOLERANCE = std::chrono::seconds(2);
+}
+
+Timer::Timer(Type type)
     : type_(type)
     , state_(State::Stopped) {
 }
 
-void Timer::Start() {
-    if (state_ == State::Running) return;
-    
-    start_time_ = std::chrono::steady_clock::now();
-    state_ = State::Running;
+Timer::~Timer() {
+    TimerService::Id pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending = pending_deadline_;
+        pending_deadline_ = 0;
+        ++generation_;
+    }
+    CancelDeadline(pending);
     
-    if (type_ == Type::Stopwatch) {
-        accumulated_time_ = std::chrono::milliseconds{0};
+    // Posted callbacks point at this timer
+    if (executor_) {
+        executor_->Drain();
+    }
+}
+
+void Timer::Start() {
+    Start(Now());
+}
+
+void Timer::Start(std::chrono::steady_clock::time_point at) {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::Running) return;
+        
+        auto now = Now();
+        start_time_ = std::min(at, now);
+        start_wall_time_ = std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(now - start_time_);
+        state_ = State::Running;
+        
+        if (type_ == Type::Stopwatch) {
+            accumulated_time_ = std::chrono::steady_clock::duration{0};
+            laps_.Clear();
+        }
+        stale = RearmLocked();
+        PublishLocked();
     }
+    CancelDeadline(stale);
 }
 
 void Timer::Stop() {
-    state_ = State::Stopped;
-    accumulated_time_ = std::chrono::milliseconds{0};
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = State::Stopped;
+        accumulated_time_ = std::chrono::steady_clock::duration{0};
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
 }
 
 void Timer::Pause() {
-    if (state_ != State::Running) return;
-    
-    pause_time_ = std::chrono::steady_clock::now();
-    accumulated_time_ += std::chrono::duration_cast<std::chrono::milliseconds>(
-        pause_time_ - start_time_);
-    state_ = State::Paused;
+    Pause(Now());
+}
+
+void Timer::Pause(std::chrono::steady_clock::time_point at) {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Running) return;
+        
+        pause_time_ = std::max(at, start_time_);
+        accumulated_time_ += pause_time_ - start_time_;
+        state_ = State::Paused;
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
 }
 
 void Timer::Resume() {
-    if (state_ != State::Paused) return;
-    
-    start_time_ = std::chrono::steady_clock::now();
-    state_ = State::Running;
+    Resume(Now());
+}
+
+void Timer::Resume(std::chrono::steady_clock::time_point at) {
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Paused) return;
+        
+        auto now = Now();
+        start_time_ = std::min(std::max(at, pause_time_), now);
+        start_wall_time_ = std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(now - start_time_);
+        state_ = State::Running;
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
 }
 
 void Timer::Reset() {
-    state_ = State::Stopped;
-    accumulated_time_ = std::chrono::milliseconds{0};
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = State::Stopped;
+        accumulated_time_ = std::chrono::steady_clock::duration{0};
+        laps_.Clear();
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
+}
+
+void Timer::Lap() {
+    Lap(Now());
+}
+
+void Timer::Lap(std::chrono::steady_clock::time_point at) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (type_ != Type::Stopwatch || state_ != State::Running) return;
+    
+    // Splits never go backwards, even for an event older than the last lap
+    auto split = std::chrono::duration_cast<std::chrono::nanoseconds>(ElapsedAtLocked(std::max(at, start_time_)));
+    laps_.Record(std::max(split, laps_.GetLastSplit()));
 }
 
 void Timer::SetDuration(std::chrono::seconds duration) {
-    countdown_duration_ = duration;
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        countdown_duration_ = duration;
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
 }
 
-void Timer::Update() {
-    if (state_ == State::Running && type_ == Type::Countdown) {
-        CheckCountdownFinished();
+void Timer::AttachService(TimerService* service) {
+    TimerService* previous;
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = service_;
+        stale = pending_deadline_;
+        pending_deadline_ = 0;
+        service_ = service;
+        RearmLocked();
+        PublishLocked();
     }
+    // The old deadline belongs to the previous service
+    if (previous && stale) {
+        previous->Cancel(stale);
+    }
+}
+
+void Timer::SetClockSource(const TscClock* clock) {
+    clock_.store(clock, std::memory_order_release);
+}
+
+void Timer::Update() {
+    CheckCountdownFinished();
 }
 
 std::chrono::milliseconds Timer::GetElapsedTime() const {
-    if (state_ == State::Stopped) {
-        return std::chrono::milliseconds{0};
+    return std::chrono::duration_cast<std::chrono::milliseconds>(ElapsedAt(Read(), Now()));
+}
+
+std::chrono::nanoseconds Timer::GetElapsedNanoseconds() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ElapsedAt(Read(), Now()));
+}
+
+std::chrono::seconds Timer::GetRemainingTime() const {
+    if (type_ != Type::Countdown) {
+        return std::chrono::seconds{0};
+    }
+    return RemainingAt(Read(), Now());
+}
+
+Timer::State Timer::GetState() const {
+    return Read().state;
+}
+
+std::chrono::steady_clock::duration Timer::ElapsedAt(const Reading& reading, std::chrono::steady_clock::time_point at) {
+    if (reading.state == State::Stopped) {
+        return std::chrono::steady_clock::duration{0};
     }
     
-    auto current_elapsed = accumulated_time_;
+    auto current_elapsed = reading.accumulated;
     
-    if (state_ == State::Running) {
-        auto now = std::chrono::steady_clock::now();
-        current_elapsed += std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - start_time_);
+    if (reading.state == State::Running) {
+        // A reader whose clock sample predates the start it observed
+        current_elapsed += std::max(std::chrono::steady_clock::duration{0}, at - reading.start);
     }
     
     return current_elapsed;
 }
 
-std::chrono::seconds Timer::GetRemainingTime() const {
-    if (type_ != Type::Countdown || state_ == State::Stopped) {
+std::chrono::seconds Timer::RemainingAt(const Reading& reading, std::chrono::steady_clock::time_point at) {
+    if (reading.state == State::Stopped) {
         return std::chrono::seconds{0};
     }
     
-    auto elapsed = GetElapsedTime();
-    auto remaining = countdown_duration_ - std::chrono::duration_cast<std::chrono::seconds>(elapsed);
+    auto elapsed = ElapsedAt(reading, at);
+    auto remaining = reading.duration - std::chrono::duration_cast<std::chrono::seconds>(elapsed);
     
     return std::max(std::chrono::seconds{0}, remaining);
 }
 
-void Timer::CheckCountdownFinished() {
-    if (GetRemainingTime() == std::chrono::seconds{0}) {
-        Stop();
-        if (on_finished_callback_) {
-            on_finished_callback_();
+Timer::Reading Timer::Read() const {
+    for (;;) {
+        uint32_t sequence = sequence_.load(std::memory_order_acquire);
+        Reading reading;
+        reading.state = static_cast<State>(published_state_.load(std::memory_order_relaxed));
+        reading.start = std::chrono::steady_clock::time_point{
+            std::chrono::steady_clock::duration{published_start_.load(std::memory_order_relaxed)}};
+        reading.accumulated = std::chrono::steady_clock::duration{published_accumulated_.load(std::memory_order_relaxed)};
+        reading.duration = std::chrono::seconds{published_duration_.load(std::memory_order_relaxed)};
+        reading.revision = published_revision_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((sequence & 1) == 0 && sequence_.load(std::memory_order_relaxed) == sequence) {
+            return reading;
         }
     }
 }
 
-void Timer::SetOnFinished(std::function<void()> callback) {
-    on_finished_callback_ = callback;
+Timer::Reading Timer::ReadLocked() const {
+    Reading reading;
+    reading.state = state_;
+    reading.start = start_time_;
+    reading.accumulated = accumulated_time_;
+    reading.duration = countdown_duration_;
+    reading.revision = generation_;
+    return reading;
 }
 
-std::string Timer::FormatTime() const {
-    std::chrono::seconds total_seconds;
+void Timer::PublishLocked() {
+    // mutex_ makes this the only writer
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
     
-    if (type_ == Type::Stopwatch) {
-        total_seconds = std::chrono::duration_cast<std::chrono::seconds>(GetElapsedTime());
-    } else {
-        total_seconds = GetRemainingTime();
+    published_state_.store(static_cast<uint32_t>(state_), std::memory_order_relaxed);
+    published_start_.store(start_time_.time_since_epoch().count(), std::memory_order_relaxed);
+    published_accumulated_.store(accumulated_time_.count(), std::memory_order_relaxed);
+    published_duration_.store(countdown_duration_.count(), std::memory_order_relaxed);
+    published_revision_.store(generation_, std::memory_order_relaxed);
+    
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+std::chrono::steady_clock::duration Timer::ElapsedLocked() const {
+    return ElapsedAtLocked(Now());
+}
+
+std::chrono::steady_clock::duration Timer::ElapsedAtLocked(std::chrono::steady_clock::time_point at) const {
+    return ElapsedAt(ReadLocked(), at);
+}
+
+std::chrono::seconds Timer::RemainingLocked() const {
+    if (type_ != Type::Countdown) {
+        return std::chrono::seconds{0};
     }
+    return RemainingAt(ReadLocked(), Now());
+}
+
+TimerService::Id Timer::RearmLocked() {
+    // Any callback already in flight for the old deadline sees a stale generation
+    ++generation_;
+    auto stale = pending_deadline_;
+    pending_deadline_ = 0;
     
-    auto hours = std::chrono::duration_cast<std::chrono::hours>(total_seconds);
-    auto minutes = std::chrono::duration_cast<std::chrono::minutes>(total_seconds - hours);
-    auto seconds = total_seconds - hours - minutes;
+    if (service_ && type_ == Type::Countdown && state_ == State::Running) {
+        auto deadline = start_time_ + (countdown_duration_ - accumulated_time_);
+        auto generation = generation_;
+        pending_deadline_ = service_->Schedule(deadline, [this, generation]() {
+            OnDeadline(generation);
+        });
+    }
+    return stale;
+}
+
+void Timer::CancelDeadline(TimerService::Id id) {
+    // Must not be called with mutex_ held: Cancel waits for a running callback,
+    // and that callback takes mutex_
+    if (service_ && id) {
+        service_->Cancel(id);
+    }
+}
+
+void Timer::OnDeadline(uint64_t generation) {
+    CallbackExecutor* executor;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_ || state_ != State::Running) return;
+        
+        pending_deadline_ = 0;
+        if (RemainingLocked() > std::chrono::seconds{0}) {
+            RearmLocked();
+            PublishLocked();
+            return;
+        }
+        
+        state_ = State::Stopped;
+        accumulated_time_ = std::chrono::steady_clock::duration{0};
+        ++generation_;
+        executor = executor_;
+        PublishLocked();
+    }
     
-    std::ostringstream oss;
-    if (hours.count() > 0) {
-        oss << std::setfill('0') << std::setw(2) << hours.count() << ":";
+    NotifyFinished(executor);
+}
+
+void Timer::CheckCountdownFinished() {
+    TimerService::Id stale;
+    CallbackExecutor* executor;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Running || type_ != Type::Countdown) return;
+        if (RemainingLocked() != std::chrono::seconds{0}) return;
+        
+        state_ = State::Stopped;
+        accumulated_time_ = std::chrono::steady_clock::duration{0};
+        stale = RearmLocked();
+        executor = executor_;
+        PublishLocked();
     }
-    oss << std::setfill('0') << std::setw(2) << minutes.count() << ":"
-        << std::setfill('0') << std::setw(2) << seconds.count();
+    CancelDeadline(stale);
     
-    return oss.str();
+    NotifyFinished(executor);
 }
 
-std::string Timer::FormatTimeWithMilliseconds() const {
-    auto base_time = FormatTime();
-    auto elapsed = GetElapsedTime();
-    auto milliseconds = elapsed.count() % 1000;
+void Timer::NotifyFinished(CallbackExecutor* executor) {
+    if (executor && executor->Post([this]() { InvokeFinished(); })) return;
+    InvokeFinished();
+}
+
+void Timer::InvokeFinished() {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (on_finished_callback_) {
+        on_finished_callback_();
+    }
+}
+
+void Timer::SetOnFinished(InlineCallback&& callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_finished_callback_ = std::move(callback);
+}
+
+void Timer::SetExecutor(CallbackExecutor* executor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_ = executor;
+}
+
+Timer::Snapshot Timer::GetSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot snapshot;
+    snapshot.type = type_;
+    snapshot.state = state_;
+    snapshot.accumulated = std::chrono::duration_cast<std::chrono::nanoseconds>(accumulated_time_);
+    snapshot.duration = countdown_duration_;
+    snapshot.anchor_steady = start_time_;
+    snapshot.anchor_wall = start_wall_time_;
+    return snapshot;
+}
+
+void Timer::Restore(const Snapshot& snapshot) {
+    if (snapshot.type != type_) return;
     
-    std::ostringstream oss;
-    oss << base_time << "." << std::setfill('0') << std::setw(3) << milliseconds;
+    TimerService::Id stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = snapshot.state;
+        accumulated_time_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(snapshot.accumulated);
+        countdown_duration_ = snapshot.duration;
+        laps_.Clear();
+        
+        if (state_ == State::Running) {
+            auto steady_now = Now();
+            auto wall_now = std::chrono::system_clock::now();
+            auto steady_elapsed = steady_now - snapshot.anchor_steady;
+            auto wall_elapsed = std::chrono::duration_cast<std::chrono::steady_clock::duration>(wall_now - snapshot.anchor_wall);
+            
+            // Prefer the steady clock, which ignores wall clock steps; across a
+            // reboot its epoch restarts and only the wall clock is meaningful
+            auto difference = steady_elapsed - wall_elapsed;
+            bool same_boot = steady_elapsed.count() >= 0
+                && difference < SAME_BOOT_TOLERANCE && difference > -SAME_BOOT_TOLERANCE;
+            auto running = same_boot ? steady_elapsed
+                : std::max(std::chrono::steady_clock::duration{0}, wall_elapsed);
+            
+            start_time_ = steady_now - running;
+            start_wall_time_ = snapshot.anchor_wall;
+        }
+        stale = RearmLocked();
+        PublishLocked();
+    }
+    CancelDeadline(stale);
+}
+
+uint64_t Timer::GetRevision() const {
+    return Read().revision;
+}
+
+size_t Timer::FormatTime(char* buffer, size_t size, bool with_milliseconds) const {
+    static const TimeFormat SECONDS_FORMAT("[HH:]MM:SS");
+    static const TimeFormat MILLISECONDS_FORMAT("[HH:]MM:SS.fff");
+    
+    Reading reading = Read();
+    auto now = Now();
+    std::chrono::nanoseconds value;
+    if (type_ == Type::Stopwatch) {
+        value = ElapsedAt(reading, now);
+    } else if (with_milliseconds) {
+        value = reading.state == State::Stopped ? std::chrono::nanoseconds{0}
+            : std::max(std::chrono::nanoseconds{0}, reading.duration - ElapsedAt(reading, now));
+    } else {
+        // Same whole-second rounding as GetRemainingTime()
+        value = RemainingAt(reading, now);
+    }
     
-    return oss.str();
+    const TimeFormat& format = with_milliseconds ? MILLISECONDS_FORMAT : SECONDS_FORMAT;
+    return format.Format(TimeFields::FromDuration(value), buffer, size);
+}
+
+std::string Timer::FormatTime() const {
+    char buffer[32];
+    size_t length = FormatTime(buffer, sizeof(buffer), false);
+    return std::string(buffer, length);
+}
+
+std::string Timer::FormatTimeWithMilliseconds() const {
+    char buffer[32];
+    size_t length = FormatTime(buffer, sizeof(buffer), true);
+    return std::string(buffer, length);
 }
@@ -1,8 +1,20 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
-#include <functional>
+#include <mutex>
+#include <string>
+#include "CallbackExecutor.h"
+#include "InlineCallback.h"
+#include "TimerService.h"
+#include "TscClock.h"
+#include "LapStore.h"
 
+// Control calls (Start, Pause, Lap, ...) serialize on a mutex shared with the
+// expiry thread. Each one republishes the state and anchors behind a
+// per-timer seqlock, so the read-only calls (elapsed, remaining, state,
+// formatting) never take the mutex: the render thread keeps drawing while a
+// hotkey or the service thread changes the timer.
 class Timer {
 public:
     enum class Type {
@@ -16,39 +28,145 @@ public:
         Paused
     };
     
+    // Everything needed to bring a timer back in another process. The anchors
+    // are steady and wall clock readings taken together when it last started
+    // running.
+    struct Snapshot {
+        Type type = Type::Stopwatch;
+        State state = State::Stopped;
+        std::chrono::nanoseconds accumulated{0};
+        std::chrono::seconds duration{0};
+        std::chrono::steady_clock::time_point anchor_steady;
+        std::chrono::system_clock::time_point anchor_wall;
+    };
+    
     explicit Timer(Type type);
+    ~Timer();
     
     void Start();
     void Stop();
     void Pause();
     void Resume();
     void Reset();
+    void Lap(); // Stopwatch only, while running
+    
+    // Same, taking effect at `at` (on the Now() timeline) instead of now, for
+    // events timestamped elsewhere. Times before the last state change are
+    // clamped to it.
+    void Start(std::chrono::steady_clock::time_point at);
+    void Pause(std::chrono::steady_clock::time_point at);
+    void Resume(std::chrono::steady_clock::time_point at);
+    void Lap(std::chrono::steady_clock::time_point at);
     
     void SetDuration(std::chrono::seconds duration); // For countdown
     void Update();
     
+    // Countdown expiry is driven by the service thread once attached;
+    // Update() keeps working as a polling fallback
+    void AttachService(TimerService* service);
+    
+    // Reads time from `clock` instead of steady_clock::now(); nullptr restores
+    // the default. Both share the steady_clock timeline, so this can be
+    // switched at any time.
+    void SetClockSource(const TscClock* clock);
+    
+    // Any thread, lock-free
     std::chrono::milliseconds GetElapsedTime() const;
+    std::chrono::nanoseconds GetElapsedNanoseconds() const;
     std::chrono::seconds GetRemainingTime() const;
     
-    State GetState() const { return state_; }
+    State GetState() const;
     Type GetType() const { return type_; }
     
-    void SetOnFinished(std::function<void()> callback);
+    // Laps are recorded and read on the UI thread
+    const LapStore& GetLaps() const { return laps_; }
+    
+    // The callback must not call SetOnFinished() itself
+    void SetOnFinished(InlineCallback&& callback);
+    
+    // Runs the finished callback on `executor` instead of the thread that
+    // noticed expiry; falls back to running it inline if the queue is full
+    void SetExecutor(CallbackExecutor* executor);
+    
+    // Persistence. Restore() counts the time the timer spent out of memory as
+    // running time; a countdown that ran out meanwhile finishes right away.
+    // Laps are not part of the snapshot.
+    Snapshot GetSnapshot() const;
+    void Restore(const Snapshot& snapshot);
+    
+    // Changes whenever the snapshot may have changed
+    uint64_t GetRevision() const;
     
     // Formatting helpers
     std::string FormatTime() const;
     std::string FormatTimeWithMilliseconds() const;
     
+    // Allocation-free variant; samples the clock once. Returns the length written.
+    size_t FormatTime(char* buffer, size_t size, bool with_milliseconds) const;
+    
 private:
+    mutable std::mutex mutex_;
+    
     Type type_;
     State state_;
     
     std::chrono::steady_clock::time_point start_time_;
     std::chrono::steady_clock::time_point pause_time_;
-    std::chrono::milliseconds accumulated_time_{0};
+    std::chrono::system_clock::time_point start_wall_time_;
+    std::chrono::steady_clock::duration accumulated_time_{0};
     
     std::chrono::seconds countdown_duration_{0};
-    std::function<void()> on_finished_callback_;
+    
+    std::mutex callback_mutex_; // guards on_finished_callback_, taken without mutex_ held
+    InlineCallback on_finished_callback_;
+    CallbackExecutor* executor_ = nullptr;
+    
+    LapStore laps_;
+    
+    std::atomic<const TscClock*> clock_{nullptr};
+    
+    TimerService* service_ = nullptr;
+    TimerService::Id pending_deadline_ = 0;
+    uint64_t generation_ = 0;
     
     void CheckCountdownFinished();
+    void OnDeadline(uint64_t generation);
+    void NotifyFinished(CallbackExecutor* executor);
+    void InvokeFinished();
+    
+    std::chrono::steady_clock::time_point Now() const {
+        const TscClock* clock = clock_.load(std::memory_order_acquire);
+        return clock ? clock->Now() : std::chrono::steady_clock::now();
+    }
+    
+    // What the readers need, copied out of the members under mutex_ or out
+    // of the seqlock without it
+    struct Reading {
+        State state = State::Stopped;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::duration accumulated{0};
+        std::chrono::seconds duration{0};
+        uint64_t revision = 0;
+    };
+    
+    static std::chrono::steady_clock::duration ElapsedAt(const Reading& reading, std::chrono::steady_clock::time_point at);
+    static std::chrono::seconds RemainingAt(const Reading& reading, std::chrono::steady_clock::time_point at);
+    Reading Read() const;
+    
+    // Callers hold mutex_
+    Reading ReadLocked() const;
+    void PublishLocked();
+    std::chrono::steady_clock::duration ElapsedLocked() const;
+    std::chrono::steady_clock::duration ElapsedAtLocked(std::chrono::steady_clock::time_point at) const;
+    std::chrono::seconds RemainingLocked() const;
+    TimerService::Id RearmLocked();
+    void CancelDeadline(TimerService::Id id);
+    
+    // Seqlock copy of the Reading, written by PublishLocked()
+    std::atomic<uint32_t> sequence_{0};
+    std::atomic<uint32_t> published_state_{0};
+    std::atomic<int64_t> published_start_{0};
+    std::atomic<int64_t> published_accumulated_{0};
+    std::atomic<int64_t> published_duration_{0};
+    std::atomic<uint64_t> published_revision_{0};
 };
@@ -0,0 +1,359 @@
+#include "TimerPool.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TIMERPOOL_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TIMERPOOL_TARGET_AVX2
+#else
+#define TIMERPOOL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define TIMERPOOL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+    enum Flags : uint8_t {
+        RUNNING = 1,
+        PAUSED = 2,
+        COUNTDOWN = 4,
+        USED = 8,
+        CHANGED = 16   // listed in changed_
+    };
+    
+    struct Columns {
+        const uint8_t* flags;
+        const int64_t* start;
+        const int64_t* accumulated;
+        const int64_t* duration;
+        int64_t* elapsed;
+        int64_t* remaining;
+    };
+    
+    using Kernel = void (*)(const Columns& columns, size_t count, int64_t now, std::vector<TimerPool::Index>& expired);
+    
+    int64_t ToNanoseconds(TimerPool::Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+    
+    // Per slot:
+    //   elapsed   = accumulated + (running ? now - start : 0)
+    //   remaining = active countdown ? max(duration - elapsed, 0) : 0
+    //   expired   = running countdown with duration - elapsed <= 0
+    void EvaluateScalar(const Columns& c, size_t begin, size_t end, int64_t now,
+                        std::vector<TimerPool::Index>& expired) {
+        for (size_t i = begin; i < end; ++i) {
+            uint8_t flags = c.flags[i];
+            int64_t running_mask = -static_cast<int64_t>(flags & RUNNING);
+            int64_t elapsed = c.accumulated[i] + (running_mask & (now - c.start[i]));
+            int64_t left = c.duration[i] - elapsed;
+            bool active_countdown = (flags & COUNTDOWN) && (flags & (RUNNING | PAUSED));
+            
+            c.elapsed[i] = elapsed;
+            c.remaining[i] = active_countdown && left > 0 ? left : 0;
+            if ((flags & (RUNNING | COUNTDOWN)) == (RUNNING | COUNTDOWN) && left <= 0) {
+                expired.push_back(static_cast<TimerPool::Index>(i));
+            }
+        }
+    }
+    
+    void EvaluateScalarKernel(const Columns& c, size_t count, int64_t now, std::vector<TimerPool::Index>& expired) {
+        EvaluateScalar(c, 0, count, now, expired);
+    }
+
+#ifdef TIMERPOOL_AVX2
+    int CountTrailingZeros(unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+    
+    bool CpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28))
+            && (_xgetbv(0) & 0x6) == 0x6;
+        if (!os_saves_ymm) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+    
+    TIMERPOOL_TARGET_AVX2
+    void EvaluateAvx2(const Columns& c, size_t count, int64_t now, std::vector<TimerPool::Index>& expired) {
+        const __m256i now_v = _mm256_set1_epi64x(now);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i running_bit = _mm256_set1_epi64x(RUNNING);
+        const __m256i countdown_bit = _mm256_set1_epi64x(COUNTDOWN);
+        const __m256i active_bits = _mm256_set1_epi64x(RUNNING | PAUSED);
+        
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            int32_t packed;
+            std::memcpy(&packed, c.flags + i, sizeof(packed));
+            __m256i flags = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+            
+            __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.start + i));
+            __m256i accumulated = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.accumulated + i));
+            __m256i duration = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.duration + i));
+            
+            __m256i running = _mm256_cmpeq_epi64(_mm256_and_si256(flags, running_bit), running_bit);
+            __m256i countdown = _mm256_cmpeq_epi64(_mm256_and_si256(flags, countdown_bit), countdown_bit);
+            __m256i inactive = _mm256_cmpeq_epi64(_mm256_and_si256(flags, active_bits), zero);
+            
+            __m256i elapsed = _mm256_add_epi64(accumulated,
+                _mm256_and_si256(running, _mm256_sub_epi64(now_v, start)));
+            __m256i left = _mm256_sub_epi64(duration, elapsed);
+            __m256i positive = _mm256_cmpgt_epi64(left, zero);
+            
+            // remaining = left where (countdown & active & positive), else 0
+            __m256i keep = _mm256_andnot_si256(inactive, _mm256_and_si256(countdown, positive));
+            __m256i remaining = _mm256_and_si256(keep, left);
+            
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.elapsed + i), elapsed);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c.remaining + i), remaining);
+            
+            __m256i done = _mm256_andnot_si256(positive, _mm256_and_si256(running, countdown));
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(done)));
+            while (mask) {
+                expired.push_back(static_cast<TimerPool::Index>(i + CountTrailingZeros(mask)));
+                mask &= mask - 1;
+            }
+        }
+        
+        EvaluateScalar(c, i, count, now, expired);
+    }
+#endif
+
+#ifdef TIMERPOOL_NEON
+    void EvaluateNeon(const Columns& c, size_t count, int64_t now, std::vector<TimerPool::Index>& expired) {
+        const int64x2_t now_v = vdupq_n_s64(now);
+        const int64x2_t zero = vdupq_n_s64(0);
+        const uint64x2_t running_bit = vdupq_n_u64(RUNNING);
+        const uint64x2_t countdown_bit = vdupq_n_u64(COUNTDOWN);
+        const uint64x2_t active_bits = vdupq_n_u64(RUNNING | PAUSED);
+        
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            uint64x2_t flags = vcombine_u64(vcreate_u64(c.flags[i]), vcreate_u64(c.flags[i + 1]));
+            
+            int64x2_t start = vld1q_s64(c.start + i);
+            int64x2_t accumulated = vld1q_s64(c.accumulated + i);
+            int64x2_t duration = vld1q_s64(c.duration + i);
+            
+            uint64x2_t running = vtstq_u64(flags, running_bit);
+            uint64x2_t countdown = vtstq_u64(flags, countdown_bit);
+            uint64x2_t active = vtstq_u64(flags, active_bits);
+            
+            int64x2_t elapsed = vaddq_s64(accumulated,
+                vandq_s64(vreinterpretq_s64_u64(running), vsubq_s64(now_v, start)));
+            int64x2_t left = vsubq_s64(duration, elapsed);
+            uint64x2_t positive = vcgtq_s64(left, zero);
+            
+            uint64x2_t keep = vandq_u64(vandq_u64(countdown, active), positive);
+            int64x2_t remaining = vandq_s64(vreinterpretq_s64_u64(keep), left);
+            
+            vst1q_s64(c.elapsed + i, elapsed);
+            vst1q_s64(c.remaining + i, remaining);
+            
+            uint64x2_t done = vbicq_u64(vandq_u64(running, countdown), positive);
+            if (vgetq_lane_u64(done, 0)) expired.push_back(static_cast<TimerPool::Index>(i));
+            if (vgetq_lane_u64(done, 1)) expired.push_back(static_cast<TimerPool::Index>(i + 1));
+        }
+        
+        EvaluateScalar(c, i, count, now, expired);
+    }
+#endif
+
+    struct Backend {
+        Kernel kernel;
+        const char* name;
+    };
+    
+    Backend SelectBackend() {
+#if defined(TIMERPOOL_AVX2)
+        if (CpuHasAvx2()) return { EvaluateAvx2, "AVX2" };
+#elif defined(TIMERPOOL_NEON)
+        return { EvaluateNeon, "NEON" };
+#endif
+        return { EvaluateScalarKernel, "scalar" };
+    }
+    
+    const Backend& GetBackend() {
+        static const Backend backend = SelectBackend();
+        return backend;
+    }
+}
+
+TimerPool::TimerPool() {
+}
+
+TimerPool::Index TimerPool::Add(Timer::Type type, std::chrono::nanoseconds duration) {
+    uint8_t flags = USED | (type == Timer::Type::Countdown ? COUNTDOWN : 0);
+    
+    if (!free_.empty()) {
+        Index index = free_.back();
+        free_.pop_back();
+        flags_[index] = static_cast<uint8_t>(flags | (flags_[index] & CHANGED));
+        start_[index] = 0;
+        accumulated_[index] = 0;
+        duration_[index] = duration.count();
+        elapsed_[index] = 0;
+        remaining_[index] = 0;
+        names_[index].clear();
+        MarkChanged(index);
+        return index;
+    }
+    
+    Index index = static_cast<Index>(flags_.size());
+    flags_.push_back(flags);
+    start_.push_back(0);
+    accumulated_.push_back(0);
+    duration_.push_back(duration.count());
+    elapsed_.push_back(0);
+    remaining_.push_back(0);
+    names_.emplace_back();
+    MarkChanged(index);
+    return index;
+}
+
+void TimerPool::Remove(Index index) {
+    if (index >= flags_.size() || !(flags_[index] & USED)) return;
+    if (flags_[index] & RUNNING) --running_;
+    
+    // A free slot evaluates like a stopped stopwatch
+    flags_[index] = static_cast<uint8_t>(flags_[index] & CHANGED);
+    accumulated_[index] = 0;
+    elapsed_[index] = 0;
+    remaining_[index] = 0;
+    free_.push_back(index);
+    MarkChanged(index);
+}
+
+void TimerPool::Clear() {
+    flags_.clear();
+    start_.clear();
+    accumulated_.clear();
+    duration_.clear();
+    elapsed_.clear();
+    remaining_.clear();
+    names_.clear();
+    free_.clear();
+    running_ = 0;
+    changed_.clear();
+}
+
+void TimerPool::Start(Index index, Clock::time_point now) {
+    uint8_t& flags = flags_[index];
+    if (flags & RUNNING) return;
+    
+    // Same rules as Timer::Start(): a stopwatch starts over, a countdown
+    // keeps what it already used
+    if (!(flags & COUNTDOWN)) {
+        accumulated_[index] = 0;
+    }
+    start_[index] = ToNanoseconds(now);
+    flags = static_cast<uint8_t>((flags & ~PAUSED) | RUNNING);
+    ++running_;
+    MarkChanged(index);
+}
+
+void TimerPool::Pause(Index index, Clock::time_point now) {
+    uint8_t& flags = flags_[index];
+    if (!(flags & RUNNING)) return;
+    
+    accumulated_[index] += ToNanoseconds(now) - start_[index];
+    flags = static_cast<uint8_t>((flags & ~RUNNING) | PAUSED);
+    --running_;
+    MarkChanged(index);
+}
+
+void TimerPool::Resume(Index index, Clock::time_point now) {
+    uint8_t& flags = flags_[index];
+    if (!(flags & PAUSED)) return;
+    
+    start_[index] = ToNanoseconds(now);
+    flags = static_cast<uint8_t>((flags & ~PAUSED) | RUNNING);
+    ++running_;
+    MarkChanged(index);
+}
+
+void TimerPool::Stop(Index index) {
+    if (flags_[index] & RUNNING) --running_;
+    flags_[index] = static_cast<uint8_t>(flags_[index] & ~(RUNNING | PAUSED));
+    accumulated_[index] = 0;
+    MarkChanged(index);
+}
+
+void TimerPool::SetDuration(Index index, std::chrono::nanoseconds duration) {
+    duration_[index] = duration.count();
+    MarkChanged(index);
+}
+
+void TimerPool::SetName(Index index, std::string name) {
+    names_[index] = std::move(name);
+    MarkChanged(index);
+}
+
+void TimerPool::TakeChanges(std::vector<Index>& changed) {
+    for (Index index : changed_) {
+        flags_[index] = static_cast<uint8_t>(flags_[index] & ~CHANGED);
+    }
+    changed.insert(changed.end(), changed_.begin(), changed_.end());
+    changed_.clear();
+}
+
+void TimerPool::MarkChanged(Index index) {
+    if (flags_[index] & CHANGED) return;
+    flags_[index] = static_cast<uint8_t>(flags_[index] | CHANGED);
+    changed_.push_back(index);
+}
+
+bool TimerPool::IsUsed(Index index) const {
+    return (flags_[index] & USED) != 0;
+}
+
+Timer::Type TimerPool::GetType(Index index) const {
+    return (flags_[index] & COUNTDOWN) ? Timer::Type::Countdown : Timer::Type::Stopwatch;
+}
+
+Timer::State TimerPool::GetState(Index index) const {
+    uint8_t flags = flags_[index];
+    if (flags & RUNNING) return Timer::State::Running;
+    if (flags & PAUSED) return Timer::State::Paused;
+    return Timer::State::Stopped;
+}
+
+size_t TimerPool::Evaluate(Clock::time_point now, std::vector<Index>& expired) {
+    Columns columns = {
+        flags_.data(), start_.data(), accumulated_.data(), duration_.data(),
+        elapsed_.data(), remaining_.data()
+    };
+    
+    size_t first = expired.size();
+    evaluated_at_ = ToNanoseconds(now);
+    GetBackend().kernel(columns, flags_.size(), evaluated_at_, expired);
+    
+    // Finished countdowns stop, as Timer does
+    for (size_t i = first; i < expired.size(); ++i) {
+        Index index = expired[i];
+        Stop(index);
+        elapsed_[index] = 0;
+        remaining_[index] = 0;
+    }
+    return expired.size() - first;
+}
+
+const char* TimerPool::GetBackendName() {
+    return GetBackend().name;
+}
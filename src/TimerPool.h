@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Timer.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Many lightweight timers stored as parallel arrays (state flags, start,
+// accumulated, duration), so a dashboard can evaluate all of them in one
+// vectorised pass instead of locking and branching per Timer object.
+// Times are nanoseconds on the steady_clock timeline. Not thread-safe: the
+// owner drives it from one thread.
+//
+// Every slot whose state, duration or name changes is also noted once in a
+// change list, so a sorted view can re-place just those rows.
+class TimerPool {
+public:
+    using Index = uint32_t;
+    using Clock = std::chrono::steady_clock;
+    
+    TimerPool();
+    
+    // Indices stay valid until removed; freed slots are reused
+    Index Add(Timer::Type type, std::chrono::nanoseconds duration = std::chrono::nanoseconds{0});
+    void Remove(Index index);
+    void Clear();
+    
+    void Start(Index index, Clock::time_point now);
+    void Pause(Index index, Clock::time_point now);
+    void Resume(Index index, Clock::time_point now);
+    void Stop(Index index);
+    void SetDuration(Index index, std::chrono::nanoseconds duration);
+    
+    // Kept with the slot after Remove() until it is reused
+    void SetName(Index index, std::string name);
+    const std::string& GetName(Index index) const { return names_[index]; }
+    
+    size_t Capacity() const { return flags_.size(); } // including free slots
+    size_t Size() const { return flags_.size() - free_.size(); }
+    size_t RunningCount() const { return running_; }
+    bool IsUsed(Index index) const;
+    
+    Timer::Type GetType(Index index) const;
+    Timer::State GetState(Index index) const;
+    
+    // Recomputes elapsed and remaining time for every slot, stops running
+    // countdowns that reached zero and appends their indices to `expired`.
+    // Returns the number appended.
+    size_t Evaluate(Clock::time_point now, std::vector<Index>& expired);
+    
+    // Slots changed since the last call, each once, appended to `changed`.
+    // Meant for a single observer. Clear() drops the list.
+    void TakeChanges(std::vector<Index>& changed);
+    
+    // Values as of the last Evaluate()
+    Clock::time_point GetEvaluatedAt() const { return Clock::time_point{std::chrono::nanoseconds{evaluated_at_}}; }
+    std::chrono::nanoseconds GetElapsed(Index index) const { return std::chrono::nanoseconds{elapsed_[index]}; }
+    std::chrono::nanoseconds GetRemaining(Index index) const { return std::chrono::nanoseconds{remaining_[index]}; }
+    
+    // Which implementation Evaluate() dispatches to: "AVX2", "NEON" or "scalar"
+    static const char* GetBackendName();
+
+private:
+    std::vector<uint8_t> flags_;
+    std::vector<int64_t> start_;
+    std::vector<int64_t> accumulated_;
+    std::vector<int64_t> duration_;
+    
+    // Evaluation output
+    std::vector<int64_t> elapsed_;
+    std::vector<int64_t> remaining_;
+    int64_t evaluated_at_ = 0;
+    
+    size_t running_ = 0;
+    
+    std::vector<std::string> names_;
+    std::vector<Index> free_;
+    std::vector<Index> changed_;
+    
+    void MarkChanged(Index index);
+};
@@ -0,0 +1,290 @@
+#include "TimerService.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include "WindowsHeaders.h"
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+    // The OS timer is armed this much before the deadline and the remainder is
+    // spun out, which is what gets lateness below the kernel's timer slack.
+#ifdef _WIN32
+    constexpr std::chrono::microseconds SPIN_WINDOW{1000};
+#else
+    constexpr std::chrono::microseconds SPIN_WINDOW{200};
+#endif
+}
+
+std::chrono::nanoseconds TimerService::LatenessStats::Mean() const {
+    return count > 0 ? total / static_cast<int64_t>(count) : std::chrono::nanoseconds{0};
+}
+
+std::chrono::nanoseconds TimerService::LatenessStats::Percentile(double p) const {
+    if (count == 0) {
+        return std::chrono::nanoseconds{0};
+    }
+    
+    auto target = static_cast<uint64_t>(p * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen > target || i == BUCKET_COUNT - 1) {
+            return std::min(max, std::chrono::nanoseconds{std::chrono::microseconds{1LL << i}});
+        }
+    }
+    return max;
+}
+
+TimerService::TimerService()
+    : next_id_(1)
+    , running_id_(0)
+    , stop_(false) {
+#ifdef _WIN32
+    timer_handle_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!timer_handle_) {
+        // Pre-1803 Windows has no high resolution timers
+        timer_handle_ = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+    }
+    wake_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+#elif defined(__linux__)
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#else
+    wake_pending_ = false;
+    armed_deadline_ = Clock::time_point::max();
+#endif
+
+    thread_ = std::thread(&TimerService::Run, this);
+}
+
+TimerService::~TimerService() {
+    stop_ = true;
+    Wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+#ifdef _WIN32
+    if (timer_handle_) CloseHandle(timer_handle_);
+    if (wake_event_) CloseHandle(wake_event_);
+#elif defined(__linux__)
+    if (timer_fd_ >= 0) close(timer_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+#endif
+}
+
+TimerService::Id TimerService::Schedule(Clock::time_point deadline, Callback callback) {
+    bool is_earliest;
+    Id id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        callbacks_.emplace(id, std::make_pair(deadline, std::move(callback)));
+        auto it = deadlines_.emplace(deadline, id);
+        is_earliest = (it == deadlines_.begin());
+    }
+    
+    // Only a new head of the queue changes when the thread has to wake up
+    if (is_earliest) {
+        Wake();
+    }
+    return id;
+}
+
+bool TimerService::Cancel(Id id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    bool removed = false;
+    auto it = callbacks_.find(id);
+    if (it != callbacks_.end()) {
+        auto range = deadlines_.equal_range(it->second.first);
+        for (auto d = range.first; d != range.second; ++d) {
+            if (d->second == id) {
+                deadlines_.erase(d);
+                break;
+            }
+        }
+        callbacks_.erase(it);
+        removed = true;
+    }
+    
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        callback_done_.wait(lock, [this, id]() { return running_id_ != id; });
+    }
+    return removed;
+}
+
+TimerService::LatenessStats TimerService::GetLatenessStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lateness_;
+}
+
+void TimerService::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (!stop_) {
+        if (deadlines_.empty()) {
+            ArmOsTimer(Clock::time_point::max());
+            lock.unlock();
+            WaitForWakeup();
+            lock.lock();
+            continue;
+        }
+        
+        auto next = deadlines_.begin()->first;
+        if (next - Clock::now() > SPIN_WINDOW) {
+            ArmOsTimer(next - SPIN_WINDOW);
+            lock.unlock();
+            WaitForWakeup();
+            lock.lock();
+            continue;
+        }
+        
+        // Close enough: spin out the rest so we don't depend on timer slack
+        lock.unlock();
+        while (Clock::now() < next && !stop_) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+        
+        auto now = Clock::now();
+        while (!deadlines_.empty() && deadlines_.begin()->first <= now && !stop_) {
+            Id id = deadlines_.begin()->second;
+            deadlines_.erase(deadlines_.begin());
+            
+            auto it = callbacks_.find(id);
+            auto deadline = it->second.first;
+            Callback callback = std::move(it->second.second);
+            callbacks_.erase(it);
+            
+            running_id_ = id;
+            RecordLateness(Clock::now() - deadline);
+            lock.unlock();
+            
+            if (callback) {
+                callback();
+            }
+            
+            lock.lock();
+            running_id_ = 0;
+            callback_done_.notify_all();
+        }
+    }
+}
+
+void TimerService::RecordLateness(std::chrono::nanoseconds lateness) {
+    lateness = std::max(lateness, std::chrono::nanoseconds{0});
+    
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(lateness).count();
+    int bucket = 0;
+    while (us > 0 && bucket < LatenessStats::BUCKET_COUNT - 1) {
+        us >>= 1;
+        ++bucket;
+    }
+    
+    lateness_.count++;
+    lateness_.last = lateness;
+    lateness_.max = std::max(lateness_.max, lateness);
+    lateness_.total += lateness;
+    lateness_.buckets[bucket]++;
+}
+
+#ifdef _WIN32
+
+void TimerService::ArmOsTimer(Clock::time_point deadline) {
+    if (!timer_handle_) return;
+    
+    if (deadline == Clock::time_point::max()) {
+        CancelWaitableTimer(timer_handle_);
+        return;
+    }
+    
+    // Negative due time is relative, in 100 ns units
+    auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+    LARGE_INTEGER due;
+    due.QuadPart = -std::max<long long>(1, delta.count() / 100);
+    SetWaitableTimer(timer_handle_, &due, 0, nullptr, nullptr, FALSE);
+}
+
+void TimerService::WaitForWakeup() {
+    HANDLE handles[2] = { wake_event_, timer_handle_ };
+    WaitForMultipleObjects(timer_handle_ ? 2 : 1, handles, FALSE, INFINITE);
+}
+
+void TimerService::Wake() {
+    SetEvent(wake_event_);
+}
+
+#elif defined(__linux__)
+
+void TimerService::ArmOsTimer(Clock::time_point deadline) {
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    
+    if (deadline != Clock::time_point::max()) {
+        // steady_clock is CLOCK_MONOTONIC, so the deadline can be armed as an absolute value
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        ns = std::max<long long>(ns, 1); // all zeroes would disarm
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    }
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void TimerService::WaitForWakeup() {
+    pollfd fds[2] = {
+        { wake_fd_, POLLIN, 0 },
+        { timer_fd_, POLLIN, 0 }
+    };
+    if (poll(fds, 2, -1) <= 0) {
+        return;
+    }
+    
+    uint64_t value;
+    if (fds[0].revents & POLLIN) {
+        (void)!read(wake_fd_, &value, sizeof(value));
+    }
+    if (fds[1].revents & POLLIN) {
+        (void)!read(timer_fd_, &value, sizeof(value));
+    }
+}
+
+void TimerService::Wake() {
+    uint64_t one = 1;
+    (void)!write(wake_fd_, &one, sizeof(one));
+}
+
+#else
+
+void TimerService::ArmOsTimer(Clock::time_point deadline) {
+    armed_deadline_ = deadline;
+}
+
+void TimerService::WaitForWakeup() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (armed_deadline_ == Clock::time_point::max()) {
+        wake_cv_.wait(lock, [this]() { return wake_pending_; });
+    } else {
+        wake_cv_.wait_until(lock, armed_deadline_, [this]() { return wake_pending_; });
+    }
+    wake_pending_ = false;
+}
+
+void TimerService::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_pending_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "InlineCallback.h"
+
+// Fires deadline callbacks from a dedicated thread blocked on an OS timer
+// (timerfd on Linux, a high-resolution waitable timer on Windows), so expiry
+// no longer depends on somebody polling Timer::Update() once per frame.
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = InlineCallback;
+    using Id = uint64_t;
+    
+    // Lateness = time the callback started minus its deadline.
+    struct LatenessStats {
+        static constexpr int BUCKET_COUNT = 16; // bucket i holds [2^(i-1), 2^i) us, bucket 0 is < 1 us
+        
+        uint64_t count = 0;
+        std::chrono::nanoseconds last{0};
+        std::chrono::nanoseconds max{0};
+        std::chrono::nanoseconds total{0};
+        uint64_t buckets[BUCKET_COUNT] = {};
+        
+        std::chrono::nanoseconds Mean() const;
+        std::chrono::nanoseconds Percentile(double p) const; // upper bound of the bucket
+    };
+    
+    TimerService();
+    ~TimerService();
+    
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+    
+    Id Schedule(Clock::time_point deadline, Callback callback);
+    
+    // Removes a pending deadline. If the callback is running on the service
+    // thread right now, waits for it to return (unless called from it).
+    bool Cancel(Id id);
+    
+    LatenessStats GetLatenessStats() const;
+
+private:
+    void Run();
+    void ArmOsTimer(Clock::time_point deadline);
+    void WaitForWakeup();
+    void Wake();
+    void RecordLateness(std::chrono::nanoseconds lateness);
+    
+    mutable std::mutex mutex_;
+    std::condition_variable callback_done_;
+    std::multimap<Clock::time_point, Id> deadlines_;
+    std::unordered_map<Id, std::pair<Clock::time_point, Callback>> callbacks_;
+    Id next_id_;
+    Id running_id_;
+    LatenessStats lateness_;
+    
+    std::atomic<bool> stop_;
+    std::thread thread_;
+
+#ifdef _WIN32
+    void* timer_handle_;
+    void* wake_event_;
+#elif defined(__linux__)
+    int timer_fd_;
+    int wake_fd_;
+#else
+    std::condition_variable wake_cv_;
+    bool wake_pending_;
+    Clock::time_point armed_deadline_;
+#endif
+};
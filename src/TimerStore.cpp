@@ -0,0 +1,261 @@
+#include "TimerStore.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include "WindowsHeaders.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    template <typename Clock>
+    int64_t ToNanoseconds(typename Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+    
+    template <typename Clock>
+    typename Clock::time_point FromNanoseconds(int64_t nanoseconds) {
+        return typename Clock::time_point(
+            std::chrono::duration_cast<typename Clock::duration>(std::chrono::nanoseconds{nanoseconds}));
+    }
+    
+    // Index of the valid copy with the highest sequence, or -1
+    template <typename Slot, typename Valid>
+    int Newest(const Slot& slot, Valid is_valid) {
+        bool first = is_valid(slot.copies[0]);
+        bool second = is_valid(slot.copies[1]);
+        if (first && second) {
+            return slot.copies[1].sequence > slot.copies[0].sequence ? 1 : 0;
+        }
+        return first ? 0 : (second ? 1 : -1);
+    }
+}
+
+TimerStore::TimerStore() {
+}
+
+TimerStore::~TimerStore() {
+    Close();
+}
+
+bool TimerStore::Open(const std::string& path, uint32_t capacity) {
+    Close();
+    
+    size_t size = sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Slot);
+    bool created = false;
+    if (!Map(path, size, created)) {
+        std::cerr << "Timer store: cannot map " << path << std::endl;
+        Unmap();
+        return false;
+    }
+    
+    auto* header = static_cast<Header*>(mapping_);
+    bool matches = header->magic == MAGIC && header->version == VERSION
+        && header->capacity == capacity && header->record_size == sizeof(Record);
+    if (created || !matches) {
+        std::memset(mapping_, 0, size);
+        header->version = VERSION;
+        header->capacity = capacity;
+        header->record_size = sizeof(Record);
+        // The magic goes last so a half-initialised file is never trusted
+        header->magic = MAGIC;
+    }
+    
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping_) + sizeof(Header));
+    capacity_ = capacity;
+    return true;
+}
+
+void TimerStore::Close() {
+    if (slots_) {
+        Flush();
+    }
+    Unmap();
+    slots_ = nullptr;
+    capacity_ = 0;
+}
+
+bool TimerStore::Read(uint32_t slot, Timer::Snapshot& snapshot) const {
+    if (!slots_ || slot >= capacity_) return false;
+    
+    int newest = Newest(slots_[slot], IsValid);
+    if (newest < 0) return false;
+    
+    const Record& record = slots_[slot].copies[newest];
+    snapshot.type = static_cast<Timer::Type>(record.type);
+    snapshot.state = static_cast<Timer::State>(record.state);
+    snapshot.accumulated = std::chrono::nanoseconds{record.accumulated};
+    snapshot.duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::nanoseconds{record.duration});
+    snapshot.anchor_steady = FromNanoseconds<std::chrono::steady_clock>(record.anchor_steady);
+    snapshot.anchor_wall = FromNanoseconds<std::chrono::system_clock>(record.anchor_wall);
+    return true;
+}
+
+void TimerStore::Write(uint32_t slot, const Timer::Snapshot& snapshot) {
+    if (!slots_ || slot >= capacity_) return;
+    
+    Slot& target = slots_[slot];
+    int newest = Newest(target, IsValid);
+    
+    Record record = {};
+    record.sequence = newest < 0 ? 1 : target.copies[newest].sequence + 1;
+    record.type = static_cast<uint8_t>(snapshot.type);
+    record.state = static_cast<uint8_t>(snapshot.state);
+    record.accumulated = snapshot.accumulated.count();
+    record.duration = std::chrono::nanoseconds{snapshot.duration}.count();
+    record.anchor_steady = ToNanoseconds<std::chrono::steady_clock>(snapshot.anchor_steady);
+    record.anchor_wall = ToNanoseconds<std::chrono::system_clock>(snapshot.anchor_wall);
+    record.checksum = Checksum(record);
+    
+    // Never touch the newest valid copy
+    std::memcpy(&target.copies[newest == 0 ? 1 : 0], &record, sizeof(Record));
+}
+
+void TimerStore::Clear(uint32_t slot) {
+    if (!slots_ || slot >= capacity_) return;
+    std::memset(&slots_[slot], 0, sizeof(Slot));
+}
+
+uint64_t TimerStore::Checksum(const Record& record) {
+    // FNV-1a over 64-bit words with a final avalanche; covers everything but
+    // the checksum itself
+    uint64_t words[sizeof(Record) / sizeof(uint64_t) - 1];
+    std::memcpy(words, &record, sizeof(words));
+    
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint64_t word : words) {
+        hash = (hash ^ word) * 0x100000001B3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool TimerStore::IsValid(const Record& record) {
+    return record.sequence != 0
+        && record.type <= static_cast<uint8_t>(Timer::Type::Countdown)
+        && record.state <= static_cast<uint8_t>(Timer::State::Paused)
+        && record.checksum == Checksum(record);
+}
+
+#ifdef _WIN32
+
+bool TimerStore::Map(const std::string& path, size_t size, bool& created) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    created = GetLastError() != ERROR_ALREADY_EXISTS;
+    
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(file, &current)) return false;
+    if (static_cast<size_t>(current.QuadPart) != size) {
+        LARGE_INTEGER target;
+        target.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, target, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) return false;
+        created = true;
+    }
+    
+    ULARGE_INTEGER mapping_size;
+    mapping_size.QuadPart = size;
+    file_mapping_ = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                       mapping_size.HighPart, mapping_size.LowPart, nullptr);
+    if (!file_mapping_) return false;
+    
+    mapping_ = MapViewOfFile(file_mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!mapping_) return false;
+    mapping_size_ = size;
+    return true;
+}
+
+void TimerStore::Unmap() {
+    if (mapping_) {
+        UnmapViewOfFile(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_mapping_) {
+        CloseHandle(file_mapping_);
+        file_mapping_ = nullptr;
+    }
+    if (file_) {
+        CloseHandle(file_);
+        file_ = nullptr;
+    }
+    mapping_size_ = 0;
+}
+
+void TimerStore::Flush() {
+    // Queues the dirty pages for writing; does not wait for the device
+    if (mapping_) {
+        FlushViewOfFile(mapping_, mapping_size_);
+    }
+}
+
+std::string TimerStore::DefaultPath() {
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) {
+        std::string exe(path, length);
+        auto slash = exe.find_last_of("\\/");
+        if (slash != std::string::npos) {
+            return exe.substr(0, slash + 1) + "timers.dat";
+        }
+    }
+    return "timers.dat";
+}
+
+#else
+
+bool TimerStore::Map(const std::string& path, size_t size, bool& created) {
+    file_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file_ < 0) return false;
+    
+    struct stat info;
+    if (fstat(file_, &info) != 0) return false;
+    created = info.st_size == 0;
+    if (static_cast<size_t>(info.st_size) != size) {
+        if (ftruncate(file_, static_cast<off_t>(size)) != 0) return false;
+        created = true;
+    }
+    
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+    if (mapping == MAP_FAILED) return false;
+    mapping_ = mapping;
+    mapping_size_ = size;
+    return true;
+}
+
+void TimerStore::Unmap() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+    if (file_ >= 0) {
+        close(file_);
+        file_ = -1;
+    }
+    mapping_size_ = 0;
+}
+
+void TimerStore::Flush() {
+    // Schedules write-back without waiting for it
+    if (mapping_) {
+        msync(mapping_, mapping_size_, MS_ASYNC);
+    }
+}
+
+std::string TimerStore::DefaultPath() {
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.timeapp_timers";
+    }
+    return "timeapp_timers.dat";
+}
+
+#endif
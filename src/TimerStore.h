@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Timer.h"
+#include <cstdint>
+#include <string>
+
+// Timer snapshots kept in a fixed-layout memory-mapped file, one slot per
+// timer. Each slot holds two checksummed copies; a write always goes to the
+// older one, so a crash part-way through leaves the previous copy intact.
+// Writes are plain stores into the mapping: the OS writes dirty pages back
+// even if the process dies, and Flush() only asks for an asynchronous
+// write-back, so nothing waits on the disk.
+class TimerStore {
+public:
+    TimerStore();
+    ~TimerStore();
+    
+    TimerStore(const TimerStore&) = delete;
+    TimerStore& operator=(const TimerStore&) = delete;
+    
+    // Maps `path`, creating it with `capacity` empty slots if needed. An
+    // existing file with a different layout or capacity is started afresh.
+    bool Open(const std::string& path, uint32_t capacity);
+    void Close();
+    
+    bool IsOpen() const { return slots_ != nullptr; }
+    uint32_t GetCapacity() const { return capacity_; }
+    
+    // Returns false if the slot was never written or both copies are damaged
+    bool Read(uint32_t slot, Timer::Snapshot& snapshot) const;
+    void Write(uint32_t slot, const Timer::Snapshot& snapshot);
+    void Clear(uint32_t slot);
+    
+    void Flush();
+    
+    // Default location: next to the executable on Windows, $HOME elsewhere
+    static std::string DefaultPath();
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t record_size;
+        uint32_t reserved[11];
+    };
+    
+    // On-disk snapshot; all times in nanoseconds
+    struct Record {
+        uint64_t sequence; // 0 = never written
+        uint8_t type;
+        uint8_t state;
+        uint8_t reserved[6];
+        int64_t accumulated;
+        int64_t duration;
+        int64_t anchor_steady;
+        int64_t anchor_wall;
+        uint64_t padding;  // keeps records cache-line sized
+        uint64_t checksum;
+    };
+    
+    struct Slot {
+        Record copies[2];
+    };
+    
+    static_assert(sizeof(Header) == 64, "TimerStore header layout changed");
+    static_assert(sizeof(Record) == 64, "TimerStore record layout changed");
+    
+    static uint64_t Checksum(const Record& record);
+    static bool IsValid(const Record& record);
+    
+    bool Map(const std::string& path, size_t size, bool& created);
+    void Unmap();
+    
+    static constexpr uint64_t MAGIC = 0x31524D5453504154ULL; // "TAPSTMR1"
+    static constexpr uint32_t VERSION = 1;
+    
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    Slot* slots_ = nullptr;
+    uint32_t capacity_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* file_mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
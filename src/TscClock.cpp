@@ -0,0 +1,186 @@
+#include "TscClock.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(TIMEAPP_HAS_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace {
+    constexpr auto CALIBRATION_PERIOD = std::chrono::milliseconds(20);
+    constexpr auto RECHECK_INTERVAL = std::chrono::seconds(1);
+    constexpr int SAMPLE_ATTEMPTS = 8;
+    
+    // Drift is slewed out over one recheck interval, but never faster than
+    // this; anything beyond STEP_THRESHOLD means the TSC jumped (VM
+    // migration, suspend) and the mapping is rebuilt instead.
+    constexpr double MAX_CORRECTION = 500e-6;
+    constexpr int64_t STEP_THRESHOLD_NS = 1000000;
+    
+    int64_t SteadyNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+TscClock::TscClock()
+    : available_(false)
+    , stop_(false) {
+    if (HasInvariantTsc()) {
+        Calibrate();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_.available = available_;
+        status_.frequency_hz = available_ ? 1e9 / ns_per_tick_ : 0.0;
+    }
+    
+    if (available_) {
+        thread_ = std::thread(&TscClock::Run, this);
+    }
+}
+
+TscClock::~TscClock() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+TscClock::Status TscClock::GetStatus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return status_;
+}
+
+bool TscClock::HasInvariantTsc() {
+#ifdef TIMEAPP_HAS_TSC
+    // CPUID.80000007H:EDX[8] - TSC runs at a constant rate in all P/C-states
+    unsigned int regs[4] = {};
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned int>(info[0]) < 0x80000007) return false;
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<unsigned int>(info[3]);
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+    __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    return (regs[3] & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+void TscClock::Sample(uint64_t& ticks, int64_t& steady_ns) {
+#ifdef TIMEAPP_HAS_TSC
+    // Bracket the steady_clock read with rdtscp and keep the tightest pair;
+    // rdtscp waits for earlier instructions, so the bracket is honest
+    ticks = 0;
+    steady_ns = 0;
+    uint64_t best_width = UINT64_MAX;
+    for (int i = 0; i < SAMPLE_ATTEMPTS; ++i) {
+        unsigned int aux;
+        uint64_t before = __rdtscp(&aux);
+        int64_t ns = SteadyNanoseconds();
+        uint64_t after = __rdtscp(&aux);
+        
+        if (after - before < best_width) {
+            best_width = after - before;
+            ticks = before + (after - before) / 2;
+            steady_ns = ns;
+        }
+    }
+#else
+    ticks = 0;
+    steady_ns = SteadyNanoseconds();
+#endif
+}
+
+uint64_t TscClock::ToMultiplier(double ns_per_tick) {
+    return static_cast<uint64_t>(std::llround(ns_per_tick * static_cast<double>(1ULL << SHIFT)));
+}
+
+void TscClock::Calibrate() {
+    uint64_t start_ticks, end_ticks;
+    int64_t start_ns, end_ns;
+    
+    Sample(start_ticks, start_ns);
+    std::this_thread::sleep_for(CALIBRATION_PERIOD);
+    Sample(end_ticks, end_ns);
+    
+    if (end_ticks <= start_ticks || end_ns <= start_ns) return;
+    
+    ns_per_tick_ = static_cast<double>(end_ns - start_ns) / static_cast<double>(end_ticks - start_ticks);
+    
+    // Anything outside 100 MHz - 10 GHz is not a usable TSC
+    if (ns_per_tick_ < 0.1 || ns_per_tick_ > 10.0) return;
+    
+    anchor_ticks_ = start_ticks;
+    anchor_ns_ = start_ns;
+    Publish(end_ticks, end_ns, ToMultiplier(ns_per_tick_));
+    available_ = true;
+}
+
+void TscClock::Publish(uint64_t base_ticks, int64_t base_ns, uint64_t multiplier) {
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    base_ticks_.store(base_ticks, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    multiplier_.store(multiplier, std::memory_order_relaxed);
+    
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void TscClock::Recheck() {
+    uint64_t ticks;
+    int64_t steady_ns;
+    Sample(ticks, steady_ns);
+    
+    int64_t predicted = ToNanoseconds(ticks);
+    int64_t error = predicted - steady_ns;
+    double correction = 0.0;
+    
+    if (ticks <= anchor_ticks_ || std::llabs(error) > STEP_THRESHOLD_NS) {
+        // Start over from here; readers may see one discontinuity
+        anchor_ticks_ = ticks;
+        anchor_ns_ = steady_ns;
+        Publish(ticks, steady_ns, ToMultiplier(ns_per_tick_));
+    } else {
+        // Refine the rate over the whole baseline, then rebase at the
+        // predicted time (so readings stay continuous) with a rate that
+        // lands back on steady_clock by the next check
+        ns_per_tick_ = static_cast<double>(steady_ns - anchor_ns_) / static_cast<double>(ticks - anchor_ticks_);
+        
+        auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(RECHECK_INTERVAL).count();
+        correction = std::clamp(-static_cast<double>(error) / static_cast<double>(interval),
+                                -MAX_CORRECTION, MAX_CORRECTION);
+        Publish(ticks, predicted, ToMultiplier(ns_per_tick_ * (1.0 + correction)));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_.frequency_hz = 1e9 / ns_per_tick_;
+    status_.last_error = std::chrono::nanoseconds{error};
+    status_.max_error = std::max(status_.max_error, std::chrono::nanoseconds{std::llabs(error)});
+    status_.correction_ppm = correction * 1e6;
+    ++status_.checks;
+}
+
+void TscClock::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (wake_.wait_for(lock, RECHECK_INTERVAL, [this]() { return stop_; })) {
+            break;
+        }
+        lock.unlock();
+        Recheck();
+        lock.lock();
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TIMEAPP_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Time source built on the invariant TSC. Ticks are mapped onto the
+// steady_clock timeline, so its time points mix freely with steady_clock
+// ones (TimerService deadlines, Timer anchors). Calibrated against
+// steady_clock at construction and re-checked by a background thread, which
+// slews the rate to absorb drift. Falls back to steady_clock when the CPU has
+// no invariant TSC.
+class TscClock {
+public:
+    struct Status {
+        bool available = false;
+        double frequency_hz = 0.0;
+        std::chrono::nanoseconds last_error{0}; // TSC time minus steady_clock at the last check
+        std::chrono::nanoseconds max_error{0};
+        double correction_ppm = 0.0;            // rate adjustment currently applied
+        uint64_t checks = 0;
+    };
+    
+    TscClock();
+    ~TscClock();
+    
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+    
+    bool IsAvailable() const { return available_; }
+    
+    std::chrono::steady_clock::time_point Now() const;
+    
+    Status GetStatus() const;
+
+private:
+    // Conversion: ns = base_ns + ((ticks - base_ticks) * multiplier) >> SHIFT
+    static constexpr int SHIFT = 32;
+    
+    static uint64_t ReadTicks();
+    static bool HasInvariantTsc();
+    static uint64_t MulShift(uint64_t ticks, uint64_t multiplier);
+    
+    // A (ticks, steady ns) pair taken as close together as possible
+    static void Sample(uint64_t& ticks, int64_t& steady_ns);
+    static uint64_t ToMultiplier(double ns_per_tick);
+    
+    void Calibrate();
+    void Recheck();
+    void Publish(uint64_t base_ticks, int64_t base_ns, uint64_t multiplier);
+    int64_t ToNanoseconds(uint64_t ticks) const;
+    void Run();
+    
+    bool available_;
+    
+    // First calibration sample; the rate estimate is refined against it as
+    // the baseline grows. Only touched by the constructor and thread_.
+    uint64_t anchor_ticks_ = 0;
+    int64_t anchor_ns_ = 0;
+    double ns_per_tick_ = 0.0;
+    
+    // Seqlock-published conversion parameters
+    std::atomic<uint32_t> sequence_{0};
+    std::atomic<uint64_t> base_ticks_{0};
+    std::atomic<int64_t> base_ns_{0};
+    std::atomic<uint64_t> multiplier_{0};
+    
+    mutable std::mutex mutex_;
+    Status status_;
+    std::condition_variable wake_;
+    bool stop_;
+    std::thread thread_;
+};
+
+inline uint64_t TscClock::ReadTicks() {
+#ifdef TIMEAPP_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+inline uint64_t TscClock::MulShift(uint64_t ticks, uint64_t multiplier) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(ticks, multiplier, &high);
+    return __shiftright128(low, high, SHIFT);
+#elif defined(__SIZEOF_INT128__)
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * multiplier) >> SHIFT);
+#else
+    // Split multiply for targets without 128-bit arithmetic
+    uint64_t high = (ticks >> 32) * multiplier;
+    uint64_t low = ((ticks & 0xFFFFFFFFULL) * multiplier) >> SHIFT;
+    return high + low;
+#endif
+}
+
+inline int64_t TscClock::ToNanoseconds(uint64_t ticks) const {
+    for (;;) {
+        uint32_t sequence = sequence_.load(std::memory_order_acquire);
+        uint64_t base_ticks = base_ticks_.load(std::memory_order_relaxed);
+        int64_t base_ns = base_ns_.load(std::memory_order_relaxed);
+        uint64_t multiplier = multiplier_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((sequence & 1) == 0 && sequence_.load(std::memory_order_relaxed) == sequence) {
+            // Readers may sample ticks slightly before a concurrent rebase
+            if (ticks >= base_ticks) {
+                return base_ns + static_cast<int64_t>(MulShift(ticks - base_ticks, multiplier));
+            }
+            return base_ns - static_cast<int64_t>(MulShift(base_ticks - ticks, multiplier));
+        }
+    }
+}
+
+inline std::chrono::steady_clock::time_point TscClock::Now() const {
+    if (!available_) {
+        return std::chrono::steady_clock::now();
+    }
+    auto ns = std::chrono::nanoseconds{ToNanoseconds(ReadTicks())};
+    return std::chrono::steady_clock::time_point{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(ns)};
+}
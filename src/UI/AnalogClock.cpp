@@ -0,0 +1,142 @@
+#include "AnalogClock.h"
+#include "imgui_internal.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    // Radii as fractions of the face radius
+    constexpr float RING_INNER = 0.95f;
+    constexpr float TICK_OUTER = 0.92f;
+    constexpr float TICK_MINOR = 0.86f;
+    constexpr float TICK_MAJOR = 0.80f;
+    constexpr float NUMERALS = 0.66f;
+    constexpr float HOUR_HAND = 0.50f;
+    constexpr float MINUTE_HAND = 0.76f;
+    constexpr float SECOND_HAND = 0.84f;
+    constexpr float HAND_TAIL = 0.12f;
+    
+    // Unit vector for a fraction of a turn, clockwise from 12 o'clock
+    ImVec2 Direction(float turns) {
+        float angle = turns * 2.0f * IM_PI;
+        return ImVec2(std::sin(angle), -std::cos(angle));
+    }
+    
+    ImVec2 Along(const ImVec2& center, const ImVec2& dir, float length) {
+        return ImVec2(center.x + dir.x * length, center.y + dir.y * length);
+    }
+    
+    ImVec2 Fraction(const ImVec2& point) {
+        return ImVec2(point.x - ImTrunc(point.x), point.y - ImTrunc(point.y));
+    }
+    
+    // Tapered hand from behind the center to the tip, wound clockwise on
+    // screen as ImGui's anti-aliased fill expects
+    void AddHand(ImDrawList* list, const ImVec2& center, const ImVec2& dir, float length, float tail,
+                 float base_width, float tip_width, ImU32 color) {
+        ImVec2 side(-dir.y, dir.x);
+        ImVec2 back = Along(center, dir, -tail);
+        ImVec2 tip = Along(center, dir, length);
+        list->AddQuadFilled(Along(back, side, -base_width * 0.5f), Along(tip, side, -tip_width * 0.5f),
+                            Along(tip, side, tip_width * 0.5f), Along(back, side, base_width * 0.5f), color);
+    }
+}
+
+bool AnalogClock::Look::operator==(const Look& other) const {
+    return diameter == other.diameter && dial == other.dial && ring == other.ring && tick == other.tick &&
+           numeral == other.numeral && font == other.font && font_size == other.font_size &&
+           atlas_id == other.atlas_id && fraction.x == other.fraction.x && fraction.y == other.fraction.y;
+}
+
+AnalogClock::Look AnalogClock::CurrentLook(float diameter, const ImVec2& center) const {
+    ImGuiContext& g = *GImGui;
+    Look look;
+    look.diameter = diameter;
+    look.dial = ImGui::GetColorU32(ImGuiCol_FrameBg);
+    look.ring = ImGui::GetColorU32(ImGuiCol_Text);
+    look.tick = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+    look.numeral = ImGui::GetColorU32(ImGuiCol_Text);
+    look.font = g.Font;
+    look.font_size = g.FontSize;
+    look.atlas_id = g.IO.Fonts->TexData ? g.IO.Fonts->TexData->UniqueID : 0;
+    look.fraction = Fraction(center);
+    return look;
+}
+
+void AnalogClock::Render(const TimeFields& time, float diameter, bool sweep) {
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems) return;
+    
+    const ImVec2 pos = window->DC.CursorPos;
+    const ImRect bb(pos.x, pos.y, pos.x + diameter, pos.y + diameter);
+    ImGui::ItemSize(ImVec2(diameter, diameter));
+    if (!ImGui::ItemAdd(bb, 0)) return;
+    
+    ImDrawList* list = window->DrawList;
+    const float radius = diameter * 0.5f;
+    const ImVec2 center(pos.x + radius, pos.y + radius);
+    const Look look = CurrentLook(diameter, center);
+    
+    if (cached_ && face_.IsCaptured() && face_look_ == look) {
+        face_.Replay(list, center);
+        stats_.face_vertices = face_.GetVertexCount();
+    } else {
+        const int face_begin = list->VtxBuffer.Size;
+        if (cached_) {
+            face_.Capture(list, center, bb.Min, bb.Max, [&]() { DrawFace(list, center, look); });
+            face_look_ = look;
+        } else {
+            DrawFace(list, center, look);
+        }
+        ++stats_.face_builds;
+        stats_.face_vertices = list->VtxBuffer.Size - face_begin;
+    }
+    
+    const int hands_begin = list->VtxBuffer.Size;
+    DrawHands(list, center, radius, time, sweep);
+    stats_.hand_vertices = list->VtxBuffer.Size - hands_begin;
+}
+
+void AnalogClock::DrawFace(ImDrawList* list, const ImVec2& center, const Look& look) {
+    const float radius = look.diameter * 0.5f;
+    list->AddCircleFilled(center, radius - 1.0f, look.dial);
+    list->AddCircle(center, radius - 1.0f, look.ring, 0, 2.0f);
+    list->AddCircle(center, radius * RING_INNER, look.tick, 0, 1.0f);
+    
+    for (int tick = 0; tick < 60; ++tick) {
+        bool major = tick % 5 == 0;
+        ImVec2 dir = Direction(tick / 60.0f);
+        list->AddLine(Along(center, dir, radius * (major ? TICK_MAJOR : TICK_MINOR)),
+                      Along(center, dir, radius * TICK_OUTER),
+                      major ? look.numeral : look.tick, major ? 2.5f : 1.0f);
+    }
+    
+    ImFont* font = ImGui::GetFont();
+    for (int hour = 1; hour <= 12; ++hour) {
+        char text[3];
+        snprintf(text, sizeof(text), "%d", hour);
+        ImVec2 size = font->CalcTextSizeA(look.font_size, FLT_MAX, 0.0f, text);
+        ImVec2 at = Along(center, Direction(hour / 12.0f), radius * NUMERALS);
+        list->AddText(font, look.font_size, ImVec2(at.x - size.x * 0.5f, at.y - size.y * 0.5f), look.numeral, text);
+    }
+}
+
+void AnalogClock::DrawHands(ImDrawList* list, const ImVec2& center, float radius, const TimeFields& time,
+                            bool sweep) {
+    float seconds = static_cast<float>(time.seconds);
+    if (sweep) seconds += time.nanoseconds / 1e9f;
+    float minutes = time.minutes + seconds / 60.0f;
+    float hours = static_cast<float>(time.hours % 12) + minutes / 60.0f;
+    
+    const ImU32 hand = ImGui::GetColorU32(ImGuiCol_Text);
+    const ImU32 second_hand = ImGui::GetColorU32(ImGuiCol_CheckMark);
+    AddHand(list, center, Direction(hours / 12.0f), radius * HOUR_HAND, radius * HAND_TAIL,
+            radius * 0.07f, radius * 0.035f, hand);
+    AddHand(list, center, Direction(minutes / 60.0f), radius * MINUTE_HAND, radius * HAND_TAIL,
+            radius * 0.05f, radius * 0.025f, hand);
+    
+    ImVec2 dir = Direction(seconds / 60.0f);
+    list->AddLine(Along(center, dir, -radius * HAND_TAIL * 1.5f), Along(center, dir, radius * SECOND_HAND),
+                  second_hand, 1.5f);
+    list->AddCircleFilled(center, ImMax(2.5f, radius * 0.04f), second_hand, 12);
+}
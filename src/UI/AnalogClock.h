@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../TimeFormat.h"
+#include "GeometryCache.h"
+#include "imgui.h"
+#include <cstdint>
+
+// Analog clock face as a single ImGui item. The dial, rings, 60 ticks and
+// the numerals are tessellated by the ImDrawList primitives once per size
+// and look, and the captured triangles are copied in, translated, on later
+// frames. Only the three hands and the center cap are generated each
+// frame: two quads, a line and a small disc, rotated with sub-pixel
+// precision.
+class AnalogClock {
+public:
+    struct Stats {
+        uint64_t face_builds = 0;
+        int face_vertices = 0;   // in the last face drawn, built or replayed
+        int hand_vertices = 0;   // generated for the hands last frame
+    };
+    
+    // Draws at the cursor; `sweep` moves the second hand continuously
+    // instead of ticking
+    void Render(const TimeFields& time, float diameter, bool sweep);
+    
+    // Uncached, the face is tessellated every frame (for A/B measurements)
+    void SetCached(bool cached) { cached_ = cached; }
+    bool IsCached() const { return cached_; }
+    
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    struct Look {
+        float diameter = 0.0f;
+        ImU32 dial = 0, ring = 0, tick = 0, numeral = 0;
+        const ImFont* font = nullptr;
+        float font_size = 0.0f;
+        int atlas_id = -1;
+        ImVec2 fraction;         // sub-pixel part of the center; numerals snap to pixels
+        
+        bool operator==(const Look& other) const;
+    };
+    
+    Look CurrentLook(float diameter, const ImVec2& center) const;
+    void DrawFace(ImDrawList* list, const ImVec2& center, const Look& look);
+    void DrawHands(ImDrawList* list, const ImVec2& center, float radius, const TimeFields& time, bool sweep);
+    
+    CapturedGeometry face_;      // relative to the center
+    Look face_look_;
+    
+    Stats stats_;
+    bool cached_ = true;
+};
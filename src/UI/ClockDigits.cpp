@@ -0,0 +1,201 @@
+#include "ClockDigits.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Digits first; they share the widest digit's advance
+    const char CHARSET[] = "0123456789:.- ";
+    constexpr int DIGITS = 10;
+    
+    // Advances past a UTF-8 sequence
+    ImWchar NextChar(const char*& s, const char* end) {
+        unsigned int c = static_cast<unsigned char>(*s);
+        if (c < 0x80) {
+            ++s;
+        } else {
+            s += ImTextCharFromUtf8(&c, s, end);
+        }
+        return static_cast<ImWchar>(c);
+    }
+    
+    int CharsetIndex(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        switch (c) {
+            case ':': return 10;
+            case '.': return 11;
+            case '-': return 12;
+            case ' ': return 13;
+            default: return -1;
+        }
+    }
+    
+    void WriteQuad(ImDrawVert* vtx, ImDrawIdx* idx, unsigned int base, const ImVec2& min, const ImVec2& max,
+                   const ImVec2& uv_min, const ImVec2& uv_max, ImU32 color) {
+        const ImVec2 corners[4] = {min, ImVec2(max.x, min.y), max, ImVec2(min.x, max.y)};
+        const ImVec2 uvs[4] = {uv_min, ImVec2(uv_max.x, uv_min.y), uv_max, ImVec2(uv_min.x, uv_max.y)};
+        for (int i = 0; i < 4; ++i) {
+            vtx[i].pos = corners[i];
+            vtx[i].uv = uvs[i];
+            vtx[i].col = color;
+        }
+        idx[0] = static_cast<ImDrawIdx>(base);
+        idx[1] = static_cast<ImDrawIdx>(base + 1);
+        idx[2] = static_cast<ImDrawIdx>(base + 2);
+        idx[3] = static_cast<ImDrawIdx>(base);
+        idx[4] = static_cast<ImDrawIdx>(base + 2);
+        idx[5] = static_cast<ImDrawIdx>(base + 3);
+    }
+}
+
+static_assert(sizeof(CHARSET) - 1 == 14, "charset matches CHARSET_SIZE");
+
+void ClockDigits::Text(float scale, const char* text) {
+    if (!enabled_) {
+        ImGui::SetWindowFontScale(scale);
+        ImGui::TextUnformatted(text);
+        ImGui::SetWindowFontScale(1.0f);
+        return;
+    }
+    Draw(scale, ImGui::GetColorU32(ImGuiCol_Text), text);
+}
+
+void ClockDigits::TextColored(float scale, const ImVec4& color, const char* text) {
+    if (!enabled_) {
+        ImGui::SetWindowFontScale(scale);
+        ImGui::TextColored(color, "%s", text);
+        ImGui::SetWindowFontScale(1.0f);
+        return;
+    }
+    Draw(scale, ImGui::GetColorU32(color), text);
+}
+
+ClockDigits::Face& ClockDigits::GetFace(float size) {
+    ImGuiContext& g = *GImGui;
+    for (Face& face : faces_) {
+        if (face.size == size && face.font == g.Font) return face;
+    }
+    faces_.emplace_back();
+    faces_.back().size = size;
+    faces_.back().font = g.Font;
+    return faces_.back();
+}
+
+void ClockDigits::Refresh(Face& face, ImFontBaked* baked) {
+    // Looking a glyph up bakes it if it is missing, so the whole charset
+    // lands in the atlas in one go. Baking can grow and repack the atlas,
+    // moving glyphs baked before, so nothing is read until all are in.
+    for (int i = 0; i < CHARSET_SIZE; ++i) {
+        baked->FindGlyph(static_cast<ImWchar>(CHARSET[i]));
+    }
+    
+    float digit_advance = 0.0f;
+    for (int i = 0; i < DIGITS; ++i) {
+        digit_advance = std::max(digit_advance, baked->FindGlyph(static_cast<ImWchar>(CHARSET[i]))->AdvanceX);
+    }
+    for (int i = 0; i < CHARSET_SIZE; ++i) {
+        const ImFontGlyph& source = *baked->FindGlyph(static_cast<ImWchar>(CHARSET[i]));
+        Glyph& glyph = face.glyphs[i];
+        glyph.advance = i < DIGITS ? digit_advance : source.AdvanceX;
+        float offset = ImTrunc((glyph.advance - source.AdvanceX) * 0.5f);
+        glyph.min = ImVec2(source.X0 + offset, source.Y0);
+        glyph.max = ImVec2(source.X1 + offset, source.Y1);
+        glyph.uv_min = ImVec2(source.U0, source.V0);
+        glyph.uv_max = ImVec2(source.U1, source.V1);
+        glyph.visible = source.Visible;
+    }
+    
+    ImTextureData* atlas = GImGui->IO.Fonts->TexData;
+    face.baked = baked;
+    face.atlas_id = atlas ? atlas->UniqueID : 0;
+    ++refreshes_;
+}
+
+void ClockDigits::Draw(float scale, ImU32 color, const char* text) {
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems) return;
+    
+    // Same size SetWindowFontScale would pick
+    ImGuiContext& g = *GImGui;
+    const float size = ImClamp(ImGui::GetRoundedFontSize(g.FontSize * scale), 1.0f, IMGUI_FONT_SIZE_MAX);
+    Face& face = GetFace(size);
+    ImFontBaked* baked = g.Font->GetFontBaked(size);
+    
+    // Other characters are baked before the atlas is checked: a new glyph
+    // can grow and repack the atlas, which moves the charset's glyphs too
+    const char* end = text + std::strlen(text);
+    for (const char* s = text; s < end;) {
+        if (CharsetIndex(*s) >= 0) {
+            ++s;
+        } else {
+            baked->FindGlyph(NextChar(s, end));
+        }
+    }
+    
+    ImTextureData* atlas = g.IO.Fonts->TexData;
+    if (baked != face.baked || (atlas ? atlas->UniqueID : 0) != face.atlas_id) {
+        Refresh(face, baked);
+    }
+    
+    // Width first: the layout is the sum of fixed advances
+    int quads = 0;
+    float width = 0.0f;
+    for (const char* s = text; s < end; ++quads) {
+        int index = CharsetIndex(*s);
+        width += index >= 0 ? face.glyphs[index].advance : baked->FindGlyph(NextChar(s, end))->AdvanceX;
+        if (index >= 0) ++s;
+    }
+    
+    // Same layout as ImGui::TextEx
+    const ImVec2 item_size(width, size);
+    const ImVec2 pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+    const ImRect bb(pos.x, pos.y, pos.x + item_size.x, pos.y + item_size.y);
+    ImGui::ItemSize(item_size, 0.0f);
+    if (!ImGui::ItemAdd(bb, 0)) return;
+    if ((color & IM_COL32_A_MASK) == 0 || quads == 0) return;
+    
+    ImDrawList* list = window->DrawList;
+    const int vtx_max = quads * 4;
+    const int idx_max = quads * 6;
+    list->PrimReserve(idx_max, vtx_max);
+    ImDrawVert* vtx = list->_VtxWritePtr;
+    ImDrawIdx* idx = list->_IdxWritePtr;
+    unsigned int base = list->_VtxCurrentIdx;
+    
+    const ImVec4& clip = list->_CmdHeader.ClipRect;
+    float x = ImTrunc(pos.x);
+    const float y = ImTrunc(pos.y);
+    for (const char* s = text; s < end;) {
+        int index = CharsetIndex(*s);
+        if (index >= 0) {
+            const Glyph& glyph = face.glyphs[index];
+            if (glyph.visible && x + glyph.min.x <= clip.z && x + glyph.max.x >= clip.x) {
+                WriteQuad(vtx, idx, base, ImVec2(x + glyph.min.x, y + glyph.min.y), ImVec2(x + glyph.max.x, y + glyph.max.y),
+                          glyph.uv_min, glyph.uv_max, color);
+                vtx += 4;
+                idx += 6;
+                base += 4;
+            }
+            x += glyph.advance;
+            ++s;
+        } else {
+            const ImFontGlyph* glyph = baked->FindGlyph(NextChar(s, end));
+            if (glyph->Visible && x + glyph->X0 <= clip.z && x + glyph->X1 >= clip.x) {
+                WriteQuad(vtx, idx, base, ImVec2(x + glyph->X0, y + glyph->Y0), ImVec2(x + glyph->X1, y + glyph->Y1),
+                          ImVec2(glyph->U0, glyph->V0), ImVec2(glyph->U1, glyph->V1),
+                          glyph->Colored ? (color | ~IM_COL32_A_MASK) : color);
+                vtx += 4;
+                idx += 6;
+                base += 4;
+            }
+            x += glyph->AdvanceX;
+        }
+    }
+    
+    const int vtx_written = static_cast<int>(vtx - list->_VtxWritePtr);
+    const int idx_written = static_cast<int>(idx - list->_IdxWritePtr);
+    list->_VtxWritePtr = vtx;
+    list->_IdxWritePtr = idx;
+    list->_VtxCurrentIdx = base;
+    list->PrimUnreserve(idx_max - idx_written, vtx_max - vtx_written);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "imgui.h"
+#include <cstdint>
+#include <vector>
+
+// Large clock readouts without SetWindowFontScale. The characters a time
+// can contain (0-9 : . - and space) are baked into the font atlas at the
+// exact display size the first time that size is drawn, all at once, rather
+// than glyph by glyph as new digits show up. Digits share one advance, the
+// widest, so a running clock never shifts sideways even with a
+// proportional font.
+//
+// Each size keeps its glyph quads laid out relative to the pen; drawing a
+// string writes them straight into the window's draw list. Glyph data is
+// refetched only when the atlas texture is rebuilt. Other characters (e.g.
+// a phase name in front of the time) are looked up through the font as
+// usual.
+class ClockDigits {
+public:
+    // Scale is relative to the current font size, as for SetWindowFontScale
+    void Text(float scale, const char* text);
+    void TextColored(float scale, const ImVec4& color, const char* text);
+    
+    // Disabled, draws with SetWindowFontScale as before (for A/B measurements)
+    void SetEnabled(bool enabled) { enabled_ = enabled; }
+    bool IsEnabled() const { return enabled_; }
+    
+    // Times glyph data was fetched from the atlas, over all sizes
+    uint64_t GetRefreshCount() const { return refreshes_; }
+
+private:
+    static constexpr int CHARSET_SIZE = 14;
+    
+    struct Glyph {
+        ImVec2 min, max;   // quad relative to the pen, in pixels
+        ImVec2 uv_min, uv_max;
+        float advance = 0.0f;
+        bool visible = false;
+    };
+    
+    struct Face {
+        float size = 0.0f;
+        const ImFont* font = nullptr;
+        ImFontBaked* baked = nullptr;
+        int atlas_id = -1;
+        Glyph glyphs[CHARSET_SIZE];
+    };
+    
+    Face& GetFace(float size);
+    void Refresh(Face& face, ImFontBaked* baked);
+    void Draw(float scale, ImU32 color, const char* text);
+    
+    std::vector<Face> faces_;
+    uint64_t refreshes_ = 0;
+    bool enabled_ = true;
+};
@@ -0,0 +1,139 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // The waitable object is signalled within a refresh or two; a lost
+    // device must not hang the UI thread
+    constexpr DWORD MAX_FRAME_WAIT_MS = 1000;
+    
+    constexpr auto LOG_INTERVAL = std::chrono::seconds(10);
+    
+    double ToMilliseconds(std::chrono::nanoseconds value) {
+        return value.count() / 1e6;
+    }
+}
+
+void FramePacer::Latency::Add(std::chrono::nanoseconds value) {
+    last = value;
+    max = std::max(max, value);
+    total += value;
+    ++count;
+}
+
+FramePacer::FramePacer()
+    : swap_chain_(nullptr)
+    , waitable_(nullptr)
+    , qpc_frequency_(0)
+    , pending_next_(0)
+    , last_log_(Clock::now()) {
+}
+
+FramePacer::~FramePacer() {
+    Detach();
+}
+
+bool FramePacer::Attach(IDXGISwapChain1* swap_chain) {
+    Detach();
+    
+    IDXGISwapChain2* swap_chain2 = nullptr;
+    if (!swap_chain || swap_chain->QueryInterface(__uuidof(IDXGISwapChain2), (void**)&swap_chain2) != S_OK) {
+        return false;
+    }
+    
+    // One queued frame: Present() never runs more than a refresh ahead of scanout
+    swap_chain2->SetMaximumFrameLatency(1);
+    waitable_ = swap_chain2->GetFrameLatencyWaitableObject();
+    swap_chain2->Release();
+    
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    qpc_frequency_ = frequency.QuadPart;
+    
+    swap_chain_ = swap_chain;
+    return waitable_ != nullptr;
+}
+
+void FramePacer::Detach() {
+    if (waitable_) {
+        CloseHandle(waitable_);
+        waitable_ = nullptr;
+    }
+    swap_chain_ = nullptr;
+    for (Pending& pending : pending_) {
+        pending.waiting = false;
+    }
+}
+
+FramePacer::Clock::time_point FramePacer::WaitForFrame() {
+    auto start = Clock::now();
+    if (waitable_) {
+        WaitForSingleObjectEx(waitable_, MAX_FRAME_WAIT_MS, TRUE);
+    }
+    
+    // Everything the frame shows is sampled from here on
+    sample_ = Clock::now();
+    stats_.wait.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(sample_ - start));
+    return sample_;
+}
+
+void FramePacer::Presented() {
+    auto now = Clock::now();
+    stats_.sample_to_present.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sample_));
+    if (!swap_chain_) return;
+    
+    UINT present_count;
+    if (swap_chain_->GetLastPresentCount(&present_count) == S_OK) {
+        Pending& pending = pending_[pending_next_++ % PENDING_FRAMES];
+        pending.present_count = present_count;
+        pending.sample = sample_;
+        pending.waiting = true;
+    }
+    
+    CollectScanouts();
+    
+    if (now - last_log_ >= LOG_INTERVAL) {
+        Log(now);
+    }
+}
+
+void FramePacer::CollectScanouts() {
+    // Describes the most recent present that reached the screen, with the
+    // QPC time of the vblank it was shown at. Fails until the first one has.
+    DXGI_FRAME_STATISTICS statistics;
+    if (swap_chain_->GetFrameStatistics(&statistics) != S_OK) return;
+    
+    auto scanout = QpcToSteady(statistics.SyncQPCTime.QuadPart);
+    for (Pending& pending : pending_) {
+        if (!pending.waiting) continue;
+        
+        // Older presents were replaced before we looked; newer ones are still queued
+        int32_t age = static_cast<int32_t>(statistics.PresentCount - pending.present_count);
+        if (age == 0) {
+            stats_.sample_to_scanout.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(scanout - pending.sample));
+            pending.waiting = false;
+        } else if (age > 0) {
+            pending.waiting = false;
+        }
+    }
+}
+
+FramePacer::Clock::time_point FramePacer::QpcToSteady(LONGLONG qpc) const {
+    LARGE_INTEGER now_qpc;
+    QueryPerformanceCounter(&now_qpc);
+    auto now = Clock::now();
+    
+    double seconds_ago = static_cast<double>(now_qpc.QuadPart - qpc) / static_cast<double>(qpc_frequency_);
+    return now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds_ago));
+}
+
+void FramePacer::Log(Clock::time_point now) {
+    last_log_ = now;
+    std::cout << "Frame timing: " << stats_.sample_to_present.count << " frames"
+              << ", sample->present mean " << ToMilliseconds(stats_.sample_to_present.Mean())
+              << " ms, max " << ToMilliseconds(stats_.sample_to_present.max) << " ms"
+              << ", sample->scanout mean " << ToMilliseconds(stats_.sample_to_scanout.Mean())
+              << " ms, max " << ToMilliseconds(stats_.sample_to_scanout.max) << " ms"
+              << " (" << stats_.sample_to_scanout.count << " matched)"
+              << ", waited mean " << ToMilliseconds(stats_.wait.Mean()) << " ms" << std::endl;
+}
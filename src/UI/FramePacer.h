@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../WindowsHeaders.h"
+#include <chrono>
+#include <cstdint>
+
+// Keeps at most one frame queued on a flip-model swap chain and measures how
+// stale the displayed time is. WaitForFrame() blocks on the swap chain's
+// frame latency waitable object, so the frame that follows samples the clock
+// only once the GPU can take it, instead of building frames that then sit in
+// the present queue for several vblanks.
+//
+// Each frame is timed from its clock sample to Present() returning and, via
+// the swap chain's frame statistics, to the vblank it was scanned out at.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Latency {
+        std::chrono::nanoseconds last{0};
+        std::chrono::nanoseconds max{0};
+        std::chrono::nanoseconds total{0};
+        uint64_t count = 0;
+        
+        std::chrono::nanoseconds Mean() const {
+            return count ? total / static_cast<int64_t>(count) : std::chrono::nanoseconds{0};
+        }
+        void Add(std::chrono::nanoseconds value);
+    };
+    
+    struct Stats {
+        Latency wait;               // blocked in WaitForFrame()
+        Latency sample_to_present;  // clock sample to Present() returning
+        Latency sample_to_scanout;  // clock sample to the vblank that showed it
+    };
+    
+    FramePacer();
+    ~FramePacer();
+    
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+    
+    // Sets a maximum frame latency of 1. The swap chain must be flip model and
+    // created with DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT; returns
+    // false (and paces nothing) otherwise.
+    bool Attach(IDXGISwapChain1* swap_chain);
+    void Detach();
+    
+    // Call before building a frame; returns the time the frame samples
+    Clock::time_point WaitForFrame();
+    
+    // Call right after Present()
+    void Presented();
+    
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    static constexpr size_t PENDING_FRAMES = 8;
+    
+    struct Pending {
+        UINT present_count = 0;
+        Clock::time_point sample;
+        bool waiting = false;
+    };
+    
+    void CollectScanouts();
+    Clock::time_point QpcToSteady(LONGLONG qpc) const;
+    void Log(Clock::time_point now);
+    
+    IDXGISwapChain1* swap_chain_;
+    HANDLE waitable_;
+    LONGLONG qpc_frequency_;
+    
+    Clock::time_point sample_;
+    Pending pending_[PENDING_FRAMES];
+    size_t pending_next_;
+    
+    Stats stats_;
+    Clock::time_point last_log_;
+};
@@ -0,0 +1,141 @@
+#include "FrameProfiler.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+namespace {
+    const char* const PHASE_NAMES[] = {
+        "Messages",
+        "Frame wait",
+        "NewFrame",
+        "Time display",
+        "NTP controls",
+        "Stopwatch",
+        "Countdown",
+        "Intervals",
+        "World clock",
+        "Alarms",
+        "Timers",
+        "Status bar",
+        "ImGui::Render",
+        "Submit",
+        "Present",
+        "Frame CPU total"
+    };
+    static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == FrameProfiler::PHASE_COUNT + 1,
+                  "one name per phase plus the total");
+    
+    constexpr int HISTOGRAM_BINS = 32;
+}
+
+FrameProfiler::FrameProfiler(const TscClock* clock)
+    : clock_(clock) {
+}
+
+void FrameProfiler::EndFrame() {
+    std::array<float, COLUMNS>& row = samples_[next_];
+    float total = 0.0f;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        float us = std::chrono::duration<float, std::micro>(current_[phase]).count();
+        row[phase] = us;
+        if (phase != FrameWait) total += us;
+        current_[phase] = std::chrono::steady_clock::duration::zero();
+    }
+    row[TOTAL] = total;
+    
+    next_ = (next_ + 1) % HISTORY;
+    count_ = std::min(count_ + 1, HISTORY);
+}
+
+void FrameProfiler::DiscardFrame() {
+    current_.fill(std::chrono::steady_clock::duration::zero());
+}
+
+float FrameProfiler::Sample(int column, int age) const {
+    int oldest = count_ < HISTORY ? 0 : next_;
+    return samples_[(oldest + age) % HISTORY][column];
+}
+
+FrameProfiler::Summary FrameProfiler::Summarize(int column) const {
+    Summary summary;
+    if (count_ == 0) return summary;
+    
+    std::array<float, HISTORY> values;
+    for (int i = 0; i < count_; ++i) values[i] = Sample(column, i);
+    summary.last = values[count_ - 1];
+    
+    auto at = [&](int rank) {
+        std::nth_element(values.begin(), values.begin() + rank, values.begin() + count_);
+        return values[rank];
+    };
+    summary.p50 = at(count_ / 2);
+    summary.p99 = at(std::min(count_ - 1, count_ * 99 / 100));
+    summary.max = *std::max_element(values.begin(), values.begin() + count_);
+    return summary;
+}
+
+const char* FrameProfiler::GetPhaseName(int column) {
+    return column >= 0 && column <= TOTAL ? PHASE_NAMES[column] : "?";
+}
+
+void FrameProfiler::RenderOverlay(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+    
+    Summary selected = Summarize(selected_);
+    ImGui::Text("%s over the last %d frames", GetPhaseName(selected_), count_);
+    
+    if (count_ > 0) {
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "p50 %.1f  p99 %.1f  max %.1f us", selected.p50, selected.p99, selected.max);
+        struct Series {
+            const FrameProfiler* profiler;
+            int column;
+        } series = {this, selected_};
+        ImGui::PlotLines("##graph", [](void* data, int index) {
+            const Series* s = static_cast<const Series*>(data);
+            return s->profiler->Sample(s->column, index);
+        }, &series, count_, 0, overlay, 0.0f, selected.max * 1.1f, ImVec2(-1, 80));
+        
+        // Distribution of the same samples, 0..max
+        float bins[HISTOGRAM_BINS] = {};
+        float width = selected.max > 0.0f ? selected.max / HISTOGRAM_BINS : 1.0f;
+        for (int i = 0; i < count_; ++i) {
+            int bin = static_cast<int>(Sample(selected_, i) / width);
+            bins[std::min(bin, HISTOGRAM_BINS - 1)] += 1.0f;
+        }
+        ImGui::PlotHistogram("##histogram", bins, HISTOGRAM_BINS, 0, "distribution", 0.0f, FLT_MAX, ImVec2(-1, 60));
+    }
+    
+    if (ImGui::BeginTable("Phases", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Phase (us)");
+        ImGui::TableSetupColumn("Last");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("Max");
+        ImGui::TableHeadersRow();
+        
+        for (int column = 0; column < COLUMNS; ++column) {
+            Summary summary = Summarize(column);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (ImGui::Selectable(GetPhaseName(column), selected_ == column, ImGuiSelectableFlags_SpanAllColumns)) {
+                selected_ = column;
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", summary.last);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", summary.p50);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", summary.p99);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", summary.max);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
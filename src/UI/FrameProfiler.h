@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../TscClock.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// CPU time per frame, split by phase, for the last HISTORY frames. The UI
+// thread brackets each phase with PROFILE_SCOPE; the totals of a frame go
+// into a fixed ring when it ends, and the overlay shows them as a graph,
+// a histogram and p50/p99/max per phase.
+//
+// Built without ENABLE_PROFILER the PROFILE_* macros expand to nothing.
+// Enabled, a scope costs two clock reads and an add. UI thread only.
+class FrameProfiler {
+public:
+    enum Phase {
+        Messages,
+        FrameWait,   // blocked on the swap chain, not CPU time
+        NewFrame,
+        TimeDisplay,
+        NTPControls,
+        Stopwatch,
+        Countdown,
+        Intervals,
+        WorldClock,
+        Alarms,
+        Timers,
+        StatusBar,
+        ImGuiRender,
+        Submit,
+        Present,
+        PHASE_COUNT
+    };
+    
+    static constexpr int HISTORY = 240;
+    static constexpr int TOTAL = PHASE_COUNT; // column holding the frame's CPU total
+    
+    struct Summary {
+        float last = 0.0f;  // microseconds
+        float p50 = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+    };
+    
+    class Scope {
+    public:
+        Scope(FrameProfiler* profiler, Phase phase)
+            : profiler_(profiler)
+            , phase_(phase) {
+            if (profiler_) start_ = profiler_->Now();
+        }
+        ~Scope() {
+            if (profiler_) profiler_->Add(phase_, profiler_->Now() - start_);
+        }
+        
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    
+    private:
+        FrameProfiler* profiler_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+    };
+    
+    explicit FrameProfiler(const TscClock* clock = nullptr);
+    
+    // Phases accumulate until the frame ends: EndFrame() commits them to the
+    // ring, DiscardFrame() drops them when nothing was drawn
+    void EndFrame();
+    void DiscardFrame();
+    
+    void Add(Phase phase, std::chrono::steady_clock::duration time) {
+        current_[phase] += time;
+    }
+    
+    // Over the frames in the ring; column is a Phase or TOTAL
+    Summary Summarize(int column) const;
+    int GetFrameCount() const { return count_; }
+    
+    static const char* GetPhaseName(int column);
+    
+    // ImGui window with the graph and the per-phase table
+    void RenderOverlay(bool* open);
+
+private:
+    static constexpr int COLUMNS = PHASE_COUNT + 1;
+    
+    std::chrono::steady_clock::time_point Now() const {
+        return clock_ ? clock_->Now() : std::chrono::steady_clock::now();
+    }
+    
+    // Oldest first
+    float Sample(int column, int age) const;
+    
+    const TscClock* const clock_;
+    std::array<std::chrono::steady_clock::duration, PHASE_COUNT> current_{};
+    std::array<std::array<float, COLUMNS>, HISTORY> samples_{};
+    int next_ = 0;
+    int count_ = 0;
+    int selected_ = TOTAL;
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(profiler, phase) \
+    FrameProfiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)((profiler), FrameProfiler::phase)
+#define PROFILE_END_FRAME(profiler) (profiler)->EndFrame()
+#define PROFILE_DISCARD_FRAME(profiler) (profiler)->DiscardFrame()
+#else
+#define PROFILE_SCOPE(profiler, phase)
+#define PROFILE_END_FRAME(profiler)
+#define PROFILE_DISCARD_FRAME(profiler)
+#endif
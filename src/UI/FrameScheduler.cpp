@@ -0,0 +1,121 @@
+#include "FrameScheduler.h"
+#include <algorithm>
+
+// Windows 10 1803+; older systems fall back to a millisecond timeout
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace {
+    constexpr auto RATE_WINDOW = std::chrono::seconds(1);
+    
+    // Kernel plus user time of the whole process, in 100 ns units
+    uint64_t ProcessCpuTime() {
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+            return 0;
+        }
+        uint64_t kernel_time = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+        uint64_t user_time = (static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+        return kernel_time + user_time;
+    }
+}
+
+FrameScheduler::FrameScheduler()
+    : wake_event_(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+    , timer_(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+    , pending_frames_(1)
+    , next_frame_(Clock::time_point::max())
+    , woken_(false)
+    , window_start_(Clock::now())
+    , window_wakeups_(0)
+    , window_frames_(0)
+    , window_cpu_(ProcessCpuTime()) {
+}
+
+FrameScheduler::~FrameScheduler() {
+    if (timer_) CloseHandle(timer_);
+    if (wake_event_) CloseHandle(wake_event_);
+}
+
+void FrameScheduler::Wake() {
+    woken_.store(true, std::memory_order_release);
+    SetEvent(wake_event_);
+}
+
+void FrameScheduler::RequestFrames(int count) {
+    pending_frames_ = std::max(pending_frames_, count);
+}
+
+void FrameScheduler::RequestFrameAt(Clock::time_point when) {
+    next_frame_ = std::min(next_frame_, when);
+}
+
+void FrameScheduler::Wait() {
+    if (pending_frames_ > 0) return;
+    
+    auto now = Clock::now();
+    if (now >= next_frame_) return;
+    
+    HANDLE handles[2] = { wake_event_, nullptr };
+    DWORD count = 1;
+    DWORD timeout = INFINITE;
+    
+    if (next_frame_ != Clock::time_point::max()) {
+        auto delay = next_frame_ - now;
+        
+        // Relative due time in 100 ns units. MsgWaitForMultipleObjectsEx's own
+        // timeout has scheduler-tick granularity, which would show the clock's
+        // second ticking up to 15 ms late.
+        LARGE_INTEGER due;
+        due.QuadPart = -std::max<LONGLONG>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count() / 100);
+        if (timer_ && SetWaitableTimer(timer_, &due, 0, nullptr, nullptr, FALSE)) {
+            handles[count++] = timer_;
+        } else {
+            timeout = static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(delay).count());
+        }
+    }
+    
+    MsgWaitForMultipleObjectsEx(count, handles, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    ++stats_.wakeups;
+    ++window_wakeups_;
+}
+
+bool FrameScheduler::BeginFrame() {
+    auto now = Clock::now();
+    UpdateRates(now);
+    
+    bool woken = woken_.exchange(false, std::memory_order_acquire);
+    if (pending_frames_ == 0 && now < next_frame_ && !woken) {
+        return false;
+    }
+    
+    if (pending_frames_ > 0) --pending_frames_;
+    next_frame_ = Clock::time_point::max();
+    return true;
+}
+
+void FrameScheduler::EndFrame(bool drawn) {
+    if (drawn) {
+        ++stats_.frames;
+        ++window_frames_;
+    } else {
+        ++stats_.skipped;
+    }
+}
+
+void FrameScheduler::UpdateRates(Clock::time_point now) {
+    auto length = now - window_start_;
+    if (length < RATE_WINDOW) return;
+    
+    double seconds = std::chrono::duration<double>(length).count();
+    uint64_t cpu = ProcessCpuTime();
+    stats_.wakeups_per_second = window_wakeups_ / seconds;
+    stats_.frames_per_second = window_frames_ / seconds;
+    stats_.cpu_percent = (cpu - window_cpu_) * 1e-7 / seconds * 100.0;
+    
+    window_start_ = now;
+    window_wakeups_ = 0;
+    window_frames_ = 0;
+    window_cpu_ = cpu;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../WindowsHeaders.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Decides when the UI thread draws. Instead of presenting every vblank, the
+// window asks for the frames its content needs -- "as soon as possible" while
+// something animates, "at time T" for the next visible change such as a
+// second boundary -- and Wait() sleeps until the earliest of those, a window
+// message, or Wake() from another thread. Idle, that is one wakeup a second.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Stats {
+        double wakeups_per_second = 0.0;
+        double frames_per_second = 0.0;
+        double cpu_percent = 0.0;   // whole process, over the last second
+        uint64_t wakeups = 0;
+        uint64_t frames = 0;
+        uint64_t skipped = 0;       // frames not drawn because the window was hidden
+    };
+    
+    FrameScheduler();
+    ~FrameScheduler();
+    
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+    
+    // Any thread: draw a frame as soon as the UI thread gets to it
+    void Wake();
+    
+    // UI thread. Requests only ever pull the next frame earlier; all are
+    // cleared when a frame begins.
+    void RequestFrames(int count); // back to back, paced by Present
+    void RequestFrameAt(Clock::time_point when);
+    
+    // Blocks until a frame is due, a message arrives or Wake() is called
+    void Wait();
+    
+    // True if a frame is due now; consumes the request. Every frame that
+    // begins ends, drawn or not (window hidden).
+    bool BeginFrame();
+    void EndFrame(bool drawn);
+    
+    Stats GetStats() const { return stats_; }
+
+private:
+    void UpdateRates(Clock::time_point now);
+    
+    HANDLE wake_event_;
+    HANDLE timer_;             // high-resolution waitable timer, or null
+    int pending_frames_;
+    Clock::time_point next_frame_;
+    std::atomic<bool> woken_;
+    
+    Stats stats_;
+    Clock::time_point window_start_;
+    uint64_t window_wakeups_;
+    uint64_t window_frames_;
+    uint64_t window_cpu_;      // process CPU time at window_start_, 100 ns units
+};
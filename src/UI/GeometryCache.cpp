@@ -0,0 +1,246 @@
+#include "GeometryCache.h"
+#include "imgui_internal.h"
+#include <cstring>
+
+namespace {
+    // Entries unused for this many frames are dropped
+    constexpr int SWEEP_FRAMES = 600;
+    
+    // Cheap 64-bit mixing for keys; ImHashData walks a CRC table a byte at a
+    // time, which costs more than the replay it would guard
+    uint64_t Mix(uint64_t hash, uint64_t value) {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        return hash * 0xFF51AFD7ED558CCDull;
+    }
+    
+    uint64_t FloatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    
+    ImVec2 Fraction(const ImVec2& origin) {
+        return ImVec2(origin.x - ImTrunc(origin.x), origin.y - ImTrunc(origin.y));
+    }
+}
+
+uint64_t GeometryCache::FontSeed() {
+    // Everything besides the text that decides which glyphs come out
+    ImGuiContext& g = *GImGui;
+    const ImTextureData* atlas = g.IO.Fonts->TexData;
+    const int atlas_id = atlas ? atlas->UniqueID : 0;
+    if (g.Font != seed_font_ || g.FontSize != seed_size_ || atlas != seed_atlas_ || atlas_id != seed_atlas_id_) {
+        seed_font_ = g.Font;
+        seed_size_ = g.FontSize;
+        seed_atlas_ = atlas;
+        seed_atlas_id_ = atlas_id;
+        font_seed_ = Mix(Mix(Mix(reinterpret_cast<uintptr_t>(g.Font), FloatBits(g.FontSize)),
+                             reinterpret_cast<uintptr_t>(atlas)), static_cast<uint32_t>(atlas_id));
+    }
+    return font_seed_;
+}
+
+GeometryCache::Entry& GeometryCache::Lookup(const void* label) {
+    Sweep();
+    Entry& entry = entries_[Mix(FontSeed(), reinterpret_cast<uintptr_t>(label))];
+    entry.last_frame = ImGui::GetFrameCount();
+    return entry;
+}
+
+CapturedGeometry::Mark CapturedGeometry::MarkOf(const ImDrawList* list) {
+    return { list->CmdBuffer.Size, list->VtxBuffer.Size, list->IdxBuffer.Size, list->_VtxCurrentIdx };
+}
+
+bool CapturedGeometry::Keep(const ImDrawList* list, const Mark& mark, const ImVec2& origin, const ImVec2& min,
+                            const ImVec2& max) {
+    // Text is culled against the clip rect as it is generated, so geometry
+    // drawn partly clipped would replay with pieces missing
+    const ImVec4& clip = list->_CmdHeader.ClipRect;
+    bool inside = min.x >= clip.x && min.y >= clip.y && max.x <= clip.z && max.y <= clip.w;
+    const int vtx_count = list->VtxBuffer.Size - mark.vtx_begin;
+    if (!inside || vtx_count == 0 || list->CmdBuffer.Size != mark.commands ||
+        list->_VtxCurrentIdx != mark.base + vtx_count) {
+        captured_ = false;
+        return false;
+    }
+    
+    vertices_.assign(list->VtxBuffer.Data + mark.vtx_begin, list->VtxBuffer.Data + list->VtxBuffer.Size);
+    for (ImDrawVert& vertex : vertices_) {
+        vertex.pos.x -= origin.x;
+        vertex.pos.y -= origin.y;
+    }
+    indices_.resize(list->IdxBuffer.Size - mark.idx_begin);
+    for (size_t i = 0; i < indices_.size(); ++i) {
+        indices_[i] = static_cast<ImDrawIdx>(list->IdxBuffer.Data[mark.idx_begin + i] - mark.base);
+    }
+    captured_ = true;
+    return true;
+}
+
+void CapturedGeometry::Replay(ImDrawList* list, const ImVec2& origin) const {
+    const int vtx_count = static_cast<int>(vertices_.size());
+    const int idx_count = static_cast<int>(indices_.size());
+    list->PrimReserve(idx_count, vtx_count);
+    
+    const ImDrawIdx base = static_cast<ImDrawIdx>(list->_VtxCurrentIdx);
+    ImDrawVert* vertices = list->_VtxWritePtr;
+    for (int i = 0; i < vtx_count; ++i) {
+        vertices[i] = vertices_[i];
+        vertices[i].pos.x += origin.x;
+        vertices[i].pos.y += origin.y;
+    }
+    ImDrawIdx* indices = list->_IdxWritePtr;
+    for (int i = 0; i < idx_count; ++i) {
+        indices[i] = static_cast<ImDrawIdx>(base + indices_[i]);
+    }
+    list->_VtxWritePtr += vtx_count;
+    list->_IdxWritePtr += idx_count;
+    list->_VtxCurrentIdx += vtx_count;
+}
+
+template <typename Draw>
+void GeometryCache::Capture(Geometry& geometry, uint64_t look, const ImVec2& min, const ImVec2& max, Draw draw) {
+    geometry.triangles.Capture(ImGui::GetWindowDrawList(), min, min, max, draw);
+    ++stats_.misses;
+    geometry.fraction = Fraction(min);
+    geometry.look = look;
+}
+
+bool GeometryCache::CanReplay(const Geometry& geometry, uint64_t look, const ImVec2& origin) const {
+    // Glyphs snap to whole pixels, so only origins with the same sub-pixel
+    // offset give the same triangles
+    ImVec2 fraction = Fraction(origin);
+    return geometry.triangles.IsCaptured() && geometry.look == look &&
+           fraction.x == geometry.fraction.x && fraction.y == geometry.fraction.y;
+}
+
+void GeometryCache::Replay(const Geometry& geometry, const ImVec2& origin) {
+    geometry.triangles.Replay(ImGui::GetWindowDrawList(), origin);
+    ++stats_.hits;
+    stats_.replayed_vertices += geometry.triangles.GetVertexCount();
+}
+
+void GeometryCache::Text(const char* text) {
+    DrawText(text);
+}
+
+void GeometryCache::TextColored(const ImVec4& color, const char* text) {
+    ImGui::PushStyleColor(ImGuiCol_Text, color);
+    DrawText(text);
+    ImGui::PopStyleColor();
+}
+
+void GeometryCache::TextDisabled(const char* text) {
+    ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyle().Colors[ImGuiCol_TextDisabled]);
+    DrawText(text);
+    ImGui::PopStyleColor();
+}
+
+void GeometryCache::DrawText(const char* text) {
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (!enabled_ || window->DC.TextWrapPos >= 0.0f) {
+        ImGui::TextUnformatted(text);
+        return;
+    }
+    if (window->SkipItems) return;
+    
+    // Same layout as ImGui::TextEx
+    Entry& entry = Lookup(text);
+    if (!entry.measured) {
+        entry.size = ImGui::CalcTextSize(text);
+        entry.measured = true;
+    }
+    
+    const ImVec2 pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+    const ImRect bb(pos.x, pos.y, pos.x + entry.size.x, pos.y + entry.size.y);
+    ImGui::ItemSize(entry.size, 0.0f);
+    if (!ImGui::ItemAdd(bb, 0)) return;
+    
+    const ImU32 color = ImGui::GetColorU32(ImGuiCol_Text);
+    Geometry& geometry = entry.states[0];
+    if (CanReplay(geometry, color, bb.Min)) {
+        Replay(geometry, bb.Min);
+        return;
+    }
+    Capture(geometry, color, bb.Min, bb.Max, [&]() {
+        ImGuiContext& g = *GImGui;
+        window->DrawList->AddText(g.Font, g.FontSize, bb.Min, color, text);
+    });
+}
+
+bool GeometryCache::Button(const char* label, const ImVec2& size_arg) {
+    if (!enabled_) return ImGui::Button(label, size_arg);
+    
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems) return false;
+    
+    // Same layout and behavior as ImGui::ButtonEx; only the drawing is cached
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const ImGuiID id = window->GetID(label);
+    Entry& entry = Lookup(label);
+    if (!entry.measured) {
+        entry.size = ImGui::CalcTextSize(label, nullptr, true);
+        entry.measured = true;
+    }
+    const ImVec2 label_size = entry.size;
+    
+    const ImVec2 pos = window->DC.CursorPos;
+    const ImVec2 size = ImGui::CalcItemSize(size_arg, label_size.x + style.FramePadding.x * 2.0f,
+                                            label_size.y + style.FramePadding.y * 2.0f);
+    const ImRect bb(pos.x, pos.y, pos.x + size.x, pos.y + size.y);
+    ImGui::ItemSize(size, style.FramePadding.y);
+    if (!ImGui::ItemAdd(bb, id)) return false;
+    
+    bool hovered, held;
+    bool pressed = ImGui::ButtonBehavior(bb, id, &hovered, &held);
+    
+    const int state = (held && hovered) ? 2 : hovered ? 1 : 0;
+    const ImU32 frame_color = ImGui::GetColorU32(state == 2 ? ImGuiCol_ButtonActive
+                                                 : state == 1 ? ImGuiCol_ButtonHovered : ImGuiCol_Button);
+    ImGui::RenderNavCursor(bb, id);
+    
+    uint64_t look = Mix(frame_color, ImGui::GetColorU32(ImGuiCol_Text));
+    look = Mix(look, ImGui::GetColorU32(ImGuiCol_Border));
+    look = Mix(look, ImGui::GetColorU32(ImGuiCol_BorderShadow));
+    look = Mix(look, FloatBits(size.x) << 32 | FloatBits(size.y));
+    look = Mix(look, FloatBits(style.FrameRounding) << 32 | FloatBits(style.FrameBorderSize));
+    look = Mix(look, FloatBits(style.ButtonTextAlign.x) << 32 | FloatBits(style.ButtonTextAlign.y));
+    look = Mix(look, FloatBits(style.FramePadding.x) << 32 | FloatBits(style.FramePadding.y));
+    
+    Geometry& geometry = entry.states[state];
+    if (CanReplay(geometry, look, bb.Min)) {
+        Replay(geometry, bb.Min);
+    } else {
+        Capture(geometry, look, bb.Min, bb.Max, [&]() {
+            ImGui::RenderFrame(bb.Min, bb.Max, frame_color, true, style.FrameRounding);
+            ImVec2 text_min(bb.Min.x + style.FramePadding.x, bb.Min.y + style.FramePadding.y);
+            ImVec2 text_max(bb.Max.x - style.FramePadding.x, bb.Max.y - style.FramePadding.y);
+            ImGui::RenderTextClipped(text_min, text_max, label, nullptr, &label_size, style.ButtonTextAlign, &bb);
+        });
+    }
+    return pressed;
+}
+
+void GeometryCache::Clear() {
+    entries_.clear();
+}
+
+GeometryCache::Stats GeometryCache::GetStats() const {
+    Stats stats = stats_;
+    stats.entries = entries_.size();
+    return stats;
+}
+
+void GeometryCache::Sweep() {
+    int frame = ImGui::GetFrameCount();
+    if (frame < next_sweep_) return;
+    next_sweep_ = frame + SWEEP_FRAMES;
+    
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (frame - it->second.last_frame > SWEEP_FRAMES) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
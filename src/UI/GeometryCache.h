@@ -0,0 +1,116 @@
+#pragma once
+
+#include "imgui.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Triangles captured from a draw list, relative to an origin, and copied
+// back in translated to a new one. The building block of GeometryCache,
+// also used directly by widgets that retain a single piece of geometry.
+class CapturedGeometry {
+public:
+    // Draws through `draw` and keeps its output when it can be replayed as
+    // is: one draw command, with [min, max] fully inside the clip rect
+    template <typename Draw>
+    bool Capture(ImDrawList* list, const ImVec2& origin, const ImVec2& min, const ImVec2& max, Draw draw) {
+        const Mark mark = MarkOf(list);
+        draw();
+        return Keep(list, mark, origin, min, max);
+    }
+    
+    // Adds the kept triangles to `list`, translated to `origin`
+    void Replay(ImDrawList* list, const ImVec2& origin) const;
+    
+    bool IsCaptured() const { return captured_; }
+    int GetVertexCount() const { return static_cast<int>(vertices_.size()); }
+
+private:
+    struct Mark {
+        int commands;
+        int vtx_begin;
+        int idx_begin;
+        unsigned int base;
+    };
+    
+    static Mark MarkOf(const ImDrawList* list);
+    bool Keep(const ImDrawList* list, const Mark& mark, const ImVec2& origin, const ImVec2& min, const ImVec2& max);
+    
+    std::vector<ImDrawVert> vertices_;   // relative to the origin
+    std::vector<ImDrawIdx> indices_;     // relative to the first vertex
+    bool captured_ = false;
+};
+
+// Retained geometry for widgets whose look rarely changes: static labels and
+// buttons. The first time a label is drawn its triangles are captured from
+// the window's draw list; after that the widget still goes through ImGui's
+// layout and input handling, but its vertices are copied in, translated to
+// the item's position, instead of being generated glyph by glyph. Buttons
+// keep one capture per visual state (idle, hovered, held), so their look
+// still follows the mouse.
+//
+// Entries are found by the address of the label and the current font, so
+// labels must be strings that do not change -- literals, in practice. Text
+// built every frame should keep using ImGui::Text. Colors and style are
+// checked against what was captured, so a theme change simply recaptures;
+// entries unused for a while are dropped.
+class GeometryCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;             // drawn by ImGui and captured
+        uint64_t replayed_vertices = 0;
+        size_t entries = 0;
+    };
+    
+    // Drop-in for the ImGui calls of the same name, without formatting
+    void Text(const char* text);
+    void TextColored(const ImVec4& color, const char* text);
+    void TextDisabled(const char* text);
+    bool Button(const char* label, const ImVec2& size = ImVec2(0, 0));
+    
+    // Disabled, every call goes straight to ImGui (for A/B measurements)
+    void SetEnabled(bool enabled) { enabled_ = enabled; }
+    bool IsEnabled() const { return enabled_; }
+    
+    void Clear();
+    Stats GetStats() const;
+
+private:
+    struct Geometry {
+        CapturedGeometry triangles;        // relative to the item's origin
+        ImVec2 fraction;                   // sub-pixel part of the origin at capture
+        uint64_t look = 0;                 // colors and style it was drawn with
+    };
+    
+    struct Entry {
+        Geometry states[3];                // idle, hovered, held; text uses the first
+        ImVec2 size;                       // text size
+        int last_frame = 0;
+        bool measured = false;
+    };
+    
+    Entry& Lookup(const void* label);
+    uint64_t FontSeed();
+    
+    // Draws through `draw` and keeps its output when it is replayable
+    template <typename Draw>
+    void Capture(Geometry& geometry, uint64_t look, const ImVec2& min, const ImVec2& max, Draw draw);
+    void Replay(const Geometry& geometry, const ImVec2& origin);
+    bool CanReplay(const Geometry& geometry, uint64_t look, const ImVec2& origin) const;
+    
+    void DrawText(const char* text);
+    void Sweep();
+    
+    std::unordered_map<uint64_t, Entry> entries_;
+    Stats stats_;
+    int next_sweep_ = 0;
+    bool enabled_ = true;
+    
+    // Seed for the font in use, recomputed only when it changes
+    const ImFont* seed_font_ = nullptr;
+    float seed_size_ = 0.0f;
+    const ImTextureData* seed_atlas_ = nullptr;
+    int seed_atlas_id_ = -1;
+    uint64_t font_seed_ = 0;
+};
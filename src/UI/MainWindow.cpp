@@ -1,27 +1,35 @@
 #include "MainWindow.h"
 #include "../TimeApplication.h"
 #include "DarkTheme.h"
-#include <sstream>
-#include <iomanip>
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
+#include <iostream>
 
 // Forward declare message handler from imgui_impl_win32.cpp
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+namespace {
+    // ImGui needs a few frames after input to settle hover, focus and nav
+    constexpr int INPUT_FRAMES = 3;
+    
+    // How often to check whether an occluded window became visible
+    constexpr auto OCCLUDED_POLL = std::chrono::milliseconds(250);
+    
+    constexpr auto PROFILER_REFRESH = std::chrono::milliseconds(100);
+}
+
 MainWindow::MainWindow(TimeApplication& app)
     : app_(app)
+    , view_(app)
     , is_initialized_(false)
-    , countdown_input_minutes_(5)
-    , countdown_input_seconds_(0)
-    , show_milliseconds_(false)
     , hwnd_(nullptr)
     , pd3dDevice_(nullptr)
     , pd3dDeviceContext_(nullptr)
     , pSwapChain_(nullptr)
     , pMainRenderTargetView_(nullptr)
+    , profiler_(&app.GetTscClock())
     , done_(false) {
 }
 
@@ -58,6 +66,16 @@ bool MainWindow::Initialize() {
     ImGui_ImplWin32_Init(hwnd_);
     ImGui_ImplDX11_Init(pd3dDevice_, pd3dDeviceContext_);
     
+    // Hotkeys change the stopwatch without any window message
+    app_.GetHotkeys().SetOnEvent([this]() {
+        frame_scheduler_.Wake();
+    });
+    
+    view_.SetStatusExtension([this]() {
+        RenderFrameStats();
+    });
+    view_.SetProfiler(&profiler_);
+    
     is_initialized_ = true;
     return true;
 }
@@ -69,7 +87,7 @@ bool MainWindow::CreateAppWindow() {  // Renamed method
     
     // Use CreateWindowW explicitly to avoid macro issues
     hwnd_ = CreateWindowW(wc_.lpszClassName, L"Time Display Application", 
-                         WS_OVERLAPPEDWINDOW, 100, 100, 500, 400, 
+                         WS_OVERLAPPEDWINDOW, 100, 100, 600, 500, 
                          nullptr, nullptr, wc_.hInstance, nullptr);
     
     if (!hwnd_) {
@@ -94,7 +112,7 @@ bool MainWindow::CreateDeviceD3D() {
     sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     sd.SampleDesc.Count = 1;
     sd.SampleDesc.Quality = 0;
-    sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+    sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // the latency waitable object needs flip model
     sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
     sd.Scaling = DXGI_SCALING_STRETCH;
     sd.Stereo = FALSE;
@@ -117,12 +135,25 @@ bool MainWindow::CreateDeviceD3D() {
     dxgiDevice->GetAdapter(&dxgiAdapter);
     dxgiAdapter->GetParent(__uuidof(IDXGIFactory2), (void**)&dxgiFactory);
     
-    dxgiFactory->CreateSwapChainForHwnd(pd3dDevice_, hwnd_, &sd, nullptr, nullptr, &pSwapChain_);
+    res = dxgiFactory->CreateSwapChainForHwnd(pd3dDevice_, hwnd_, &sd, nullptr, nullptr, &pSwapChain_);
+    if (res != S_OK) {
+        // Flip model needs Windows 8; fall back to the blit model, unpaced
+        sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+        sd.Flags = 0;
+        res = dxgiFactory->CreateSwapChainForHwnd(pd3dDevice_, hwnd_, &sd, nullptr, nullptr, &pSwapChain_);
+    }
+    swap_chain_flags_ = sd.Flags;
     
     dxgiFactory->Release();
     dxgiAdapter->Release();
     dxgiDevice->Release();
     
+    if (res != S_OK) return false;
+    
+    if (!frame_pacer_.Attach(pSwapChain_)) {
+        std::cout << "Frame latency waitable object unavailable; frames are not paced" << std::endl;
+    }
+    
     // Create render target
     ID3D11Texture2D* pBackBuffer;
     pSwapChain_->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&pBackBuffer);
@@ -134,75 +165,111 @@ bool MainWindow::CreateDeviceD3D() {
 
 void MainWindow::Render() {
     if (!is_initialized_) return;
+    if (!frame_scheduler_.BeginFrame()) return;
+    
+    // Nothing to draw into while minimized; restoring sends messages that
+    // bring the next frame
+    if (IsIconic(hwnd_)) {
+        PROFILE_DISCARD_FRAME(&profiler_);
+        frame_scheduler_.EndFrame(false);
+        return;
+    }
     
-    // Start the Dear ImGui frame
-    ImGui_ImplDX11_NewFrame();
-    ImGui_ImplWin32_NewFrame();
-    ImGui::NewFrame();
+    // Covered by another window: probe instead of drawing
+    if (occluded_) {
+        if (pSwapChain_->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED) {
+            frame_scheduler_.RequestFrameAt(FrameScheduler::Clock::now() + OCCLUDED_POLL);
+            PROFILE_DISCARD_FRAME(&profiler_);
+            frame_scheduler_.EndFrame(false);
+            return;
+        }
+        occluded_ = false;
+    }
     
-    // Main window
-    ImGui::SetNextWindowPos(ImVec2(0, 0));
-    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    // Wait for the swap chain before sampling any clock, so the times drawn
+    // are at most a refresh older than the vblank that shows them
+    {
+        PROFILE_SCOPE(&profiler_, FrameWait);
+        frame_pacer_.WaitForFrame();
+    }
     
-    ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoDecoration | 
-                                   ImGuiWindowFlags_NoResize | 
-                                   ImGuiWindowFlags_NoMove;
+    // Start the Dear ImGui frame
+    {
+        PROFILE_SCOPE(&profiler_, NewFrame);
+        ImGui_ImplDX11_NewFrame();
+        ImGui_ImplWin32_NewFrame();
+        ImGui::NewFrame();
+    }
     
-    if (ImGui::Begin("Time Display Application", nullptr, window_flags)) {
-        
-        RenderTimeDisplay();
-        ImGui::Separator();
-        
-        RenderNTPControls();
-        ImGui::Separator();
-        
-        if (ImGui::BeginTabBar("TimerTabs")) {
-            if (ImGui::BeginTabItem("Stopwatch")) {
-                RenderStopwatch();
-                ImGui::EndTabItem();
-            }
-            
-            if (ImGui::BeginTabItem("Countdown")) {
-                RenderCountdown();
-                ImGui::EndTabItem();
-            }
-            
-            ImGui::EndTabBar();
-        }
-        
-        RenderStatusBar();
+    view_.Render();
+    if (show_profiler_) {
+        profiler_.RenderOverlay(&show_profiler_);
+        // Live graph: refresh at a readable rate rather than every vblank
+        frame_scheduler_.RequestFrameAt(FrameScheduler::Clock::now() + PROFILER_REFRESH);
     }
-    ImGui::End();
+    
+    auto request = view_.TakeFrameRequest();
+    frame_scheduler_.RequestFrames(request.frames);
+    frame_scheduler_.RequestFrameAt(request.at);
     
     // Rendering
-    ImGui::Render();
-    const float clear_color[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
-    pd3dDeviceContext_->OMSetRenderTargets(1, &pMainRenderTargetView_, nullptr);
-    pd3dDeviceContext_->ClearRenderTargetView(pMainRenderTargetView_, clear_color);
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    {
+        PROFILE_SCOPE(&profiler_, ImGuiRender);
+        ImGui::Render();
+    }
+    {
+        PROFILE_SCOPE(&profiler_, Submit);
+        const float clear_color[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        pd3dDeviceContext_->OMSetRenderTargets(1, &pMainRenderTargetView_, nullptr);
+        pd3dDeviceContext_->ClearRenderTargetView(pMainRenderTargetView_, clear_color);
+        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    }
     
-    pSwapChain_->Present(1, 0); // Present with vsync
+    HRESULT result;
+    {
+        PROFILE_SCOPE(&profiler_, Present);
+        result = pSwapChain_->Present(1, 0); // Present with vsync
+    }
+    occluded_ = result == DXGI_STATUS_OCCLUDED;
+    frame_pacer_.Presented();
+    PROFILE_END_FRAME(&profiler_);
+    frame_scheduler_.EndFrame(true);
 }
 
 bool MainWindow::ProcessEvents() {
+    // Sleeps until the next visible change, a message or a hotkey
+    frame_scheduler_.Wait();
+    
+    PROFILE_SCOPE(&profiler_, Messages);
     MSG msg;
+    bool had_messages = false;
     while (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
         if (msg.message == WM_QUIT) {
             done_ = true;
         }
+        had_messages = true;
+    }
+    
+    if (had_messages) {
+        frame_scheduler_.RequestFrames(INPUT_FRAMES);
     }
     return !done_;
 }
 
 // Window procedure
 LRESULT CALLBACK MainWindow::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    MainWindow* window = reinterpret_cast<MainWindow*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+    
+    // Buttons fire on mouse release, or key press when navigating by keyboard
+    if (window && (msg == WM_LBUTTONUP || msg == WM_KEYDOWN)) {
+        window->RecordInputTime();
+    }
+    
     if (ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam))
         return true;
     
-    MainWindow* window = reinterpret_cast<MainWindow*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-    
     switch (msg) {
         case WM_SIZE:
             if (window && window->pd3dDevice_ != nullptr && wParam != SIZE_MINIMIZED) {
@@ -210,7 +277,11 @@ LRESULT CALLBACK MainWindow::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPAR
                     window->pMainRenderTargetView_->Release();
                     window->pMainRenderTargetView_ = nullptr;
                 }
-                window->pSwapChain_->ResizeBuffers(0, (UINT)LOWORD(lParam), (UINT)HIWORD(lParam), DXGI_FORMAT_UNKNOWN, 0);
+                // Flip model fails the resize while the context still binds a back buffer,
+                // and the flags must match the ones the swap chain was created with
+                window->pd3dDeviceContext_->OMSetRenderTargets(0, nullptr, nullptr);
+                window->pSwapChain_->ResizeBuffers(0, (UINT)LOWORD(lParam), (UINT)HIWORD(lParam), DXGI_FORMAT_UNKNOWN,
+                                                   window->swap_chain_flags_);
                 
                 ID3D11Texture2D* pBackBuffer;
                 window->pSwapChain_->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&pBackBuffer);
@@ -219,6 +290,13 @@ LRESULT CALLBACK MainWindow::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPAR
             }
             return 0;
             
+        case WM_TIMECHANGE:
+            // Timer handles already follow the change; this only refreshes the heads
+            if (window) {
+                window->app_.GetAlarmScheduler().NotifyClockChanged();
+            }
+            return 0;
+            
         case WM_SYSCOMMAND:
             if ((wParam & 0xfff0) == SC_KEYMENU) // Disable ALT application menu
                 return 0;
@@ -233,6 +311,7 @@ LRESULT CALLBACK MainWindow::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPAR
 }
 
 void MainWindow::CleanupDeviceD3D() {
+    frame_pacer_.Detach();
     if (pMainRenderTargetView_) { pMainRenderTargetView_->Release(); pMainRenderTargetView_ = nullptr; }
     if (pSwapChain_) { pSwapChain_->Release(); pSwapChain_ = nullptr; }
     if (pd3dDeviceContext_) { pd3dDeviceContext_->Release(); pd3dDeviceContext_ = nullptr; }
@@ -249,6 +328,8 @@ void MainWindow::CleanupWindow() {
 
 void MainWindow::Shutdown() {
     if (is_initialized_) {
+        app_.GetHotkeys().SetOnEvent(InlineCallback());
+        
         ImGui_ImplDX11_Shutdown();
         ImGui_ImplWin32_Shutdown();
         ImGui::DestroyContext();
@@ -261,147 +342,32 @@ void MainWindow::Shutdown() {
 }
 
 // All the render methods remain the same as in my previous response
-void MainWindow::RenderTimeDisplay() {
-    ImGui::SetWindowFontScale(2.0f);
-    ImGui::TextColored(ImVec4(0.8f, 0.9f, 1.0f, 1.0f), "%s", FormatCurrentTime().c_str());
-    ImGui::SetWindowFontScale(1.0f);
-    
-    ImGui::Checkbox("Show Milliseconds", &show_milliseconds_);
-}
 
-void MainWindow::RenderNTPControls() {
-    if (ImGui::Button("Sync with NTP", ImVec2(120, 0))) {
-        app_.SyncTimeWithNTP();
+void MainWindow::RecordInputTime() {
+    auto now = app_.GetTscClock().Now();
+    
+    // GetMessageTime() is on the GetTickCount() timeline, so this is how long
+    // the message sat in the queue (e.g. behind a vsync wait), to a tick
+    DWORD age = GetTickCount() - static_cast<DWORD>(GetMessageTime());
+    if (age < 1000) {
+        now -= std::chrono::milliseconds(age);
     }
-    
-    ImGui::SameLine();
-    if (app_.IsNTPSyncInProgress()) {
-        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Syncing...");
-    } else {
-        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Ready");
-    }
-}
-
-void MainWindow::RenderStopwatch() {
-    auto& stopwatch = app_.GetStopwatch();
-    
-    ImGui::SetWindowFontScale(1.5f);
-    if (show_milliseconds_) {
-        ImGui::Text("%s", stopwatch.FormatTimeWithMilliseconds().c_str());
-    } else {
-        ImGui::Text("%s", stopwatch.FormatTime().c_str());
-    }
-    ImGui::SetWindowFontScale(1.0f);
-    
-    ImGui::Spacing();
-    HandleStopwatchControls();
+    view_.SetInputTime(now);
 }
 
-void MainWindow::RenderCountdown() {
-    auto& countdown = app_.GetCountdown();
-    
-    ImGui::Text("Set Countdown:");
-    ImGui::PushItemWidth(80);
-    ImGui::InputInt("Minutes", &countdown_input_minutes_, 1, 10);
+void MainWindow::RenderFrameStats() {
+    auto frames = frame_scheduler_.GetStats();
+    ImGui::Text("| Frames: %.1f/s | Wakeups: %.1f/s | CPU: %.1f%%",
+                frames.frames_per_second, frames.wakeups_per_second, frames.cpu_percent);
+#ifdef ENABLE_PROFILER
     ImGui::SameLine();
-    ImGui::InputInt("Seconds", &countdown_input_seconds_, 1, 10);
-    ImGui::PopItemWidth();
-    
-    countdown_input_minutes_ = std::max(0, countdown_input_minutes_);
-    countdown_input_seconds_ = std::max(0, std::min(59, countdown_input_seconds_));
-    
-    ImGui::Spacing();
-    ImGui::SetWindowFontScale(1.5f);
-    ImGui::Text("%s", countdown.FormatTime().c_str());
-    ImGui::SetWindowFontScale(1.0f);
-    
-    ImGui::Spacing();
-    HandleCountdownControls();
-}
-
-void MainWindow::HandleStopwatchControls() {
-    auto& stopwatch = app_.GetStopwatch();
-    
-    switch (stopwatch.GetState()) {
-        case Timer::State::Stopped:
-            if (ImGui::Button("Start", ImVec2(80, 0))) {
-                stopwatch.Start();
-            }
-            break;
-            
-        case Timer::State::Running:
-            if (ImGui::Button("Pause", ImVec2(80, 0))) {
-                stopwatch.Pause();
-            }
-            ImGui::SameLine();
-            if (ImGui::Button("Reset", ImVec2(80, 0))) {
-                stopwatch.Reset();
-            }
-            break;
-            
-        case Timer::State::Paused:
-            if (ImGui::Button("Resume", ImVec2(80, 0))) {
-                stopwatch.Resume();
-            }
-            ImGui::SameLine();
-            if (ImGui::Button("Reset", ImVec2(80, 0))) {
-                stopwatch.Reset();
-            }
-            break;
-    }
-}
-
-void MainWindow::HandleCountdownControls() {
-    auto& countdown = app_.GetCountdown();
-    
-    switch (countdown.GetState()) {
-        case Timer::State::Stopped:
-            if (ImGui::Button("Start Countdown", ImVec2(120, 0))) {
-                auto total_seconds = countdown_input_minutes_ * 60 + countdown_input_seconds_;
-                countdown.SetDuration(std::chrono::seconds(total_seconds));
-                countdown.Start();
-            }
-            break;
-            
-        case Timer::State::Running:
-            if (ImGui::Button("Pause", ImVec2(80, 0))) {
-                countdown.Pause();
-            }
-            ImGui::SameLine();
-            if (ImGui::Button("Stop", ImVec2(80, 0))) {
-                countdown.Stop();
-            }
-            break;
-            
-        case Timer::State::Paused:
-            if (ImGui::Button("Resume", ImVec2(80, 0))) {
-                countdown.Resume();
-            }
-            ImGui::SameLine();
-            if (ImGui::Button("Stop", ImVec2(80, 0))) {
-                countdown.Stop();
-            }
-            break;
+    ImGui::Checkbox("Profiler", &show_profiler_);
+#endif
+    
+    const auto& pacing = frame_pacer_.GetStats();
+    if (pacing.sample_to_present.count > 0) {
+        ImGui::TextDisabled("Display latency: sample to present %.2f ms (max %.2f), to scanout %.2f ms (max %.2f)",
+                            pacing.sample_to_present.Mean().count() / 1e6, pacing.sample_to_present.max.count() / 1e6,
+                            pacing.sample_to_scanout.Mean().count() / 1e6, pacing.sample_to_scanout.max.count() / 1e6);
     }
 }
-
-void MainWindow::RenderStatusBar() {
-    ImGui::Separator();
-    ImGui::Text("Status: Application Running");
-}
-
-std::string MainWindow::FormatCurrentTime() const {
-    auto time_point = app_.GetCurrentTime();
-    auto time_t = std::chrono::system_clock::to_time_t(time_point);
-    
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-    
-    if (show_milliseconds_) {
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            time_point.time_since_epoch()) % 1000;
-        oss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    }
-    
-    return oss.str();
-}
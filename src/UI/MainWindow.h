@@ -1,8 +1,13 @@
 #pragma once
 
 #include "../WindowsHeaders.h"  // Use common header
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "TimeAppView.h"
 #include <string>
 #include <chrono>
+#include <vector>
 
 class TimeApplication; // Forward declaration
 
@@ -19,15 +24,11 @@ public:
     HWND GetWindowHandle() const { return hwnd_; }
     
 private:
-    void RenderTimeDisplay();
-    void RenderNTPControls();
-    void RenderStopwatch();
-    void RenderCountdown();
-    void RenderStatusBar();
+    // Input timestamps: taken when the message is dispatched, before ImGui
+    // sees it, and handed to the view for the button that input pressed
+    void RecordInputTime();
     
-    std::string FormatCurrentTime() const;
-    void HandleStopwatchControls();
-    void HandleCountdownControls();
+    void RenderFrameStats();
     
     bool CreateDeviceD3D();
     void CleanupDeviceD3D();
@@ -37,6 +38,7 @@ private:
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
     
     TimeApplication& app_;
+    TimeAppView view_;
     bool is_initialized_;
     
     // Window handles
@@ -48,10 +50,15 @@ private:
     ID3D11DeviceContext* pd3dDeviceContext_;
     IDXGISwapChain1* pSwapChain_;
     ID3D11RenderTargetView* pMainRenderTargetView_;
+    UINT swap_chain_flags_ = 0;
+    
+    // Frames are drawn when content changes, not every vblank
+    FrameScheduler frame_scheduler_;
+    FramePacer frame_pacer_;
+    bool occluded_ = false;
+    
+    FrameProfiler profiler_;
+    bool show_profiler_ = false;
     
-    // UI state
-    int countdown_input_minutes_;
-    int countdown_input_seconds_;
-    bool show_milliseconds_;
     bool done_;
 };
@@ -0,0 +1,213 @@
+#include "SegmentDisplay.h"
+#include "imgui_internal.h"
+
+namespace {
+    // Proportions relative to the digit height
+    constexpr float DIGIT_WIDTH = 0.55f;
+    constexpr float THICKNESS = 0.12f;
+    constexpr float GAP = 0.012f;         // between neighbouring segments
+    constexpr float DOT_CELL = 0.16f;     // width of the colon and point cells
+    constexpr float SPACING = 0.12f;      // between cells
+    
+    // At most this many heights are kept; the least recently drawn goes
+    constexpr size_t MAX_MESHES = 4;
+    
+    // Segments lit per digit, bit 0 = a (top) through bit 6 = g (middle)
+    constexpr uint8_t DIGIT_MASKS[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+    constexpr uint8_t MINUS_MASK = 0x40;
+    
+    float CellWidth(char c) {
+        return (c == ':' || c == '.') ? DOT_CELL : DIGIT_WIDTH;
+    }
+    
+    // Hexagon along a horizontal or vertical axis, ends pointed
+    int Horizontal(float y, float x0, float x1, float h, ImVec2* points) {
+        points[0] = ImVec2(x0, y);
+        points[1] = ImVec2(x0 + h, y - h);
+        points[2] = ImVec2(x1 - h, y - h);
+        points[3] = ImVec2(x1, y);
+        points[4] = ImVec2(x1 - h, y + h);
+        points[5] = ImVec2(x0 + h, y + h);
+        return 6;
+    }
+    
+    int Vertical(float x, float y0, float y1, float h, ImVec2* points) {
+        points[0] = ImVec2(x, y0);
+        points[1] = ImVec2(x + h, y0 + h);
+        points[2] = ImVec2(x + h, y1 - h);
+        points[3] = ImVec2(x, y1);
+        points[4] = ImVec2(x - h, y1 - h);
+        points[5] = ImVec2(x - h, y0 + h);
+        return 6;
+    }
+    
+    int Square(float x, float y, float h, ImVec2* points) {
+        points[0] = ImVec2(x - h, y - h);
+        points[1] = ImVec2(x + h, y - h);
+        points[2] = ImVec2(x + h, y + h);
+        points[3] = ImVec2(x - h, y + h);
+        return 4;
+    }
+}
+
+int SegmentDisplay::PartOutline(Part part, float height, ImVec2* points) {
+    // Clockwise on screen, as ImGui's anti-aliased fill expects
+    const float width = height * DIGIT_WIDTH;
+    const float h = height * THICKNESS * 0.5f;
+    const float gap = height * GAP;
+    const float middle = height * 0.5f;
+    const float left = h, right = width - h, top = h, bottom = height - h;
+    switch (part) {
+        case SegmentA: return Horizontal(top, left + gap, right - gap, h, points);
+        case SegmentB: return Vertical(right, top + gap, middle - gap, h, points);
+        case SegmentC: return Vertical(right, middle + gap, bottom - gap, h, points);
+        case SegmentD: return Horizontal(bottom, left + gap, right - gap, h, points);
+        case SegmentE: return Vertical(left, middle + gap, bottom - gap, h, points);
+        case SegmentF: return Vertical(left, top + gap, middle - gap, h, points);
+        case SegmentG: return Horizontal(middle, left + gap, right - gap, h, points);
+        case ColonTop: return Square(height * DOT_CELL * 0.5f, height * 0.3f, h, points);
+        case ColonBottom: return Square(height * DOT_CELL * 0.5f, height * 0.7f, h, points);
+        case Point: return Square(height * DOT_CELL * 0.5f, bottom, h, points);
+        default: return 0;
+    }
+}
+
+float SegmentDisplay::CalcWidth(float height, const char* text) {
+    float width = 0.0f;
+    for (const char* c = text; *c; ++c) {
+        width += CellWidth(*c) + (c != text ? SPACING : 0.0f);
+    }
+    return width * height;
+}
+
+template <typename Emit>
+void SegmentDisplay::ForEachPart(float height, const char* text, Emit emit) const {
+    float x = 0.0f;
+    for (const char* c = text; *c; ++c) {
+        if (*c == ':') {
+            emit(ColonTop, x, true);
+            emit(ColonBottom, x, true);
+        } else if (*c == '.') {
+            emit(Point, x, true);
+        } else {
+            uint8_t mask = (*c >= '0' && *c <= '9') ? DIGIT_MASKS[*c - '0'] : *c == '-' ? MINUS_MASK : 0;
+            for (int segment = SegmentA; segment <= SegmentG; ++segment) {
+                emit(static_cast<Part>(segment), x, (mask >> segment & 1) != 0);
+            }
+        }
+        x += (CellWidth(*c) + SPACING) * height;
+    }
+}
+
+SegmentDisplay::Mesh& SegmentDisplay::GetMesh(float height) {
+    const int frame = ImGui::GetFrameCount();
+    Mesh* oldest = nullptr;
+    for (Mesh& mesh : meshes_) {
+        if (mesh.height == height) {
+            mesh.last_frame = frame;
+            return mesh;
+        }
+        if (!oldest || mesh.last_frame < oldest->last_frame) oldest = &mesh;
+    }
+    
+    if (meshes_.size() < MAX_MESHES) {
+        meshes_.emplace_back();
+        oldest = &meshes_.back();
+    }
+    oldest->height = height;
+    oldest->last_frame = frame;
+    BuildMesh(*oldest);
+    return *oldest;
+}
+
+void SegmentDisplay::BuildMesh(Mesh& mesh) {
+    // Tessellated in white on a private draw list; the fringe is the
+    // vertices left transparent
+    if (!scratch_) scratch_ = std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData());
+    scratch_->_ResetForNewFrame();
+    scratch_->PushClipRectFullScreen();
+    
+    for (int part = 0; part < PART_COUNT; ++part) {
+        ImVec2 points[6];
+        int count = PartOutline(static_cast<Part>(part), mesh.height, points);
+        Range& range = mesh.parts[part];
+        range.vtx_begin = scratch_->VtxBuffer.Size;
+        range.idx_begin = scratch_->IdxBuffer.Size;
+        scratch_->AddConvexPolyFilled(points, count, IM_COL32_WHITE);
+        range.vtx_count = scratch_->VtxBuffer.Size - range.vtx_begin;
+        range.idx_count = scratch_->IdxBuffer.Size - range.idx_begin;
+    }
+    
+    mesh.vertices.assign(scratch_->VtxBuffer.Data, scratch_->VtxBuffer.Data + scratch_->VtxBuffer.Size);
+    mesh.indices.assign(scratch_->IdxBuffer.Data, scratch_->IdxBuffer.Data + scratch_->IdxBuffer.Size);
+    ++stats_.mesh_builds;
+}
+
+void SegmentDisplay::Text(float height, ImU32 lit, ImU32 unlit, const char* text) {
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems) return;
+    
+    height = ImMax(1.0f, ImTrunc(height + 0.5f));
+    const ImVec2 pos = window->DC.CursorPos;
+    const ImVec2 size(CalcWidth(height, text), height);
+    const ImRect bb(pos.x, pos.y, pos.x + size.x, pos.y + size.y);
+    ImGui::ItemSize(size);
+    if (!ImGui::ItemAdd(bb, 0)) return;
+    
+    ImDrawList* list = window->DrawList;
+    const int vtx_before = list->VtxBuffer.Size;
+    auto visible = [&](bool on) {
+        return ((on ? lit : unlit) & IM_COL32_A_MASK) != 0;
+    };
+    
+    if (!cached_) {
+        ForEachPart(height, text, [&](Part part, float x, bool on) {
+            if (!visible(on)) return;
+            ImVec2 points[6];
+            int count = PartOutline(part, height, points);
+            for (int i = 0; i < count; ++i) {
+                points[i].x += pos.x + x;
+                points[i].y += pos.y;
+            }
+            list->AddConvexPolyFilled(points, count, on ? lit : unlit);
+        });
+        stats_.vertices = list->VtxBuffer.Size - vtx_before;
+        return;
+    }
+    
+    const Mesh& mesh = GetMesh(height);
+    int vtx_count = 0, idx_count = 0;
+    ForEachPart(height, text, [&](Part part, float, bool on) {
+        if (!visible(on)) return;
+        vtx_count += mesh.parts[part].vtx_count;
+        idx_count += mesh.parts[part].idx_count;
+    });
+    if (vtx_count == 0) return;
+    
+    // Meshes never sample the atlas beyond its white pixel, so they outlive
+    // atlas rebuilds; the current one is written on the way out
+    const ImVec2 white = list->_Data->TexUvWhitePixel;
+    list->PrimReserve(idx_count, vtx_count);
+    ForEachPart(height, text, [&](Part part, float x, bool on) {
+        if (!visible(on)) return;
+        const Range& range = mesh.parts[part];
+        const ImU32 color = on ? lit : unlit;
+        const ImU32 fringe = color & ~IM_COL32_A_MASK;
+        const unsigned int base = list->_VtxCurrentIdx;
+        ImDrawVert* vtx = list->_VtxWritePtr;
+        for (int i = 0; i < range.vtx_count; ++i) {
+            const ImDrawVert& source = mesh.vertices[range.vtx_begin + i];
+            vtx[i].pos = ImVec2(source.pos.x + pos.x + x, source.pos.y + pos.y);
+            vtx[i].uv = white;
+            vtx[i].col = (source.col & IM_COL32_A_MASK) ? color : fringe;
+        }
+        ImDrawIdx* idx = list->_IdxWritePtr;
+        for (int i = 0; i < range.idx_count; ++i) {
+            idx[i] = static_cast<ImDrawIdx>(base + mesh.indices[range.idx_begin + i] - range.vtx_begin);
+        }
+        list->_VtxWritePtr += range.vtx_count;
+        list->_IdxWritePtr += range.idx_count;
+        list->_VtxCurrentIdx += range.vtx_count;
+    });
+    stats_.vertices = vtx_count;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "imgui.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Seven-segment readout for clocks far larger than the font atlas should
+// hold. Each digit is lit segments out of seven hexagons; colon and point
+// are squares. Shapes are filled by ImDrawList::AddConvexPolyFilled,
+// whose one-pixel alpha fringe anti-aliases edges at any size, and use
+// only the atlas's white pixel -- no glyphs are baked.
+//
+// The segment meshes for a digit height are tessellated once and kept
+// without color; drawing copies the parts a string needs, translated and
+// colored. Unlit segments can be drawn faintly, like a real display.
+// Characters besides 0-9 : . - and space leave a blank digit cell.
+class SegmentDisplay {
+public:
+    struct Stats {
+        uint64_t mesh_builds = 0;
+        int vertices = 0;      // in the last string drawn
+    };
+    
+    // Height of the digits in pixels; unlit segments in `unlit` (alpha 0
+    // to leave them out)
+    void Text(float height, ImU32 lit, ImU32 unlit, const char* text);
+    
+    // Width of `text` at the given height
+    static float CalcWidth(float height, const char* text);
+    
+    // Uncached, segments are tessellated every frame (for A/B measurements)
+    void SetCached(bool cached) { cached_ = cached; }
+    bool IsCached() const { return cached_; }
+    
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    enum Part {
+        SegmentA, SegmentB, SegmentC, SegmentD, SegmentE, SegmentF, SegmentG,
+        ColonTop, ColonBottom, Point,
+        PART_COUNT
+    };
+    
+    struct Range {
+        int vtx_begin = 0, vtx_count = 0;
+        int idx_begin = 0, idx_count = 0;
+    };
+    
+    // All parts at one height, relative to the cell's top left; vertex
+    // alpha marks the fringe
+    struct Mesh {
+        float height = 0.0f;
+        std::vector<ImDrawVert> vertices;
+        std::vector<ImDrawIdx> indices;
+        Range parts[PART_COUNT];
+        int last_frame = 0;
+    };
+    
+    // Outline of a part as a clockwise convex polygon
+    static int PartOutline(Part part, float height, ImVec2* points);
+    
+    Mesh& GetMesh(float height);
+    void BuildMesh(Mesh& mesh);
+    template <typename Emit>
+    void ForEachPart(float height, const char* text, Emit emit) const;
+    
+    std::vector<Mesh> meshes_;
+    std::unique_ptr<ImDrawList> scratch_;  // tessellates the meshes
+    Stats stats_;
+    bool cached_ = true;
+};
@@ -0,0 +1,682 @@
+#include "SoftwareRenderer.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SOFTWARERENDERER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SOFTWARERENDERER_TARGET_SSE41
+#define SOFTWARERENDERER_TARGET_AVX2
+#else
+#define SOFTWARERENDERER_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SOFTWARERENDERER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    constexpr int TILE_SIZE = 64;
+    constexpr int SUBPIXEL_BITS = 4;
+    constexpr int64_t SUBPIXEL = 1 << SUBPIXEL_BITS;
+    constexpr int64_t HALF_PIXEL = SUBPIXEL / 2;
+    constexpr float INV_255 = 1.0f / 255.0f;
+    
+    enum Attribute { R, G, B, A, U, V, ATTRIBUTES };
+    
+    enum class Fill : uint8_t {
+        Opaque,   // one color, alpha 255: plain stores
+        Shaded,   // interpolated color, no texture
+        Textured
+    };
+    
+    // Nearest texel, clamped; as RGBA with Alpha8 read as white
+    uint32_t SampleTexel(const ImTextureData* texture, float u, float v) {
+        int x = std::min(std::max(static_cast<int>(u * texture->Width), 0), texture->Width - 1);
+        int y = std::min(std::max(static_cast<int>(v * texture->Height), 0), texture->Height - 1);
+        if (texture->BytesPerPixel == 1) {
+            uint32_t alpha = texture->Pixels[y * texture->Width + x];
+            return 0x00FFFFFFu | (alpha << 24);
+        }
+        uint32_t texel;
+        std::memcpy(&texel, texture->Pixels + (static_cast<size_t>(y) * texture->Width + x) * 4, sizeof(texel));
+        return texel;
+    }
+    
+    int64_t FloorDiv(int64_t a, int64_t b) { // b > 0
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+    
+    int64_t CeilDiv(int64_t a, int64_t b) { // b > 0
+        return -FloorDiv(-a, b);
+    }
+    
+    // One row's run of covered pixels and the attributes at its first pixel
+    struct Span {
+        float value[ATTRIBUTES];
+        float step[ATTRIBUTES];    // per pixel in x
+        const ImTextureData* texture;
+        uint32_t color;            // Fill::Opaque
+        Fill fill;
+    };
+    
+    // src over dst with ImGui's blend state: color SRC_ALPHA / INV_SRC_ALPHA,
+    // alpha ONE / INV_SRC_ALPHA. Channels are 0..255 floats.
+    uint32_t BlendPixel(float r, float g, float b, float a, uint32_t dst) {
+        r = std::min(std::max(r, 0.0f), 255.0f);
+        g = std::min(std::max(g, 0.0f), 255.0f);
+        b = std::min(std::max(b, 0.0f), 255.0f);
+        a = std::min(std::max(a, 0.0f), 255.0f);
+        float f = a * INV_255;
+        float inv = 1.0f - f;
+        auto channel = [&](float src, int shift, float weight) {
+            float out = src * weight + static_cast<float>((dst >> shift) & 0xFF) * inv;
+            return static_cast<uint32_t>(out + 0.5f) << shift;
+        };
+        return channel(r, 0, f) | channel(g, 8, f) | channel(b, 16, f) | channel(a, 24, 1.0f);
+    }
+    
+    uint32_t ShadePixel(const float* value, const ImTextureData* texture, uint32_t dst) {
+        float r = value[R], g = value[G], b = value[B], a = value[A];
+        if (texture) {
+            uint32_t texel = SampleTexel(texture, value[U], value[V]);
+            r *= static_cast<float>(texel & 0xFF) * INV_255;
+            g *= static_cast<float>((texel >> 8) & 0xFF) * INV_255;
+            b *= static_cast<float>((texel >> 16) & 0xFF) * INV_255;
+            a *= static_cast<float>(texel >> 24) * INV_255;
+        }
+        return BlendPixel(r, g, b, a, dst);
+    }
+    
+    void FillScalar(const Span& span, uint32_t* dst, int count) {
+        if (span.fill == Fill::Opaque) {
+            std::fill(dst, dst + count, span.color);
+            return;
+        }
+        float value[ATTRIBUTES];
+        std::copy(span.value, span.value + ATTRIBUTES, value);
+        const ImTextureData* texture = span.fill == Fill::Textured ? span.texture : nullptr;
+        for (int i = 0; i < count; ++i) {
+            dst[i] = ShadePixel(value, texture, dst[i]);
+            for (int k = 0; k < ATTRIBUTES; ++k) value[k] += span.step[k];
+        }
+    }
+    
+    // Finishes a span from pixel `done` on with the scalar code
+    void FillTail(const Span& span, uint32_t* dst, int done, int count) {
+        if (done >= count) return;
+        Span tail = span;
+        for (int k = 0; k < ATTRIBUTES; ++k) tail.value[k] += span.step[k] * done;
+        FillScalar(tail, dst + done, count - done);
+    }
+
+#ifdef SOFTWARERENDERER_X86
+#ifdef _MSC_VER
+    bool CpuHas(int leaf, int reg, int bit) {
+        int info[4];
+        __cpuidex(info, leaf, 0);
+        return (info[reg] & (1 << bit)) != 0;
+    }
+#endif
+
+    bool CpuHasSse41() {
+#ifdef _MSC_VER
+        return CpuHas(1, 2, 19);
+#else
+        return __builtin_cpu_supports("sse4.1");
+#endif
+    }
+    
+    bool CpuHasAvx2() {
+#ifdef _MSC_VER
+        bool os_saves_ymm = CpuHas(1, 2, 27) && CpuHas(1, 2, 28) && (_xgetbv(0) & 0x6) == 0x6;
+        return os_saves_ymm && CpuHas(7, 1, 5);
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+    
+    SOFTWARERENDERER_TARGET_SSE41
+    void FillSse41(const Span& span, uint32_t* dst, int count) {
+        if (span.fill == Fill::Opaque) {
+            const __m128i color = _mm_set1_epi32(static_cast<int>(span.color));
+            int i = 0;
+            for (; i + 4 <= count; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), color);
+            std::fill(dst + i, dst + count, span.color);
+            return;
+        }
+        
+        const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 value[ATTRIBUTES];
+        __m128 step[ATTRIBUTES];
+        for (int k = 0; k < ATTRIBUTES; ++k) {
+            value[k] = _mm_add_ps(_mm_set1_ps(span.value[k]), _mm_mul_ps(lane, _mm_set1_ps(span.step[k])));
+            step[k] = _mm_set1_ps(span.step[k] * 4.0f);
+        }
+        
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 max_channel = _mm_set1_ps(255.0f);
+        const __m128 inv_255 = _mm_set1_ps(INV_255);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i byte = _mm_set1_epi32(0xFF);
+        const ImTextureData* texture = span.fill == Fill::Textured ? span.texture : nullptr;
+        
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 r = value[R], g = value[G], b = value[B], a = value[A];
+            if (texture) {
+                // No gather before AVX2: index four texels and load them one by one
+                __m128i x = _mm_cvttps_epi32(_mm_mul_ps(value[U], _mm_set1_ps(static_cast<float>(texture->Width))));
+                __m128i y = _mm_cvttps_epi32(_mm_mul_ps(value[V], _mm_set1_ps(static_cast<float>(texture->Height))));
+                x = _mm_min_epi32(_mm_max_epi32(x, _mm_setzero_si128()), _mm_set1_epi32(texture->Width - 1));
+                y = _mm_min_epi32(_mm_max_epi32(y, _mm_setzero_si128()), _mm_set1_epi32(texture->Height - 1));
+                alignas(16) int32_t index[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_add_epi32(_mm_mullo_epi32(y, _mm_set1_epi32(texture->Width)), x));
+                if (texture->BytesPerPixel == 1) {
+                    const uint8_t* texels = texture->Pixels;
+                    __m128 alpha = _mm_cvtepi32_ps(_mm_setr_epi32(texels[index[0]], texels[index[1]], texels[index[2]], texels[index[3]]));
+                    a = _mm_mul_ps(a, _mm_mul_ps(alpha, inv_255));
+                } else {
+                    const uint32_t* texels = reinterpret_cast<const uint32_t*>(texture->Pixels);
+                    __m128i texel = _mm_setr_epi32(static_cast<int>(texels[index[0]]), static_cast<int>(texels[index[1]]),
+                                                   static_cast<int>(texels[index[2]]), static_cast<int>(texels[index[3]]));
+                    r = _mm_mul_ps(r, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(texel, byte)), inv_255));
+                    g = _mm_mul_ps(g, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texel, 8), byte)), inv_255));
+                    b = _mm_mul_ps(b, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texel, 16), byte)), inv_255));
+                    a = _mm_mul_ps(a, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(texel, 24)), inv_255));
+                }
+            }
+            r = _mm_min_ps(_mm_max_ps(r, zero), max_channel);
+            g = _mm_min_ps(_mm_max_ps(g, zero), max_channel);
+            b = _mm_min_ps(_mm_max_ps(b, zero), max_channel);
+            a = _mm_min_ps(_mm_max_ps(a, zero), max_channel);
+            
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128 f = _mm_mul_ps(a, inv_255);
+            __m128 inv = _mm_sub_ps(one, f);
+            __m128 out_r = _mm_add_ps(_mm_mul_ps(r, f), _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(d, byte)), inv));
+            __m128 out_g = _mm_add_ps(_mm_mul_ps(g, f), _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(d, 8), byte)), inv));
+            __m128 out_b = _mm_add_ps(_mm_mul_ps(b, f), _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(d, 16), byte)), inv));
+            __m128 out_a = _mm_add_ps(a, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(d, 24)), inv));
+            __m128i out = _mm_or_si128(
+                _mm_or_si128(_mm_cvtps_epi32(out_r), _mm_slli_epi32(_mm_cvtps_epi32(out_g), 8)),
+                _mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(out_b), 16), _mm_slli_epi32(_mm_cvtps_epi32(out_a), 24)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+            
+            for (int k = 0; k < ATTRIBUTES; ++k) value[k] = _mm_add_ps(value[k], step[k]);
+        }
+        FillTail(span, dst, i, count);
+    }
+    
+    SOFTWARERENDERER_TARGET_AVX2
+    void FillAvx2(const Span& span, uint32_t* dst, int count) {
+        if (span.fill == Fill::Opaque) {
+            const __m256i color = _mm256_set1_epi32(static_cast<int>(span.color));
+            int i = 0;
+            for (; i + 8 <= count; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), color);
+            std::fill(dst + i, dst + count, span.color);
+            return;
+        }
+        
+        const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        __m256 value[ATTRIBUTES];
+        __m256 step[ATTRIBUTES];
+        for (int k = 0; k < ATTRIBUTES; ++k) {
+            value[k] = _mm256_add_ps(_mm256_set1_ps(span.value[k]), _mm256_mul_ps(lane, _mm256_set1_ps(span.step[k])));
+            step[k] = _mm256_set1_ps(span.step[k] * 8.0f);
+        }
+        
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 max_channel = _mm256_set1_ps(255.0f);
+        const __m256 inv_255 = _mm256_set1_ps(INV_255);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i byte = _mm256_set1_epi32(0xFF);
+        const ImTextureData* texture = span.fill == Fill::Textured ? span.texture : nullptr;
+        
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 r = value[R], g = value[G], b = value[B], a = value[A];
+            if (texture) {
+                __m256i x = _mm256_cvttps_epi32(_mm256_mul_ps(value[U], _mm256_set1_ps(static_cast<float>(texture->Width))));
+                __m256i y = _mm256_cvttps_epi32(_mm256_mul_ps(value[V], _mm256_set1_ps(static_cast<float>(texture->Height))));
+                x = _mm256_min_epi32(_mm256_max_epi32(x, _mm256_setzero_si256()), _mm256_set1_epi32(texture->Width - 1));
+                y = _mm256_min_epi32(_mm256_max_epi32(y, _mm256_setzero_si256()), _mm256_set1_epi32(texture->Height - 1));
+                __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(y, _mm256_set1_epi32(texture->Width)), x);
+                if (texture->BytesPerPixel == 1) {
+                    // Gather the aligned dword holding each byte so no lane
+                    // reads past the end of the texture
+                    const int* words = reinterpret_cast<const int*>(texture->Pixels);
+                    __m256i word = _mm256_i32gather_epi32(words, _mm256_srli_epi32(index, 2), 4);
+                    __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(3)), 3);
+                    __m256 alpha = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srlv_epi32(word, shift), byte));
+                    a = _mm256_mul_ps(a, _mm256_mul_ps(alpha, inv_255));
+                } else {
+                    __m256i texel = _mm256_i32gather_epi32(reinterpret_cast<const int*>(texture->Pixels), index, 4);
+                    r = _mm256_mul_ps(r, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(texel, byte)), inv_255));
+                    g = _mm256_mul_ps(g, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texel, 8), byte)), inv_255));
+                    b = _mm256_mul_ps(b, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texel, 16), byte)), inv_255));
+                    a = _mm256_mul_ps(a, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(texel, 24)), inv_255));
+                }
+            }
+            r = _mm256_min_ps(_mm256_max_ps(r, zero), max_channel);
+            g = _mm256_min_ps(_mm256_max_ps(g, zero), max_channel);
+            b = _mm256_min_ps(_mm256_max_ps(b, zero), max_channel);
+            a = _mm256_min_ps(_mm256_max_ps(a, zero), max_channel);
+            
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256 f = _mm256_mul_ps(a, inv_255);
+            __m256 inv = _mm256_sub_ps(one, f);
+            __m256 out_r = _mm256_add_ps(_mm256_mul_ps(r, f), _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(d, byte)), inv));
+            __m256 out_g = _mm256_add_ps(_mm256_mul_ps(g, f), _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(d, 8), byte)), inv));
+            __m256 out_b = _mm256_add_ps(_mm256_mul_ps(b, f), _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(d, 16), byte)), inv));
+            __m256 out_a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(d, 24)), inv));
+            __m256i out = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cvtps_epi32(out_r), _mm256_slli_epi32(_mm256_cvtps_epi32(out_g), 8)),
+                _mm256_or_si256(_mm256_slli_epi32(_mm256_cvtps_epi32(out_b), 16), _mm256_slli_epi32(_mm256_cvtps_epi32(out_a), 24)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+            
+            for (int k = 0; k < ATTRIBUTES; ++k) value[k] = _mm256_add_ps(value[k], step[k]);
+        }
+        FillTail(span, dst, i, count);
+    }
+#endif
+
+    using FillKernel = void (*)(const Span& span, uint32_t* dst, int count);
+    
+    FillKernel SelectFill(SoftwareRenderer::Kernel kernel) {
+        switch (kernel) {
+#ifdef SOFTWARERENDERER_X86
+            case SoftwareRenderer::Kernel::Avx2: return FillAvx2;
+            case SoftwareRenderer::Kernel::Sse41: return FillSse41;
+#endif
+            default: return FillScalar;
+        }
+    }
+}
+
+// Edge functions E(x, y) = a*x + b*y + c over 1/16-pixel coordinates, positive
+// inside; a pixel is covered when E + bias >= 0 for all three edges at its
+// center, which with bias -1 on non-top-left edges is the top-left rule.
+// Attributes are planes in pixel space, evaluated at pixel centers.
+struct SoftwareRenderer::Triangle {
+    int64_t a[3];
+    int64_t b[3];
+    int64_t c[3];
+    int64_t bias[3];
+    int x0, y0, x1, y1;     // covered pixel bounds within the clip rect, end exclusive
+    float base[ATTRIBUTES]; // at pixel (0, 0)
+    float dx[ATTRIBUTES];
+    float dy[ATTRIBUTES];
+    const ImTextureData* texture;
+    uint32_t color;
+    Fill fill;
+    
+    // Covered run of row y within [min_x, max_x); false if empty
+    bool RowSpan(int y, int min_x, int max_x, int& begin, int& end) const {
+        int64_t lo = min_x;
+        int64_t hi = max_x;
+        int64_t center_y = y * SUBPIXEL + HALF_PIXEL;
+        for (int i = 0; i < 3; ++i) {
+            // E + bias at the center of pixel x is row + step * x
+            int64_t row = a[i] * HALF_PIXEL + b[i] * center_y + c[i] + bias[i];
+            int64_t step = a[i] * SUBPIXEL;
+            if (step > 0) {
+                lo = std::max(lo, CeilDiv(-row, step));
+            } else if (step < 0) {
+                hi = std::min(hi, FloorDiv(row, -step) + 1);
+            } else if (row < 0) {
+                return false;
+            }
+        }
+        if (lo >= hi) return false;
+        begin = static_cast<int>(lo);
+        end = static_cast<int>(hi);
+        return true;
+    }
+    
+    bool Covers(int x, int y) const {
+        int64_t px = x * SUBPIXEL + HALF_PIXEL;
+        int64_t py = y * SUBPIXEL + HALF_PIXEL;
+        for (int i = 0; i < 3; ++i) {
+            if (a[i] * px + b[i] * py + c[i] + bias[i] < 0) return false;
+        }
+        return true;
+    }
+};
+
+SoftwareRenderer::SoftwareRenderer(Kernel kernel, unsigned threads)
+    : kernel_(IsSupported(kernel) ? kernel : Kernel::Scalar)
+    , clear_color_(IM_COL32(0, 0, 0, 255))
+    , width_(0)
+    , height_(0)
+    , tiles_x_(0)
+    , tiles_y_(0)
+    , next_tile_(0)
+    , generation_(0)
+    , busy_(0)
+    , stopping_(false) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (kernel_ == Kernel::Reference) threads = 1;
+    for (unsigned i = 1; i < threads; ++i) {
+        workers_.emplace_back(&SoftwareRenderer::WorkerLoop, this);
+    }
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+}
+
+void SoftwareRenderer::ConfigureContext() {
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendRendererName = "software";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+    // One byte per texel is all the atlas needs and a quarter of the reads
+    io.Fonts->TexDesiredFormat = ImTextureFormat_Alpha8;
+}
+
+bool SoftwareRenderer::IsSupported(Kernel kernel) {
+    switch (kernel) {
+#ifdef SOFTWARERENDERER_X86
+        case Kernel::Avx2: {
+            static const bool avx2 = CpuHasAvx2();
+            return avx2;
+        }
+        case Kernel::Sse41: {
+            static const bool sse41 = CpuHasSse41();
+            return sse41;
+        }
+#else
+        case Kernel::Avx2:
+        case Kernel::Sse41:
+            return false;
+#endif
+        default:
+            return true;
+    }
+}
+
+SoftwareRenderer::Kernel SoftwareRenderer::GetBestKernel() {
+    if (IsSupported(Kernel::Avx2)) return Kernel::Avx2;
+    if (IsSupported(Kernel::Sse41)) return Kernel::Sse41;
+    return Kernel::Scalar;
+}
+
+const char* SoftwareRenderer::GetKernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Reference: return "reference";
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Sse41: return "SSE4.1";
+        case Kernel::Avx2: return "AVX2";
+    }
+    return "unknown";
+}
+
+void SoftwareRenderer::UpdateTexture(ImTextureData* texture) {
+    // Sampled in place from ImGui's pixels, so there is nothing to upload
+    if (texture->Status == ImTextureStatus_WantCreate || texture->Status == ImTextureStatus_WantUpdates) {
+        texture->SetTexID(static_cast<ImTextureID>(reinterpret_cast<intptr_t>(texture)));
+        texture->SetStatus(ImTextureStatus_OK);
+    } else if (texture->Status == ImTextureStatus_WantDestroy && texture->UnusedFrames > 0) {
+        texture->SetTexID(ImTextureID_Invalid);
+        texture->SetStatus(ImTextureStatus_Destroyed);
+    }
+}
+
+void SoftwareRenderer::RenderDrawData(ImDrawData* draw_data) {
+    if (draw_data->Textures) {
+        for (ImTextureData* texture : *draw_data->Textures) {
+            if (texture->Status != ImTextureStatus_OK) UpdateTexture(texture);
+        }
+    }
+    
+    int width = static_cast<int>(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    int height = static_cast<int>(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    if (width <= 0 || height <= 0) return;
+    if (width != width_ || height != height_) {
+        width_ = width;
+        height_ = height;
+        pixels_.assign(static_cast<size_t>(width) * height, clear_color_);
+        tiles_x_ = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tiles_y_ = (height + TILE_SIZE - 1) / TILE_SIZE;
+        bins_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+    }
+    
+    SetupTriangles(draw_data);
+    
+    if (kernel_ == Kernel::Reference) {
+        DrawReference();
+        return;
+    }
+    
+    BinTriangles();
+    next_tile_.store(0, std::memory_order_relaxed);
+    if (workers_.empty()) {
+        DrawTiles();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        busy_ = static_cast<unsigned>(workers_.size());
+    }
+    start_.notify_all();
+    DrawTiles();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+}
+
+void SoftwareRenderer::SetupTriangles(ImDrawData* draw_data) {
+    triangles_.clear();
+    const ImVec2 origin = draw_data->DisplayPos;
+    const ImVec2 scale = draw_data->FramebufferScale;
+    
+    for (const ImDrawList* list : draw_data->CmdLists) {
+        const ImDrawVert* vertices = list->VtxBuffer.Data;
+        const ImDrawIdx* indices = list->IdxBuffer.Data;
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.UserCallback) {
+                // ResetRenderState means nothing here; other callbacks get
+                // their chance but draw outside the tile pass
+                if (cmd.UserCallback != ImDrawCallback_ResetRenderState) cmd.UserCallback(list, &cmd);
+                continue;
+            }
+            
+            // Scissor as the GPU backends do: truncated, end exclusive
+            int clip_x0 = std::max(static_cast<int>((cmd.ClipRect.x - origin.x) * scale.x), 0);
+            int clip_y0 = std::max(static_cast<int>((cmd.ClipRect.y - origin.y) * scale.y), 0);
+            int clip_x1 = std::min(static_cast<int>((cmd.ClipRect.z - origin.x) * scale.x), width_);
+            int clip_y1 = std::min(static_cast<int>((cmd.ClipRect.w - origin.y) * scale.y), height_);
+            if (clip_x0 >= clip_x1 || clip_y0 >= clip_y1) continue;
+            
+            const ImTextureData* texture = reinterpret_cast<const ImTextureData*>(static_cast<intptr_t>(cmd.GetTexID()));
+            for (unsigned int e = 0; e + 2 < cmd.ElemCount; e += 3) {
+                const ImDrawVert* v[3];
+                for (int k = 0; k < 3; ++k) v[k] = &vertices[cmd.VtxOffset + indices[cmd.IdxOffset + e + k]];
+                
+                double px[3], py[3];
+                int64_t fx[3], fy[3];
+                for (int k = 0; k < 3; ++k) {
+                    px[k] = (v[k]->pos.x - origin.x) * scale.x;
+                    py[k] = (v[k]->pos.y - origin.y) * scale.y;
+                    fx[k] = static_cast<int64_t>(std::lround(px[k] * SUBPIXEL));
+                    fy[k] = static_cast<int64_t>(std::lround(py[k] * SUBPIXEL));
+                }
+                int64_t area = (fx[1] - fx[0]) * (fy[2] - fy[0]) - (fx[2] - fx[0]) * (fy[1] - fy[0]);
+                if (area == 0) continue;
+                if (area < 0) {
+                    std::swap(v[1], v[2]);
+                    std::swap(px[1], px[2]);
+                    std::swap(py[1], py[2]);
+                    std::swap(fx[1], fx[2]);
+                    std::swap(fy[1], fy[2]);
+                }
+                
+                // Pixels whose centers fall inside the bounding box and clip rect
+                int64_t min_fx = std::min({fx[0], fx[1], fx[2]});
+                int64_t max_fx = std::max({fx[0], fx[1], fx[2]});
+                int64_t min_fy = std::min({fy[0], fy[1], fy[2]});
+                int64_t max_fy = std::max({fy[0], fy[1], fy[2]});
+                Triangle t;
+                t.x0 = std::max(clip_x0, static_cast<int>(CeilDiv(min_fx - HALF_PIXEL, SUBPIXEL)));
+                t.x1 = std::min(clip_x1, static_cast<int>(FloorDiv(max_fx - HALF_PIXEL, SUBPIXEL)) + 1);
+                t.y0 = std::max(clip_y0, static_cast<int>(CeilDiv(min_fy - HALF_PIXEL, SUBPIXEL)));
+                t.y1 = std::min(clip_y1, static_cast<int>(FloorDiv(max_fy - HALF_PIXEL, SUBPIXEL)) + 1);
+                if (t.x0 >= t.x1 || t.y0 >= t.y1) continue;
+                
+                for (int i = 0; i < 3; ++i) {
+                    int j = (i + 1) % 3;
+                    t.a[i] = fy[i] - fy[j];
+                    t.b[i] = fx[j] - fx[i];
+                    t.c[i] = -(t.a[i] * fx[i] + t.b[i] * fy[i]);
+                    bool top_left = t.a[i] > 0 || (t.a[i] == 0 && t.b[i] > 0);
+                    t.bias[i] = top_left ? 0 : -1;
+                }
+                
+                // Color per vertex; a texture read at one UV for the whole
+                // triangle (the white pixel under every solid shape) folds
+                // into it
+                float attribute[3][ATTRIBUTES];
+                bool flat_uv = v[0]->uv.x == v[1]->uv.x && v[0]->uv.x == v[2]->uv.x
+                    && v[0]->uv.y == v[1]->uv.y && v[0]->uv.y == v[2]->uv.y;
+                uint32_t flat_texel = flat_uv && texture ? SampleTexel(texture, v[0]->uv.x, v[0]->uv.y) : 0xFFFFFFFFu;
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t col = v[k]->col;
+                    for (int ch = 0; ch < 4; ++ch) {
+                        float channel = static_cast<float>((col >> (ch * 8)) & 0xFF);
+                        float texel = static_cast<float>((flat_texel >> (ch * 8)) & 0xFF);
+                        attribute[k][R + ch] = channel * texel * INV_255;
+                    }
+                    attribute[k][U] = v[k]->uv.x;
+                    attribute[k][V] = v[k]->uv.y;
+                }
+                
+                double det = (px[1] - px[0]) * (py[2] - py[0]) - (px[2] - px[0]) * (py[1] - py[0]);
+                for (int k = 0; k < ATTRIBUTES; ++k) {
+                    double d1 = attribute[1][k] - attribute[0][k];
+                    double d2 = attribute[2][k] - attribute[0][k];
+                    double dx = det != 0.0 ? (d1 * (py[2] - py[0]) - d2 * (py[1] - py[0])) / det : 0.0;
+                    double dy = det != 0.0 ? (d2 * (px[1] - px[0]) - d1 * (px[2] - px[0])) / det : 0.0;
+                    t.dx[k] = static_cast<float>(dx);
+                    t.dy[k] = static_cast<float>(dy);
+                    t.base[k] = static_cast<float>(attribute[0][k] + dx * (0.5 - px[0]) + dy * (0.5 - py[0]));
+                }
+                
+                t.texture = flat_uv ? nullptr : texture;
+                t.color = 0;
+                if (t.texture) {
+                    t.fill = Fill::Textured;
+                } else if (v[0]->col == v[1]->col && v[0]->col == v[2]->col && (flat_texel >> 24) == 0xFF
+                           && (v[0]->col >> 24) == 0xFF) {
+                    t.fill = Fill::Opaque;
+                    for (int ch = 0; ch < 4; ++ch) {
+                        uint32_t channel = static_cast<uint32_t>(attribute[0][R + ch] + 0.5f);
+                        t.color |= std::min(channel, 255u) << (ch * 8);
+                    }
+                } else {
+                    t.fill = Fill::Shaded;
+                }
+                triangles_.push_back(t);
+            }
+        }
+    }
+    stats_.triangles = triangles_.size();
+}
+
+void SoftwareRenderer::BinTriangles() {
+    for (std::vector<uint32_t>& bin : bins_) bin.clear();
+    uint64_t binned = 0;
+    for (uint32_t index = 0; index < triangles_.size(); ++index) {
+        const Triangle& t = triangles_[index];
+        int tx0 = t.x0 / TILE_SIZE, tx1 = (t.x1 - 1) / TILE_SIZE;
+        int ty0 = t.y0 / TILE_SIZE, ty1 = (t.y1 - 1) / TILE_SIZE;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                bins_[static_cast<size_t>(ty) * tiles_x_ + tx].push_back(index);
+            }
+        }
+        binned += static_cast<uint64_t>(tx1 - tx0 + 1) * (ty1 - ty0 + 1);
+    }
+    stats_.binned = binned;
+}
+
+void SoftwareRenderer::DrawTiles() {
+    const int tiles = tiles_x_ * tiles_y_;
+    for (;;) {
+        int tile = next_tile_.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= tiles) return;
+        DrawTile(tile);
+    }
+}
+
+void SoftwareRenderer::DrawTile(int tile) {
+    const FillKernel fill = SelectFill(kernel_);
+    const int x0 = (tile % tiles_x_) * TILE_SIZE;
+    const int y0 = (tile / tiles_x_) * TILE_SIZE;
+    const int x1 = std::min(x0 + TILE_SIZE, width_);
+    const int y1 = std::min(y0 + TILE_SIZE, height_);
+    
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = &pixels_[static_cast<size_t>(y) * width_];
+        std::fill(row + x0, row + x1, clear_color_);
+    }
+    
+    for (uint32_t index : bins_[tile]) {
+        const Triangle& t = triangles_[index];
+        const int min_x = std::max(t.x0, x0);
+        const int max_x = std::min(t.x1, x1);
+        const int max_y = std::min(t.y1, y1);
+        Span span;
+        span.texture = t.texture;
+        span.color = t.color;
+        span.fill = t.fill;
+        std::copy(t.dx, t.dx + ATTRIBUTES, span.step);
+        for (int y = std::max(t.y0, y0); y < max_y; ++y) {
+            int begin, end;
+            if (!t.RowSpan(y, min_x, max_x, begin, end)) continue;
+            for (int k = 0; k < ATTRIBUTES; ++k) {
+                span.value[k] = t.base[k] + t.dx[k] * begin + t.dy[k] * y;
+            }
+            fill(span, &pixels_[static_cast<size_t>(y) * width_ + begin], end - begin);
+        }
+    }
+}
+
+void SoftwareRenderer::DrawReference() {
+    std::fill(pixels_.begin(), pixels_.end(), clear_color_);
+    for (const Triangle& t : triangles_) {
+        for (int y = t.y0; y < t.y1; ++y) {
+            for (int x = t.x0; x < t.x1; ++x) {
+                if (!t.Covers(x, y)) continue;
+                float value[ATTRIBUTES];
+                for (int k = 0; k < ATTRIBUTES; ++k) value[k] = t.base[k] + t.dx[k] * x + t.dy[k] * y;
+                uint32_t& pixel = pixels_[static_cast<size_t>(y) * width_ + x];
+                pixel = ShadePixel(value, t.texture, pixel);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::WorkerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+        DrawTiles();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+}
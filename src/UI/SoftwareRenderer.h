@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ImDrawData;
+struct ImTextureData;
+
+// Draws ImDrawData into an RGBA framebuffer on the CPU, for machines without
+// a GPU (kiosks, VNC sessions) and for screenshot tests.
+//
+// Triangles are set up once per frame and binned into 64x64 tiles; worker
+// threads then take whole tiles, so each pixel is blended by one thread in
+// submission order. Within a tile every triangle is filled row by row as
+// exact spans (fixed-point edge functions, top-left rule), and the spans run
+// through an SSE4.1 or AVX2 kernel picked at startup. Textures are sampled
+// nearest-neighbour straight from ImGui's own pixel copy; the font atlas is
+// requested as Alpha8.
+//
+// Texture IDs handed to ImGui are the ImTextureData pointers themselves.
+class SoftwareRenderer {
+public:
+    enum class Kernel {
+        Reference, // per-pixel, single-threaded, no fast paths
+        Scalar,
+        Sse41,
+        Avx2
+    };
+    
+    struct Stats {
+        uint64_t triangles = 0;  // set up last frame, after culling
+        uint64_t binned = 0;     // triangle-tile pairs
+    };
+    
+    // threads == 0 uses one per hardware thread
+    explicit SoftwareRenderer(Kernel kernel = GetBestKernel(), unsigned threads = 0);
+    ~SoftwareRenderer();
+    
+    SoftwareRenderer(const SoftwareRenderer&) = delete;
+    SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+    
+    // Sets the backend flags and texture format; call after creating the
+    // context and before the first frame
+    static void ConfigureContext();
+    
+    // Handles draw_data->Textures, then clears and draws the frame. The
+    // framebuffer follows DisplaySize * FramebufferScale.
+    void RenderDrawData(ImDrawData* draw_data);
+    
+    void SetClearColor(uint32_t rgba) { clear_color_ = rgba; }
+    
+    // RGBA8, R in the low byte (ImU32 layout), rows packed
+    const uint32_t* GetPixels() const { return pixels_.data(); }
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    
+    Kernel GetKernel() const { return kernel_; }
+    unsigned GetThreadCount() const { return static_cast<unsigned>(workers_.size()) + 1; }
+    Stats GetStats() const { return stats_; }
+    
+    static bool IsSupported(Kernel kernel);
+    static Kernel GetBestKernel();
+    static const char* GetKernelName(Kernel kernel);
+    
+    struct Triangle;
+
+private:
+    static void UpdateTexture(ImTextureData* texture);
+    
+    void SetupTriangles(ImDrawData* draw_data);
+    void BinTriangles();
+    void DrawTiles();   // any thread, until no tiles are left
+    void DrawTile(int tile);
+    void DrawReference();
+    void WorkerLoop();
+    
+    const Kernel kernel_;
+    uint32_t clear_color_;
+    
+    std::vector<uint32_t> pixels_;
+    int width_;
+    int height_;
+    int tiles_x_;
+    int tiles_y_;
+    
+    std::vector<Triangle> triangles_;
+    std::vector<std::vector<uint32_t>> bins_;  // triangle indices per tile, in draw order
+    std::atomic<int> next_tile_;
+    Stats stats_;
+    
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    uint64_t generation_;
+    unsigned busy_;
+    bool stopping_;
+};
@@ -0,0 +1,752 @@
+#include "TimeAppView.h"
+#include "../TimeApplication.h"
+#include "../TimeFormat.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const TimeFormat LAP_FORMAT("[HH:]MM:SS.fff");
+    const TimeFormat CLOCK_FORMAT("%H:%M:%S");
+    const TimeFormat CLOCK_FORMAT_MS("%H:%M:%S.fff");
+    const TimeFormat ALARM_FORMAT("%a %d %b %H:%M");
+    
+    // An input older than this cannot be what pressed a button this frame
+    constexpr auto MAX_INPUT_AGE = std::chrono::milliseconds(250);
+    
+    // How often to redraw for a blinking text cursor or a pending NTP reply
+    constexpr auto CURSOR_BLINK_POLL = std::chrono::milliseconds(100);
+    constexpr auto NTP_STATUS_POLL = std::chrono::milliseconds(100);
+    
+    constexpr float ANALOG_CLOCK_DIAMETER = 160.0f;
+    
+    // The wall display fills the width, up to this share of the height
+    constexpr float WALL_DISPLAY_MAX_HEIGHT = 0.4f;
+    const ImVec4 CLOCK_COLOR(0.8f, 0.9f, 1.0f, 1.0f);
+    
+    void FormatLapTime(std::chrono::nanoseconds time, char* buffer, size_t size) {
+        LAP_FORMAT.Format(TimeFields::FromDuration(time), buffer, size);
+    }
+}
+
+TimeAppView::TimeAppView(TimeApplication& app)
+    : app_(app)
+    , select_tab_(-1)
+    , countdown_input_minutes_(5)
+    , countdown_input_seconds_(0)
+    , show_milliseconds_(false)
+    , show_analog_clock_(false)
+    , show_wall_display_(false)
+    , interval_work_minutes_(25)
+    , interval_break_minutes_(5)
+    , interval_long_break_minutes_(15)
+    , interval_rounds_(4)
+    , alarm_input_hour_(7)
+    , alarm_input_minute_(0)
+    , alarm_cron_error_(false)
+    , alarm_list_size_(SIZE_MAX)
+    , alarm_list_fired_(0)
+    , timer_input_minutes_(10) {
+    world_clock_input_[0] = '\0';
+    alarm_label_input_[0] = '\0';
+    alarm_cron_input_[0] = '\0';
+    alarm_zone_input_[0] = '\0';
+    timer_name_input_[0] = '\0';
+}
+
+void TimeAppView::Render() {
+    // Main window
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    
+    ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoDecoration | 
+                                   ImGuiWindowFlags_NoResize | 
+                                   ImGuiWindowFlags_NoMove;
+    
+    auto tab_flags = [this](Tab tab) {
+        return select_tab_ == static_cast<int>(tab) ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+    };
+    
+    if (ImGui::Begin("Time Display Application", nullptr, window_flags)) {
+        
+        RenderTimeDisplay();
+        ImGui::Separator();
+        
+        RenderNTPControls();
+        ImGui::Separator();
+        
+        if (ImGui::BeginTabBar("TimerTabs")) {
+            if (ImGui::BeginTabItem("Stopwatch", nullptr, tab_flags(Tab::Stopwatch))) {
+                RenderStopwatch();
+                ImGui::EndTabItem();
+            }
+            
+            if (ImGui::BeginTabItem("Countdown", nullptr, tab_flags(Tab::Countdown))) {
+                RenderCountdown();
+                ImGui::EndTabItem();
+            }
+            
+            if (ImGui::BeginTabItem("Intervals", nullptr, tab_flags(Tab::Intervals))) {
+                RenderIntervals();
+                ImGui::EndTabItem();
+            }
+            
+            if (ImGui::BeginTabItem("World Clock", nullptr, tab_flags(Tab::WorldClock))) {
+                RenderWorldClock();
+                ImGui::EndTabItem();
+            }
+            
+            if (ImGui::BeginTabItem("Alarms", nullptr, tab_flags(Tab::Alarms))) {
+                RenderAlarms();
+                ImGui::EndTabItem();
+            }
+            
+            if (ImGui::BeginTabItem("Timers", nullptr, tab_flags(Tab::Timers))) {
+                RenderTimers();
+                ImGui::EndTabItem();
+            }
+            
+            ImGui::EndTabBar();
+        }
+        select_tab_ = -1;
+        
+        RenderStatusBar();
+    }
+    ImGui::End();
+    
+    // Anything being dragged or typed into is redrawn every frame
+    if (ImGui::IsAnyItemActive()) {
+        RequestFrames(1);
+    } else if (ImGui::GetIO().WantTextInput) {
+        RequestFrameAt(Clock::now() + CURSOR_BLINK_POLL);
+    }
+}
+
+TimeAppView::FrameRequest TimeAppView::TakeFrameRequest() {
+    FrameRequest request = frame_request_;
+    frame_request_ = FrameRequest();
+    return request;
+}
+
+void TimeAppView::SelectTab(Tab tab) {
+    select_tab_ = static_cast<int>(tab);
+}
+
+void TimeAppView::RequestFrames(int count) {
+    frame_request_.frames = std::max(frame_request_.frames, count);
+}
+
+void TimeAppView::RequestFrameAt(Clock::time_point when) {
+    frame_request_.at = std::min(frame_request_.at, when);
+}
+
+void TimeAppView::RenderTimeDisplay() {
+    PROFILE_SCOPE(profiler_, TimeDisplay);
+    auto local = app_.GetLocalZone().ToLocal(app_.GetCurrentTime());
+    char time_text[32];
+    FormatCurrentTime(local.fields, time_text, sizeof(time_text));
+    if (show_wall_display_) {
+        float height = std::min(ImGui::GetContentRegionAvail().x / SegmentDisplay::CalcWidth(1.0f, time_text),
+                                ImGui::GetIO().DisplaySize.y * WALL_DISPLAY_MAX_HEIGHT);
+        ImVec4 unlit = CLOCK_COLOR;
+        unlit.w = 0.06f;
+        wall_display_.Text(height, ImGui::GetColorU32(CLOCK_COLOR), ImGui::GetColorU32(unlit), time_text);
+    } else {
+        clock_digits_.TextColored(2.0f, CLOCK_COLOR, time_text);
+    }
+    if (show_analog_clock_) {
+        analog_clock_.Render(local.fields, ANALOG_CLOCK_DIAMETER, show_milliseconds_);
+    }
+    
+    if (show_milliseconds_) {
+        RequestFrames(1);
+    } else {
+        auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(app_.GetCurrentTime().time_since_epoch());
+        RequestSecondTick(wall);
+    }
+    
+    ImGui::Checkbox("Show Milliseconds", &show_milliseconds_);
+    ImGui::SameLine();
+    ImGui::Checkbox("Analog", &show_analog_clock_);
+    ImGui::SameLine();
+    ImGui::Checkbox("Wall Display", &show_wall_display_);
+}
+
+void TimeAppView::RenderNTPControls() {
+    PROFILE_SCOPE(profiler_, NTPControls);
+    if (static_geometry_.Button("Sync with NTP", ImVec2(120, 0))) {
+        app_.SyncTimeWithNTP();
+    }
+    
+    ImGui::SameLine();
+    if (app_.IsNTPSyncInProgress()) {
+        static_geometry_.TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Syncing...");
+        RequestFrameAt(Clock::now() + NTP_STATUS_POLL);
+    } else {
+        static_geometry_.TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Ready");
+    }
+}
+
+void TimeAppView::RenderStopwatch() {
+    PROFILE_SCOPE(profiler_, Stopwatch);
+    auto& stopwatch = app_.GetStopwatch();
+    
+    char time_text[32];
+    stopwatch.FormatTime(time_text, sizeof(time_text), show_milliseconds_);
+    clock_digits_.Text(1.5f, time_text);
+    
+    if (stopwatch.GetState() == Timer::State::Running) {
+        if (show_milliseconds_) {
+            RequestFrames(1);
+        } else {
+            RequestSecondTick(stopwatch.GetElapsedNanoseconds());
+        }
+    }
+    
+    ImGui::Spacing();
+    HandleStopwatchControls();
+    
+    auto clock = app_.GetTscClock().GetStatus();
+    if (clock.available) {
+        ImGui::TextDisabled("Clock: TSC %.3f GHz, drift %+.0f ns (max %.0f ns), correction %+.1f ppm",
+                            clock.frequency_hz / 1e9,
+                            static_cast<double>(clock.last_error.count()),
+                            static_cast<double>(clock.max_error.count()),
+                            clock.correction_ppm);
+    } else {
+        static_geometry_.TextDisabled("Clock: steady_clock");
+    }
+    
+    // What anchoring at the frame instead of the input would have added
+    if (input_corrections_ > 0) {
+        ImGui::TextDisabled("Input anchoring: last %.1f ms, mean %.1f ms, max %.1f ms earlier than the frame",
+                            input_correction_last_.count() / 1e6,
+                            input_correction_total_.count() / 1e6 / static_cast<double>(input_corrections_),
+                            input_correction_max_.count() / 1e6);
+    }
+    
+    auto hotkeys = app_.GetHotkeys().GetStats();
+    if (app_.GetHotkeys().IsRunning() && hotkeys.registered > 0) {
+        ImGui::TextDisabled("Hotkeys: Ctrl+Alt+S start/pause, Ctrl+Alt+L lap, Ctrl+Alt+X stop (%llu used, queue delay max %.0f ms)",
+                            static_cast<unsigned long long>(hotkeys.events),
+                            hotkeys.max_queue_delay.count() / 1e6);
+    }
+    
+    auto events = app_.GetStopwatchEvents().GetStats();
+    if (events.applied > 0 || events.dropped > 0) {
+        ImGui::TextDisabled("External events: %llu applied, %llu reordered, %llu dropped",
+                            static_cast<unsigned long long>(events.applied),
+                            static_cast<unsigned long long>(events.reordered),
+                            static_cast<unsigned long long>(events.dropped));
+    }
+    
+    RenderLaps();
+}
+
+void TimeAppView::RenderLaps() {
+    const auto& laps = app_.GetStopwatch().GetLaps();
+    if (laps.Empty()) return;
+    
+    const auto& stats = laps.GetStats();
+    char best[32], worst[32], mean[32], stddev[32];
+    FormatLapTime(stats.min, best, sizeof(best));
+    FormatLapTime(stats.max, worst, sizeof(worst));
+    FormatLapTime(stats.mean, mean, sizeof(mean));
+    FormatLapTime(stats.stddev, stddev, sizeof(stddev));
+    
+    ImGui::Text("Laps: %zu  Best: %s (#%zu)  Worst: %s (#%zu)",
+                stats.count, best, stats.best_index + 1, worst, stats.worst_index + 1);
+    ImGui::Text("Mean: %s  Std dev: %s", mean, stddev);
+    
+    // Newest lap first; only the visible rows are formatted
+    if (ImGui::BeginChild("LapList", ImVec2(0, 0), ImGuiChildFlags_Borders)) {
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(laps.Size()));
+        while (clipper.Step()) {
+            // Walk back from the newest visible split, one subtraction per row
+            size_t index = laps.Size() - 1 - static_cast<size_t>(clipper.DisplayStart);
+            auto split = laps.GetSplit(index);
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row, --index) {
+                auto lap = laps.GetLap(index);
+                char lap_text[32], split_text[32];
+                FormatLapTime(lap, lap_text, sizeof(lap_text));
+                FormatLapTime(split, split_text, sizeof(split_text));
+                ImGui::Text("#%-6zu %s   %s", index + 1, lap_text, split_text);
+                split -= lap;
+            }
+        }
+    }
+    ImGui::EndChild();
+}
+
+void TimeAppView::RenderCountdown() {
+    PROFILE_SCOPE(profiler_, Countdown);
+    auto& countdown = app_.GetCountdown();
+    
+    static_geometry_.Text("Set Countdown:");
+    ImGui::PushItemWidth(80);
+    ImGui::InputInt("Minutes", &countdown_input_minutes_, 1, 10);
+    ImGui::SameLine();
+    ImGui::InputInt("Seconds", &countdown_input_seconds_, 1, 10);
+    ImGui::PopItemWidth();
+    
+    countdown_input_minutes_ = std::max(0, countdown_input_minutes_);
+    countdown_input_seconds_ = std::max(0, std::min(59, countdown_input_seconds_));
+    
+    ImGui::Spacing();
+    char time_text[32];
+    countdown.FormatTime(time_text, sizeof(time_text), false);
+    clock_digits_.Text(1.5f, time_text);
+    
+    // The display rounds on whole seconds of elapsed time
+    if (countdown.GetState() == Timer::State::Running) {
+        RequestSecondTick(countdown.GetElapsedNanoseconds());
+    }
+    
+    ImGui::Spacing();
+    HandleCountdownControls();
+    
+    auto lateness = app_.GetTimerService().GetLatenessStats();
+    if (lateness.count > 0) {
+        ImGui::TextDisabled("Expiry lateness: last %.1f us, p99 < %.1f us, max %.1f us (%llu)",
+                            lateness.last.count() / 1000.0,
+                            lateness.Percentile(0.99).count() / 1000.0,
+                            lateness.max.count() / 1000.0,
+                            static_cast<unsigned long long>(lateness.count));
+    }
+}
+
+void TimeAppView::RenderIntervals() {
+    PROFILE_SCOPE(profiler_, Intervals);
+    auto& intervals = app_.GetIntervalTimer();
+    
+    static_geometry_.Text("Pomodoro (minutes):");
+    ImGui::PushItemWidth(80);
+    ImGui::InputInt("Work", &interval_work_minutes_, 1, 5);
+    ImGui::SameLine();
+    ImGui::InputInt("Break", &interval_break_minutes_, 1, 5);
+    ImGui::SameLine();
+    ImGui::InputInt("Long break", &interval_long_break_minutes_, 1, 5);
+    ImGui::SameLine();
+    ImGui::InputInt("Rounds", &interval_rounds_, 1, 1);
+    ImGui::PopItemWidth();
+    
+    interval_work_minutes_ = std::max(1, interval_work_minutes_);
+    interval_break_minutes_ = std::max(0, interval_break_minutes_);
+    interval_long_break_minutes_ = std::max(0, interval_long_break_minutes_);
+    interval_rounds_ = std::max(1, std::min(12, interval_rounds_));
+    
+    auto position = intervals.GetPosition();
+    const auto& phases = intervals.GetPhases();
+    bool active = intervals.GetState() != SequenceTimer::State::Stopped && !phases.empty();
+    
+    ImGui::Spacing();
+    char time_text[32], phase_text[96];
+    (show_milliseconds_ ? CLOCK_FORMAT_MS : CLOCK_FORMAT).Format(TimeFields::FromDuration(position.remaining),
+                                                                 time_text, sizeof(time_text));
+    snprintf(phase_text, sizeof(phase_text), "%s  %s", active ? phases[position.phase].name.c_str() : "Ready",
+             active ? time_text : "");
+    clock_digits_.Text(1.5f, phase_text);
+    
+    if (active) {
+        auto length = position.elapsed + position.remaining;
+        float progress = length.count() > 0
+            ? static_cast<float>(static_cast<double>(position.elapsed.count()) / static_cast<double>(length.count()))
+            : 1.0f;
+        ImGui::ProgressBar(progress, ImVec2(-1, 0));
+        // Phases are whole seconds long, so remaining turns over with elapsed
+        if (intervals.GetState() == SequenceTimer::State::Running) {
+            if (show_milliseconds_) {
+                RequestFrames(1);
+            } else {
+                RequestSecondTick(position.elapsed);
+            }
+        }
+        ImGui::Text("Phase %d of %d, cycle %llu", static_cast<int>(position.phase + 1),
+                    static_cast<int>(phases.size()), static_cast<unsigned long long>(position.cycle + 1));
+    }
+    
+    ImGui::Spacing();
+    HandleIntervalControls();
+    
+    // Phase ends come from the anchor, so lateness never adds up
+    auto stats = intervals.GetStats();
+    if (stats.transitions > 0) {
+        ImGui::TextDisabled("Phase changes: %llu, lateness last %.1f us, max %.1f us",
+                            static_cast<unsigned long long>(stats.transitions),
+                            stats.last_lateness.count() / 1000.0,
+                            stats.max_lateness.count() / 1000.0);
+    }
+}
+
+void TimeAppView::RenderWorldClock() {
+    PROFILE_SCOPE(profiler_, WorldClock);
+    auto& world_clock = app_.GetWorldClock();
+    
+    ImGui::PushItemWidth(220);
+    bool add = ImGui::InputTextWithHint("##zone", "Europe/Paris or EST5EDT,M3.2.0,M11.1.0",
+                                        world_clock_input_, sizeof(world_clock_input_),
+                                        ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    add |= static_geometry_.Button("Add Zone");
+    if (add && world_clock_input_[0] != '\0') {
+        if (world_clock.AddZone(world_clock_input_)) {
+            world_clock_input_[0] = '\0';
+        }
+    }
+    
+    auto utc_seconds = std::chrono::duration_cast<std::chrono::seconds>(
+        app_.GetCurrentTime().time_since_epoch()).count();
+    
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("WorldClockTable", 5, flags, ImVec2(0, -ImGui::GetFrameHeightWithSpacing() * 2))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Time", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Date", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Offset", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+        
+        // Only visible rows are refreshed, and only when their second ticks over
+        size_t remove_index = world_clock.Size();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(world_clock.Size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const auto& entry = world_clock.Get(static_cast<size_t>(row), utc_seconds);
+                
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.label.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.time_text);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.date_text);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.offset_text);
+                ImGui::TableNextColumn();
+                ImGui::PushID(row);
+                if (ImGui::SmallButton("x")) {
+                    remove_index = static_cast<size_t>(row);
+                }
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndTable();
+        
+        if (remove_index < world_clock.Size()) {
+            world_clock.RemoveZone(remove_index);
+        }
+    }
+}
+
+void TimeAppView::RenderAlarms() {
+    PROFILE_SCOPE(profiler_, Alarms);
+    auto& alarms = app_.GetAlarmScheduler();
+    
+    ImGui::PushItemWidth(90);
+    ImGui::InputInt("Hour", &alarm_input_hour_, 1, 6);
+    ImGui::SameLine();
+    ImGui::InputInt("Minute", &alarm_input_minute_, 1, 10);
+    ImGui::PopItemWidth();
+    
+    alarm_input_hour_ = std::max(0, std::min(23, alarm_input_hour_));
+    alarm_input_minute_ = std::max(0, std::min(59, alarm_input_minute_));
+    
+    ImGui::PushItemWidth(220);
+    ImGui::InputTextWithHint("##alarm_label", "Label", alarm_label_input_, sizeof(alarm_label_input_));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (static_geometry_.Button("Add Alarm")) {
+        app_.AddLocalAlarm(alarm_input_hour_, alarm_input_minute_, alarm_label_input_);
+        alarm_label_input_[0] = '\0';
+    }
+    
+    // Recurring: "0 9 * * MON-FRI", optionally in another zone
+    ImGui::PushItemWidth(220);
+    ImGui::InputTextWithHint("##alarm_cron", "Schedule (min hour day month weekday)",
+                             alarm_cron_input_, sizeof(alarm_cron_input_));
+    ImGui::SameLine();
+    ImGui::InputTextWithHint("##alarm_zone", "Zone (blank = local)", alarm_zone_input_, sizeof(alarm_zone_input_));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (static_geometry_.Button("Add Recurring")) {
+        AlarmScheduler::Id id = app_.AddRecurringAlarm(alarm_cron_input_, alarm_zone_input_, alarm_label_input_);
+        alarm_cron_error_ = id == 0;
+        if (id != 0) {
+            alarm_label_input_[0] = '\0';
+        }
+    }
+    if (alarm_cron_error_) {
+        static_geometry_.TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Invalid schedule or zone");
+    }
+    
+    // Recurring alarms move on when they fire without changing the count
+    auto stats = alarms.GetStats();
+    if (alarms.Size() != alarm_list_size_ || stats.fired != alarm_list_fired_) {
+        alarm_list_ = alarms.List();
+        alarm_list_size_ = alarm_list_.size();
+        alarm_list_fired_ = stats.fired;
+    }
+    
+    const auto& zone = app_.GetLocalZone();
+    AlarmScheduler::Id cancel_id = 0;
+    
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("AlarmTable", 4, flags, ImVec2(0, -ImGui::GetFrameHeightWithSpacing() * 3))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("When", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Label", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Repeats", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+        
+        for (const auto& alarm : alarm_list_) {
+            char when[32];
+            ALARM_FORMAT.Format(zone.ToLocal(alarm.utc_seconds).fields, when, sizeof(when));
+            
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(when);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(alarm.label.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(alarm.is_recurring ? "yes" : "");
+            ImGui::TableNextColumn();
+            ImGui::PushID(static_cast<int>(alarm.id));
+            if (ImGui::SmallButton("x")) {
+                cancel_id = alarm.id;
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+    
+    if (cancel_id != 0) {
+        alarms.Cancel(cancel_id);
+    }
+    
+    ImGui::TextDisabled("Fired: %llu  Clock changes: %llu (re-arm %.1f us)",
+                        static_cast<unsigned long long>(stats.fired),
+                        static_cast<unsigned long long>(stats.clock_changes),
+                        stats.last_clock_change_rearm.count() / 1000.0);
+}
+
+void TimeAppView::RenderTimers() {
+    PROFILE_SCOPE(profiler_, Timers);
+    auto& pool = app_.GetTimerPool();
+    
+    ImGui::PushItemWidth(160);
+    ImGui::InputTextWithHint("##timer_name", "Name", timer_name_input_, sizeof(timer_name_input_));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    ImGui::PushItemWidth(90);
+    ImGui::InputInt("Minutes", &timer_input_minutes_, 1, 10);
+    ImGui::PopItemWidth();
+    timer_input_minutes_ = std::max(1, std::min(999, timer_input_minutes_));
+    
+    ImGui::SameLine();
+    bool add_stopwatch = static_geometry_.Button("Add Stopwatch");
+    ImGui::SameLine();
+    bool add_countdown = static_geometry_.Button("Add Countdown");
+    if (add_stopwatch || add_countdown) {
+        TimerPool::Index index = pool.Add(add_countdown ? Timer::Type::Countdown : Timer::Type::Stopwatch,
+                                          std::chrono::minutes(timer_input_minutes_));
+        char name[64];
+        if (timer_name_input_[0] == '\0') {
+            snprintf(name, sizeof(name), "Timer %zu", pool.Size());
+        } else {
+            snprintf(name, sizeof(name), "%s", timer_name_input_);
+        }
+        pool.SetName(index, name);
+        pool.Start(index, TakeInputTime());
+        timer_name_input_[0] = '\0';
+    }
+    
+    ImGui::TextDisabled("%zu timers, %zu running", pool.Size(), pool.RunningCount());
+    RequestFrameAt(timer_table_.Render(pool, app_.GetTscClock().Now()));
+    
+    TimerTable::Action action = timer_table_.TakeAction();
+    switch (action.kind) {
+        case TimerTable::Action::Start:
+            pool.Start(action.index, TakeInputTime());
+            break;
+        case TimerTable::Action::Pause:
+            pool.Pause(action.index, TakeInputTime());
+            break;
+        case TimerTable::Action::Resume:
+            pool.Resume(action.index, TakeInputTime());
+            break;
+        case TimerTable::Action::Remove:
+            pool.Remove(action.index);
+            break;
+        case TimerTable::Action::None:
+            break;
+    }
+}
+
+void TimeAppView::HandleStopwatchControls() {
+    auto& stopwatch = app_.GetStopwatch();
+    
+    switch (stopwatch.GetState()) {
+        case Timer::State::Stopped:
+            if (static_geometry_.Button("Start", ImVec2(80, 0))) {
+                stopwatch.Start(TakeInputTime());
+            }
+            break;
+            
+        case Timer::State::Running:
+            if (static_geometry_.Button("Pause", ImVec2(80, 0))) {
+                stopwatch.Pause(TakeInputTime());
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Lap", ImVec2(80, 0))) {
+                stopwatch.Lap(TakeInputTime());
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Reset", ImVec2(80, 0))) {
+                stopwatch.Reset();
+            }
+            break;
+            
+        case Timer::State::Paused:
+            if (static_geometry_.Button("Resume", ImVec2(80, 0))) {
+                stopwatch.Resume(TakeInputTime());
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Reset", ImVec2(80, 0))) {
+                stopwatch.Reset();
+            }
+            break;
+    }
+}
+
+void TimeAppView::HandleCountdownControls() {
+    auto& countdown = app_.GetCountdown();
+    
+    switch (countdown.GetState()) {
+        case Timer::State::Stopped:
+            if (static_geometry_.Button("Start Countdown", ImVec2(120, 0))) {
+                auto total_seconds = countdown_input_minutes_ * 60 + countdown_input_seconds_;
+                countdown.SetDuration(std::chrono::seconds(total_seconds));
+                countdown.Start(TakeInputTime());
+            }
+            break;
+            
+        case Timer::State::Running:
+            if (static_geometry_.Button("Pause", ImVec2(80, 0))) {
+                countdown.Pause(TakeInputTime());
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Stop", ImVec2(80, 0))) {
+                countdown.Stop();
+            }
+            break;
+            
+        case Timer::State::Paused:
+            if (static_geometry_.Button("Resume", ImVec2(80, 0))) {
+                countdown.Resume(TakeInputTime());
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Stop", ImVec2(80, 0))) {
+                countdown.Stop();
+            }
+            break;
+    }
+}
+
+void TimeAppView::HandleIntervalControls() {
+    auto& intervals = app_.GetIntervalTimer();
+    
+    switch (intervals.GetState()) {
+        case SequenceTimer::State::Stopped:
+        case SequenceTimer::State::Finished:
+            if (static_geometry_.Button("Start", ImVec2(80, 0))) {
+                app_.SetPomodoro(std::chrono::minutes(interval_work_minutes_),
+                                 std::chrono::minutes(interval_break_minutes_),
+                                 std::chrono::minutes(interval_long_break_minutes_),
+                                 interval_rounds_);
+                intervals.Start();
+            }
+            break;
+            
+        case SequenceTimer::State::Running:
+            if (static_geometry_.Button("Pause", ImVec2(80, 0))) {
+                intervals.Pause();
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Skip", ImVec2(80, 0))) {
+                intervals.Skip();
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Stop", ImVec2(80, 0))) {
+                intervals.Stop();
+            }
+            break;
+            
+        case SequenceTimer::State::Paused:
+            if (static_geometry_.Button("Resume", ImVec2(80, 0))) {
+                intervals.Resume();
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Skip", ImVec2(80, 0))) {
+                intervals.Skip();
+            }
+            ImGui::SameLine();
+            if (static_geometry_.Button("Stop", ImVec2(80, 0))) {
+                intervals.Stop();
+            }
+            break;
+    }
+}
+
+TimeAppView::Clock::time_point TimeAppView::TakeInputTime() {
+    auto now = app_.GetTscClock().Now();
+    auto at = last_input_time_;
+    if (at == std::chrono::steady_clock::time_point{} || at > now || now - at > MAX_INPUT_AGE) {
+        return now;
+    }
+    
+    // Each input presses at most one button
+    last_input_time_ = std::chrono::steady_clock::time_point{};
+    
+    auto correction = std::chrono::duration_cast<std::chrono::nanoseconds>(now - at);
+    input_correction_last_ = correction;
+    input_correction_max_ = std::max(input_correction_max_, correction);
+    input_correction_total_ += correction;
+    ++input_corrections_;
+    return at;
+}
+
+void TimeAppView::RenderStatusBar() {
+    PROFILE_SCOPE(profiler_, StatusBar);
+    ImGui::Separator();
+    static_geometry_.Text("Status: Application Running");
+    
+    // Which clock the stopwatch reads
+    auto clock = app_.GetTscClock().GetStatus();
+    ImGui::SameLine();
+    if (clock.available) {
+        ImGui::TextDisabled("| TSC %.0f MHz", clock.frequency_hz / 1e6);
+    } else {
+        static_geometry_.TextDisabled("| steady_clock");
+    }
+    if (status_extension_) {
+        ImGui::SameLine();
+        status_extension_();
+    }
+}
+
+void TimeAppView::RequestSecondTick(std::chrono::nanoseconds elapsed) {
+    auto into_second = elapsed % std::chrono::seconds(1);
+    if (into_second.count() < 0) {
+        into_second += std::chrono::seconds(1);
+    }
+    RequestFrameAt(Clock::now() + (std::chrono::seconds(1) - into_second));
+}
+
+void TimeAppView::FormatCurrentTime(const TimeFields& local, char* buffer, size_t size) const {
+    (show_milliseconds_ ? CLOCK_FORMAT_MS : CLOCK_FORMAT).Format(local, buffer, size);
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "../AlarmScheduler.h"
+#include "../InlineCallback.h"
+#include "AnalogClock.h"
+#include "ClockDigits.h"
+#include "FrameProfiler.h"
+#include "GeometryCache.h"
+#include "SegmentDisplay.h"
+#include "TimerTable.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class TimeApplication; // Forward declaration
+
+// The application's ImGui content: clock, NTP controls and the timer tabs.
+// Knows nothing about windows or graphics devices, so the same widgets run
+// under MainWindow (Win32 + D3D11) and the headless benchmark driver.
+//
+// While building a frame it works out when its content next changes and
+// leaves that as a FrameRequest for whoever schedules frames.
+class TimeAppView {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class Tab {
+        Stopwatch,
+        Countdown,
+        Intervals,
+        WorldClock,
+        Alarms,
+        Timers
+    };
+    
+    struct FrameRequest {
+        int frames = 0;                              // wanted back to back
+        Clock::time_point at = Clock::time_point::max(); // otherwise the next one at
+    };
+    
+    explicit TimeAppView(TimeApplication& app);
+    
+    // Builds the full-screen window; call between ImGui::NewFrame() and
+    // ImGui::Render()
+    void Render();
+    
+    // What the last Render() asked for; cleared by the call
+    FrameRequest TakeFrameRequest();
+    
+    // Time of the input that may press a button in the next frame, on the
+    // TscClock timeline. Buttons anchor timer actions at it rather than at
+    // the frame.
+    void SetInputTime(Clock::time_point at) { last_input_time_ = at; }
+    
+    // Frame time minus input time for the last button anchored at an input
+    std::chrono::nanoseconds GetLastInputCorrection() const { return input_correction_last_; }
+    
+    // Drawn at the end of the status line, e.g. frame statistics
+    void SetStatusExtension(InlineCallback&& draw) { status_extension_ = std::move(draw); }
+    
+    // Times each section into the profiler's phases; null to stop
+    void SetProfiler(FrameProfiler* profiler) { profiler_ = profiler; }
+    
+    // Retained geometry for the static labels and buttons
+    GeometryCache& GetGeometryCache() { return static_geometry_; }
+    
+    // Renderer for the large time readouts
+    ClockDigits& GetClockDigits() { return clock_digits_; }
+    AnalogClock& GetAnalogClock() { return analog_clock_; }
+    SegmentDisplay& GetWallDisplay() { return wall_display_; }
+    
+    // The Timers tab, over the application's TimerPool
+    TimerTable& GetTimerTable() { return timer_table_; }
+    
+    // Scripting: selected on the next Render()
+    void SelectTab(Tab tab);
+    void SetShowMilliseconds(bool show) { show_milliseconds_ = show; }
+    void SetShowAnalogClock(bool show) { show_analog_clock_ = show; }
+    void SetShowWallDisplay(bool show) { show_wall_display_ = show; }
+
+private:
+    void RenderTimeDisplay();
+    void RenderNTPControls();
+    void RenderStopwatch();
+    void RenderLaps();
+    void RenderCountdown();
+    void RenderIntervals();
+    void RenderWorldClock();
+    void RenderAlarms();
+    void RenderTimers();
+    void RenderStatusBar();
+    
+    void FormatCurrentTime(const TimeFields& local, char* buffer, size_t size) const;
+    void HandleStopwatchControls();
+    void HandleCountdownControls();
+    void HandleIntervalControls();
+    
+    Clock::time_point TakeInputTime();
+    
+    void RequestFrames(int count);
+    void RequestFrameAt(Clock::time_point when);
+    
+    // Asks for a frame when `elapsed` next shows a different whole second
+    void RequestSecondTick(std::chrono::nanoseconds elapsed);
+    
+    TimeApplication& app_;
+    FrameRequest frame_request_;
+    InlineCallback status_extension_;
+    FrameProfiler* profiler_ = nullptr;
+    GeometryCache static_geometry_;
+    ClockDigits clock_digits_;
+    AnalogClock analog_clock_;
+    SegmentDisplay wall_display_;
+    TimerTable timer_table_;
+    int select_tab_; // -1 = none
+    
+    // UI state
+    int countdown_input_minutes_;
+    int countdown_input_seconds_;
+    bool show_milliseconds_;
+    bool show_analog_clock_;
+    bool show_wall_display_;
+    Clock::time_point last_input_time_;
+    std::chrono::nanoseconds input_correction_last_{0};  // frame time minus input time
+    std::chrono::nanoseconds input_correction_max_{0};
+    std::chrono::nanoseconds input_correction_total_{0};
+    uint64_t input_corrections_ = 0;
+    int interval_work_minutes_;
+    int interval_break_minutes_;
+    int interval_long_break_minutes_;
+    int interval_rounds_;
+    char world_clock_input_[64];
+    int alarm_input_hour_;
+    int alarm_input_minute_;
+    char alarm_label_input_[64];
+    char alarm_cron_input_[64];
+    char alarm_zone_input_[64];
+    bool alarm_cron_error_;
+    std::vector<AlarmScheduler::Info> alarm_list_; // refreshed when alarms are added, fired or cancelled
+    size_t alarm_list_size_;
+    uint64_t alarm_list_fired_;
+    char timer_name_input_[64];
+    int timer_input_minutes_;
+};
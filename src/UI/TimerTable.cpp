@@ -0,0 +1,443 @@
+#include "TimerTable.h"
+#include "../TimeFormat.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    const TimeFormat TIMER_FORMAT("[HH:]MM:SS");
+    
+    enum Column {
+        ColumnName,
+        ColumnState,
+        ColumnRemaining,
+        ColumnElapsed,
+        ColumnActions,
+        COLUMN_COUNT
+    };
+    
+    // Up to this many changed slots are moved one at a time; more are
+    // merged into the lists in one pass
+    constexpr size_t MOVE_LIMIT = 64;
+    
+    // Rows per block of a RowList: moving a block is cheap next to the
+    // binary searches that find it; one grown to twice this is split
+    constexpr size_t BLOCK_ROWS = 512;
+    
+    // While anything runs the order can drift, and off-screen countdowns
+    // expire; the table is looked at again at least this often
+    constexpr auto MAX_IDLE = std::chrono::seconds(1);
+    
+    int64_t Nanoseconds(TimerPool::Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+    
+    int StateRank(Timer::State state) {
+        switch (state) {
+            case Timer::State::Running: return 0;
+            case Timer::State::Paused: return 1;
+            default: return 2;
+        }
+    }
+    
+    const char* StateName(Timer::State state) {
+        switch (state) {
+            case Timer::State::Running: return "Running";
+            case Timer::State::Paused: return "Paused";
+            default: return "Stopped";
+        }
+    }
+    
+    // Time until `value` next crosses a whole second
+    std::chrono::nanoseconds UntilSecond(std::chrono::nanoseconds value, bool counting_down) {
+        auto into = value % std::chrono::seconds(1);
+        if (counting_down) return into.count() > 0 ? into : std::chrono::nanoseconds(std::chrono::seconds(1));
+        return std::chrono::seconds(1) - into;
+    }
+}
+
+const TimerTable::Row& TimerTable::RowList::operator[](size_t rank) const {
+    size_t block = static_cast<size_t>(std::upper_bound(starts_.begin(), starts_.end(), rank) - starts_.begin()) - 1;
+    return blocks_[block][rank - starts_[block]];
+}
+
+void TimerTable::RowList::Assign(const std::vector<Row>& sorted) {
+    blocks_.clear();
+    for (size_t begin = 0; begin < sorted.size(); begin += BLOCK_ROWS) {
+        size_t end = std::min(sorted.size(), begin + BLOCK_ROWS);
+        blocks_.emplace_back(sorted.begin() + begin, sorted.begin() + end);
+    }
+    size_ = sorted.size();
+    Reindex(0);
+}
+
+void TimerTable::RowList::Flatten(std::vector<Row>& rows) const {
+    rows.clear();
+    rows.reserve(size_);
+    for (const std::vector<Row>& block : blocks_) {
+        rows.insert(rows.end(), block.begin(), block.end());
+    }
+}
+
+template <typename Less>
+size_t TimerTable::RowList::FindBlock(const Row& row, Less less) const {
+    // The first block not wholly before `row`; past the end, the last
+    auto at = std::lower_bound(blocks_.begin(), blocks_.end(), row,
+                               [&](const std::vector<Row>& block, const Row& key) { return less(block.back(), key); });
+    return std::min(static_cast<size_t>(at - blocks_.begin()), blocks_.size() - 1);
+}
+
+template <typename Less>
+void TimerTable::RowList::Insert(const Row& row, Less less) {
+    if (blocks_.empty()) {
+        blocks_.emplace_back(1, row);
+        size_ = 1;
+        Reindex(0);
+        return;
+    }
+    size_t index = FindBlock(row, less);
+    std::vector<Row>& block = blocks_[index];
+    block.insert(std::lower_bound(block.begin(), block.end(), row, less), row);
+    if (block.size() >= BLOCK_ROWS * 2) {
+        std::vector<Row> upper(block.begin() + BLOCK_ROWS, block.end());
+        block.resize(BLOCK_ROWS);
+        blocks_.insert(blocks_.begin() + index + 1, std::move(upper));
+    }
+    ++size_;
+    Reindex(index);
+}
+
+template <typename Less>
+bool TimerTable::RowList::Erase(const Row& row, Less less) {
+    if (blocks_.empty()) return false;
+    size_t index = FindBlock(row, less);
+    std::vector<Row>& block = blocks_[index];
+    auto at = std::lower_bound(block.begin(), block.end(), row, less);
+    if (at == block.end() || at->index != row.index) return false;
+    block.erase(at);
+    if (block.empty()) blocks_.erase(blocks_.begin() + index);
+    --size_;
+    Reindex(index);
+    return true;
+}
+
+void TimerTable::RowList::Reindex(size_t from) {
+    starts_.resize(blocks_.size());
+    size_t start = from > 0 ? starts_[from - 1] + blocks_[from - 1].size() : 0;
+    for (size_t i = from; i < blocks_.size(); ++i) {
+        starts_[i] = start;
+        start += blocks_[i].size();
+    }
+}
+
+TimerTable::Placement TimerTable::Place(const TimerPool& pool, TimerPool::Index index, Row& row) const {
+    if (!pool.IsUsed(index)) return Unplaced;
+    
+    row.index = index;
+    row.key = 0;
+    switch (key_) {
+        case SortKey::Name:
+            break;
+        case SortKey::State:
+            row.key = StateRank(pool.GetState(index));
+            break;
+        case SortKey::Remaining:
+            // Rows with no countdown to show go last
+            row.key = INT64_MAX;
+            if (pool.GetType(index) != Timer::Type::Countdown) break;
+            if (pool.GetState(index) == Timer::State::Running) {
+                row.key = pool.GetRemaining(index).count() + Nanoseconds(pool.GetEvaluatedAt());
+                return InRunning;
+            }
+            if (pool.GetState(index) == Timer::State::Paused) row.key = pool.GetRemaining(index).count();
+            break;
+    }
+    return InStatic;
+}
+
+bool TimerTable::LessStatic(const TimerPool& pool, const Row& a, const Row& b) const {
+    if (key_ == SortKey::Name) {
+        int order = pool.GetName(a.index).compare(pool.GetName(b.index));
+        if (order != 0) return order < 0;
+    } else if (a.key != b.key) {
+        return a.key < b.key;
+    }
+    return a.index < b.index;
+}
+
+bool TimerTable::LessRunning(const Row& a, const Row& b) const {
+    return a.key != b.key ? a.key < b.key : a.index < b.index;
+}
+
+bool TimerTable::RunningFirst(const TimerPool& pool, const Row& running, const Row& fixed) const {
+    // The running row's key is its deadline; what it has left is what the
+    // other keys hold
+    int64_t remaining = running.key - Nanoseconds(pool.GetEvaluatedAt());
+    return remaining != fixed.key ? remaining < fixed.key : running.index < fixed.index;
+}
+
+void TimerTable::SetSort(SortKey key, bool descending) {
+    pending_column_ = key == SortKey::Name ? ColumnName : key == SortKey::State ? ColumnState : ColumnRemaining;
+    pending_descending_ = descending;
+}
+
+TimerTable::Action TimerTable::TakeAction() {
+    Action action = action_;
+    action_ = Action();
+    return action;
+}
+
+void TimerTable::UpdateOrder(TimerPool& pool) {
+    changes_.clear();
+    pool.TakeChanges(changes_);
+    
+    // Clear() took back slot indices that rows still hold
+    if (!incremental_ || !order_valid_ || pool.Capacity() < known_capacity_) {
+        Rebuild(pool);
+        return;
+    }
+    known_capacity_ = pool.Capacity();
+    placement_.resize(known_capacity_, Unplaced);
+    placed_key_.resize(known_capacity_, 0);
+    if (changes_.empty()) return;
+    
+    if (changes_.size() <= MOVE_LIMIT) {
+        for (TimerPool::Index index : changes_) {
+            if (!MoveRow(pool, index)) {
+                MergeChanges(pool);
+                return;
+            }
+        }
+    } else {
+        MergeChanges(pool);
+    }
+}
+
+void TimerTable::Rebuild(const TimerPool& pool) {
+    known_capacity_ = pool.Capacity();
+    placement_.assign(known_capacity_, Unplaced);
+    placed_key_.assign(known_capacity_, 0);
+    
+    std::vector<Row>& fixed = scratch_;
+    std::vector<Row>& running = flat_;
+    fixed.clear();
+    running.clear();
+    for (size_t i = 0; i < known_capacity_; ++i) {
+        TimerPool::Index index = static_cast<TimerPool::Index>(i);
+        Row row;
+        Placement placement = Place(pool, index, row);
+        if (placement == Unplaced) continue;
+        (placement == InRunning ? running : fixed).push_back(row);
+        placement_[index] = placement;
+        placed_key_[index] = row.key;
+    }
+    
+    std::sort(fixed.begin(), fixed.end(), [&](const Row& a, const Row& b) { return LessStatic(pool, a, b); });
+    std::sort(running.begin(), running.end(), [&](const Row& a, const Row& b) { return LessRunning(a, b); });
+    static_rows_.Assign(fixed);
+    running_rows_.Assign(running);
+    order_valid_ = true;
+    ++stats_.rebuilds;
+}
+
+bool TimerTable::MoveRow(const TimerPool& pool, TimerPool::Index index) {
+    auto less_static = [&](const Row& a, const Row& b) { return LessStatic(pool, a, b); };
+    auto less_running = [&](const Row& a, const Row& b) { return LessRunning(a, b); };
+    
+    const Placement was = placement_[index];
+    const Row old = {placed_key_[index], index};
+    Row row;
+    const Placement placement = Place(pool, index, row);
+    
+    // Names are not kept here, so by name the row is always re-placed
+    if (placement == was && row.key == old.key && key_ != SortKey::Name) return true;
+    
+    // Renamed, or reused under another name: the old key is gone
+    if (was == InRunning && !running_rows_.Erase(old, less_running)) return false;
+    if (was == InStatic && !static_rows_.Erase(old, less_static)) return false;
+    
+    if (placement == InRunning) running_rows_.Insert(row, less_running);
+    if (placement == InStatic) static_rows_.Insert(row, less_static);
+    
+    placement_[index] = placement;
+    placed_key_[index] = row.key;
+    ++stats_.moved_rows;
+    return true;
+}
+
+void TimerTable::MergeChanges(const TimerPool& pool) {
+    // Rows of changed slots are dropped wherever they are, then placed
+    // anew: sorted among themselves and merged in
+    marks_.resize(known_capacity_, 0);
+    for (TimerPool::Index index : changes_) {
+        marks_[index] = 1;
+    }
+    auto marked = [&](const Row& row) { return marks_[row.index] != 0; };
+    
+    auto merge_in = [&](RowList& list, Placement which, auto less) {
+        list.Flatten(flat_);
+        flat_.erase(std::remove_if(flat_.begin(), flat_.end(), marked), flat_.end());
+        
+        scratch_.clear();
+        for (TimerPool::Index index : changes_) {
+            Row row;
+            if (Place(pool, index, row) == which) scratch_.push_back(row);
+        }
+        std::sort(scratch_.begin(), scratch_.end(), less);
+        size_t middle = flat_.size();
+        flat_.insert(flat_.end(), scratch_.begin(), scratch_.end());
+        std::inplace_merge(flat_.begin(), flat_.begin() + middle, flat_.end(), less);
+        list.Assign(flat_);
+    };
+    merge_in(static_rows_, InStatic, [&](const Row& a, const Row& b) { return LessStatic(pool, a, b); });
+    merge_in(running_rows_, InRunning, [&](const Row& a, const Row& b) { return LessRunning(a, b); });
+    
+    for (TimerPool::Index index : changes_) {
+        Row row;
+        placement_[index] = Place(pool, index, row);
+        placed_key_[index] = row.key;
+        marks_[index] = 0;
+    }
+    ++stats_.merges;
+}
+
+TimerTable::Split TimerTable::Locate(const TimerPool& pool, size_t rank) const {
+    // Smallest static count whose next static row does not come before the
+    // last running row taken
+    size_t low = rank > running_rows_.Size() ? rank - running_rows_.Size() : 0;
+    size_t high = std::min(rank, static_rows_.Size());
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        size_t running = rank - middle;
+        if (running > 0 && !RunningFirst(pool, running_rows_[running - 1], static_rows_[middle])) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return {low, rank - low};
+}
+
+TimerTable::Clock::time_point TimerTable::Render(TimerPool& pool, Clock::time_point now) {
+    expired_.clear();
+    pool.Evaluate(now, expired_);
+    
+    Clock::time_point next_change = Clock::time_point::max();
+    if (pool.RunningCount() > 0) next_change = now + MAX_IDLE;
+    stats_.rows_drawn = 0;
+    
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY |
+                            ImGuiTableFlags_Sortable;
+    if (!ImGui::BeginTable("TimerTable", COLUMN_COUNT, flags, ImVec2(0, -ImGui::GetFrameHeightWithSpacing() * 2))) {
+        return next_change;
+    }
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.0f, ColumnName);
+    ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 0.0f, ColumnState);
+    ImGui::TableSetupColumn("Remaining", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort,
+                            0.0f, ColumnRemaining);
+    ImGui::TableSetupColumn("Elapsed", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort,
+                            0.0f, ColumnElapsed);
+    ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort, 0.0f, ColumnActions);
+    ImGui::TableHeadersRow();
+    
+    if (pending_column_ >= 0) {
+        ImGui::TableSetColumnSortDirection(pending_column_, pending_descending_ ? ImGuiSortDirection_Descending
+                                                                                : ImGuiSortDirection_Ascending, false);
+        pending_column_ = -1;
+    }
+    if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs()) {
+        if (specs->SpecsDirty && specs->SpecsCount > 0) {
+            const ImGuiTableColumnSortSpecs& spec = specs->Specs[0];
+            SortKey key = spec.ColumnUserID == ColumnName ? SortKey::Name
+                        : spec.ColumnUserID == ColumnState ? SortKey::State : SortKey::Remaining;
+            // Descending is the same order walked backwards
+            if (key != key_) order_valid_ = false;
+            key_ = key;
+            descending_ = spec.SortDirection == ImGuiSortDirection_Descending;
+        }
+        specs->SpecsDirty = false;
+    }
+    
+    UpdateOrder(pool);
+    
+    // The first countdown to run out leaves the running list
+    if (!running_rows_.Empty()) {
+        auto first_out = std::chrono::nanoseconds(running_rows_.Front().key - Nanoseconds(pool.GetEvaluatedAt()));
+        next_change = std::min(next_change, now + first_out);
+    }
+    
+    const size_t count = static_rows_.Size() + running_rows_.Size();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(count));
+    while (clipper.Step()) {
+        // Descending row r is ascending rank count - 1 - r: start after it
+        // and walk back
+        const size_t first = static_cast<size_t>(clipper.DisplayStart);
+        Split split = Locate(pool, descending_ ? count - first : first);
+        size_t s = split.static_rows, r = split.running_rows;
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            bool running;
+            if (descending_) {
+                running = r > 0 && (s == 0 || !RunningFirst(pool, running_rows_[r - 1], static_rows_[s - 1]));
+                DrawRow(pool, running ? running_rows_[--r].index : static_rows_[--s].index, next_change);
+            } else {
+                running = r < running_rows_.Size() &&
+                          (s == static_rows_.Size() || RunningFirst(pool, running_rows_[r], static_rows_[s]));
+                DrawRow(pool, running ? running_rows_[r++].index : static_rows_[s++].index, next_change);
+            }
+        }
+    }
+    ImGui::EndTable();
+    return next_change;
+}
+
+void TimerTable::DrawRow(const TimerPool& pool, TimerPool::Index index, Clock::time_point& next_change) {
+    const Timer::State state = pool.GetState(index);
+    const bool countdown = pool.GetType(index) == Timer::Type::Countdown;
+    const auto remaining = pool.GetRemaining(index);
+    const auto elapsed = pool.GetElapsed(index);
+    ++stats_.rows_drawn;
+    
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(pool.GetName(index).c_str());
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(StateName(state));
+    
+    // A countdown shows the second it is in, rounded up
+    char text[32];
+    ImGui::TableNextColumn();
+    if (countdown && state != Timer::State::Stopped) {
+        TIMER_FORMAT.Format(TimeFields::FromDuration(remaining + std::chrono::seconds(1) - std::chrono::nanoseconds(1)),
+                            text, sizeof(text));
+        ImGui::TextUnformatted(text);
+    }
+    ImGui::TableNextColumn();
+    TIMER_FORMAT.Format(TimeFields::FromDuration(elapsed), text, sizeof(text));
+    ImGui::TextUnformatted(text);
+    
+    if (state == Timer::State::Running) {
+        const Clock::time_point at = pool.GetEvaluatedAt();
+        next_change = std::min(next_change, at + UntilSecond(elapsed, false));
+        if (countdown) next_change = std::min(next_change, at + UntilSecond(remaining, true));
+    }
+    
+    ImGui::TableNextColumn();
+    ImGui::PushID(static_cast<int>(index));
+    switch (state) {
+        case Timer::State::Stopped:
+            if (ImGui::SmallButton("Start")) action_ = {Action::Start, index};
+            break;
+        case Timer::State::Running:
+            if (ImGui::SmallButton("Pause")) action_ = {Action::Pause, index};
+            break;
+        case Timer::State::Paused:
+            if (ImGui::SmallButton("Resume")) action_ = {Action::Resume, index};
+            break;
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallButton("x")) action_ = {Action::Remove, index};
+    ImGui::PopID();
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "../TimerPool.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Sortable table over a TimerPool that stays cheap with a million timers.
+// Only the rows in view are formatted and laid out (ImGuiListClipper), and
+// the sort order is maintained instead of recomputed: a frame re-places
+// just the slots the pool reports as changed.
+//
+// Sorted by remaining time, running countdowns would reorder against the
+// rest every frame, but never among themselves: they all lose time at the
+// same rate. They are kept in a list of their own, ordered by deadline,
+// next to the list of everything else, whose keys hold still. A row is
+// found by a binary search over the merge of the two. Both lists are kept
+// in blocks of a few hundred rows, so a change moves one block's worth of
+// memory. A frame costs O(log^2 n) plus the visible rows and the changes,
+// on top of the pool's own Evaluate().
+class TimerTable {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class SortKey {
+        Name,
+        State,
+        Remaining
+    };
+    
+    // A row button pressed during Render(); the caller applies it, stamped
+    // with the time of the input that pressed it
+    struct Action {
+        enum Kind {
+            None,
+            Start,
+            Pause,
+            Resume,
+            Remove
+        };
+        
+        Kind kind = None;
+        TimerPool::Index index = 0;
+    };
+    
+    struct Stats {
+        uint64_t rebuilds = 0;    // full sorts: sort changed, first use, pool cleared
+        uint64_t merges = 0;      // batches of changes merged in one pass
+        uint64_t moved_rows = 0;  // rows re-placed one by one
+        int rows_drawn = 0;       // last frame
+    };
+    
+    // Evaluates the pool at `now`, brings the order up to date and draws
+    // the rows in view. Returns when a row in view, or the order, next
+    // changes.
+    Clock::time_point Render(TimerPool& pool, Clock::time_point now);
+    
+    // What the last Render() had pressed; cleared by the call
+    Action TakeAction();
+    
+    // Scripting: applied to the table's sort specs on the next Render()
+    void SetSort(SortKey key, bool descending);
+    
+    // Off, the order is sorted from scratch every frame (for A/B measurements)
+    void SetIncremental(bool incremental) { incremental_ = incremental; }
+    bool IsIncremental() const { return incremental_; }
+    
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    // `key` is the remaining time in the static list and the deadline in
+    // the running one, the state's rank when sorting by state, and unused
+    // (names compared) when sorting by name
+    struct Row {
+        int64_t key;
+        TimerPool::Index index;
+    };
+    
+    // Rows in order, in blocks of at most MAX_BLOCK
+    class RowList {
+    public:
+        size_t Size() const { return size_; }
+        bool Empty() const { return size_ == 0; }
+        const Row& operator[](size_t rank) const;
+        const Row& Front() const { return blocks_.front().front(); }
+        
+        void Assign(const std::vector<Row>& sorted);
+        void Flatten(std::vector<Row>& rows) const;
+        
+        template <typename Less>
+        void Insert(const Row& row, Less less);
+        // False if `row` is not where its key puts it
+        template <typename Less>
+        bool Erase(const Row& row, Less less);
+    
+    private:
+        template <typename Less>
+        size_t FindBlock(const Row& row, Less less) const;
+        void Reindex(size_t from);
+        
+        std::vector<std::vector<Row>> blocks_;
+        std::vector<size_t> starts_;   // rank of each block's first row
+        size_t size_ = 0;
+    };
+    
+    enum Placement : uint8_t {
+        Unplaced,
+        InStatic,
+        InRunning
+    };
+    
+    // Number of static and running rows ahead of ascending position `rank`
+    struct Split {
+        size_t static_rows, running_rows;
+    };
+    
+    Placement Place(const TimerPool& pool, TimerPool::Index index, Row& row) const;
+    bool LessStatic(const TimerPool& pool, const Row& a, const Row& b) const;
+    bool LessRunning(const Row& a, const Row& b) const;
+    bool RunningFirst(const TimerPool& pool, const Row& running, const Row& fixed) const;
+    
+    void UpdateOrder(TimerPool& pool);
+    void Rebuild(const TimerPool& pool);
+    bool MoveRow(const TimerPool& pool, TimerPool::Index index);
+    void MergeChanges(const TimerPool& pool);
+    Split Locate(const TimerPool& pool, size_t rank) const;
+    void DrawRow(const TimerPool& pool, TimerPool::Index index, Clock::time_point& next_change);
+    
+    RowList static_rows_;
+    RowList running_rows_;
+    std::vector<Placement> placement_;   // per slot
+    std::vector<int64_t> placed_key_;    // per slot, the key it was placed with
+    std::vector<TimerPool::Index> changes_;
+    std::vector<TimerPool::Index> expired_;
+    std::vector<Row> scratch_;
+    std::vector<Row> flat_;
+    std::vector<uint8_t> marks_;
+    size_t known_capacity_ = 0;
+    Action action_;
+    
+    SortKey key_ = SortKey::Remaining;
+    bool descending_ = false;
+    bool order_valid_ = false;
+    int pending_column_ = -1;            // from SetSort()
+    bool pending_descending_ = false;
+    bool incremental_ = true;
+    Stats stats_;
+};
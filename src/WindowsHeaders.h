@@ -19,6 +19,7 @@
 // DirectX headers
 #include <d3d11.h>
 #include <dxgi1_2.h>
+#include <dxgi1_3.h>
 
 // Suppress deprecated warnings
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -0,0 +1,85 @@
+#include "WorldClock.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    const TimeFormat TIME_FORMAT("%H:%M:%S");
+    const TimeFormat DATE_FORMAT("%a %d %b %Y");
+    
+    int64_t DayOf(int64_t local_seconds) {
+        return local_seconds >= 0 ? local_seconds / 86400 : (local_seconds - 86399) / 86400;
+    }
+}
+
+WorldClock::WorldClock() {
+}
+
+bool WorldClock::AddZone(const std::string& name, const std::string& label) {
+    std::shared_ptr<const TimeZone> zone;
+    
+    auto it = zones_.find(name);
+    if (it != zones_.end()) {
+        zone = it->second;
+    } else {
+        zone = TimeZone::Load(name);
+        if (!zone) return false;
+        zones_.emplace(name, zone);
+    }
+    
+    AddZone(std::move(zone), label.empty() ? name : label);
+    return true;
+}
+
+void WorldClock::AddZone(std::shared_ptr<const TimeZone> zone, const std::string& label) {
+    Entry entry;
+    entry.label = label;
+    entry.zone = std::move(zone);
+    entries_.push_back(std::move(entry));
+}
+
+void WorldClock::RemoveZone(size_t index) {
+    if (index < entries_.size()) {
+        entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+}
+
+void WorldClock::Clear() {
+    entries_.clear();
+}
+
+const WorldClock::Entry& WorldClock::Get(size_t index, int64_t utc_seconds) {
+    Entry& entry = entries_[index];
+    if (entry.displayed_second != utc_seconds) {
+        Refresh(entry, utc_seconds);
+    }
+    return entry;
+}
+
+void WorldClock::Refresh(Entry& entry, int64_t utc_seconds) {
+    bool in_window = utc_seconds >= entry.displayed_second && utc_seconds < entry.offset_valid_until;
+    int64_t local_seconds = utc_seconds + entry.offset;
+    int64_t local_day = DayOf(local_seconds);
+    
+    if (in_window && local_day == entry.local_day) {
+        // Same offset, same day: only the time of day moves
+        int64_t second_of_day = local_seconds - local_day * 86400;
+        entry.fields.hours = second_of_day / 3600;
+        entry.fields.minutes = static_cast<int>((second_of_day / 60) % 60);
+        entry.fields.seconds = static_cast<int>(second_of_day % 60);
+    } else {
+        auto local = entry.zone->ToLocal(utc_seconds);
+        entry.fields = local.fields;
+        entry.offset = local.offset;
+        entry.offset_valid_until = local.valid_until;
+        entry.local_day = DayOf(utc_seconds + local.offset);
+        
+        DATE_FORMAT.Format(entry.fields, entry.date_text, sizeof(entry.date_text));
+        
+        int32_t minutes = std::abs(local.offset) / 60;
+        snprintf(entry.offset_text, sizeof(entry.offset_text), "UTC%c%02d:%02d %s",
+                 local.offset < 0 ? '-' : '+', minutes / 60, minutes % 60, local.abbreviation);
+    }
+    
+    TIME_FORMAT.Format(entry.fields, entry.time_text, sizeof(entry.time_text));
+    entry.displayed_second = utc_seconds;
+}
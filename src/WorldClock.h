@@ -0,0 +1,51 @@
+#pragma once
+
+#include "TimeZone.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A list of zones shown side by side. Each entry keeps its zone offset, the
+// UTC second at which that offset stops applying, and preformatted strings;
+// nothing is recomputed until the displayed second changes, and the UTC ->
+// civil conversion is skipped entirely while the local day stays the same.
+class WorldClock {
+public:
+    struct Entry {
+        std::string label;
+        std::shared_ptr<const TimeZone> zone;
+        
+        // Cached conversion state
+        int64_t displayed_second = INT64_MIN;
+        int64_t offset_valid_until = INT64_MIN;
+        int64_t local_day = INT64_MIN;
+        int32_t offset = 0;
+        TimeFields fields;
+        
+        char time_text[16] = "";
+        char date_text[24] = "";
+        char offset_text[32] = "";
+    };
+    
+    WorldClock();
+    
+    // `name` is anything TimeZone::Load() accepts; the label defaults to it
+    bool AddZone(const std::string& name, const std::string& label = std::string());
+    void AddZone(std::shared_ptr<const TimeZone> zone, const std::string& label);
+    void RemoveZone(size_t index);
+    void Clear();
+    
+    size_t Size() const { return entries_.size(); }
+    
+    // Returns the entry with its text brought up to `utc_seconds`. Only
+    // entries that are actually looked at (e.g. visible rows) pay anything.
+    const Entry& Get(size_t index, int64_t utc_seconds);
+
+private:
+    void Refresh(Entry& entry, int64_t utc_seconds);
+    
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, std::shared_ptr<const TimeZone>> zones_; // loaded once per name
+};
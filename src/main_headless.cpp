@@ -0,0 +1,703 @@
+// Runs TimeAppView against ImGui with no window and a null renderer, under
+// scripted input, and reports what each frame costs on the CPU.
+//
+//   TimeAppHeadless [frames]                 UI cost per frame, null renderer
+//                   [--no-geometry-cache]    labels and buttons rebuilt every frame
+//                   [--font-scale]           big clocks via SetWindowFontScale
+//                   [--analog]               with the analog clock shown
+//                   [--no-face-cache]        analog clock face rebuilt every frame
+//                   [--wall]                 with the time on the segment wall display
+//                   [--no-wall-cache]        segment display rebuilt every frame
+//                   [--timers N]             on the Timers tab with N timers
+//                   [--full-sort]            timer table re-sorted every frame
+//                   [--zones N]              on the World Clock tab with N zones
+//   TimeAppHeadless --input [N]              N scripted laps: frame-time vs input-time anchoring error
+//   TimeAppHeadless --raster [frames]        SoftwareRenderer kernels at 1080p and 4K
+//                   [--screenshot out.ppm]   last 1080p frame from the best kernel
+//
+// Subsystem benchmarks and checks, no UI; N is optional:
+//   TimeAppHeadless --expiry [N]             countdown expiry lateness, TimerService vs 60 Hz polling
+//                   --laps [N]               lap insert throughput and memory per lap
+//                   --format [N]             formats per second, TimeFormat vs ostringstream
+//                   --tz-check [N]           TimeZone against localtime_r on N times per zone
+//                   --tsc [N]                TSC clock read cost, and drift from steady_clock over N s
+//                   --restore [N]            startup restore of N persisted timers
+//                   --pool [N]               TimerPool batch evaluation vs N Timer objects
+//                   --executor [N]           callback registration and executor dispatch throughput
+//                   --alarms [N]             N local alarms: rearm cost per clock step, DST resolution, firing order
+//                   --cron-check [N]         N random cron expressions against a brute-force next-fire search
+//                   --cron [N]               compile and next-fire cost over N cron schedules
+//                   --sequences [N]          SequenceTimer drift vs restart-at-now chaining, N simulated for 24 h
+//                   --capture [N]            Capture() cost with 1, 4 and 16 producers of N events, drain order
+//                   --timer-stress [N]       Timer readers against pause/resume/restart threads for N s, torn reads
+//                   --timer-read [N]         Timer read cost, seqlock vs mutex, with 0, 1 and 3 control threads
+//                   --profiler [N]           FrameProfiler cost per frame, N frames of the UI's scopes and EndFrame
+#include "Bench/Bench.h"
+#include "TimeApplication.h"
+#include "UI/DarkTheme.h"
+#include "UI/SoftwareRenderer.h"
+#include "UI/TimeAppView.h"
+#include "imgui.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int DEFAULT_FRAMES = 5000;
+    constexpr int WARMUP_FRAMES = 60;          // font atlas build, first layout
+    constexpr float DISPLAY_WIDTH = 600.0f;    // MainWindow's client size
+    constexpr float DISPLAY_HEIGHT = 500.0f;
+    constexpr float FRAME_DELTA = 1.0f / 60.0f;
+    constexpr int TAB_FRAMES = 250;            // frames spent on each tab
+    constexpr int LAP_FRAMES = 30;
+    constexpr int MILLISECONDS_FRAMES = 500;   // show_milliseconds toggles
+    constexpr int RESET_FRAMES = 3000;         // keeps the lap list bounded
+    constexpr int SORT_FRAMES = 1000;          // timer table sort column changes
+    constexpr int TIMER_TOGGLES = 4;           // timers paused or resumed per frame
+    constexpr int DEFAULT_RASTER_FRAMES = 120;
+    constexpr int RASTER_WARMUP_FRAMES = 10;
+    constexpr size_t DEFAULT_INPUTS = 100;
+    
+    struct BenchMode {
+        const char* flag;
+        int (*run)(size_t count);
+    };
+    
+    const BenchMode BENCH_MODES[] = {
+        {"--expiry", Bench::RunExpiry},
+        {"--laps", Bench::RunLaps},
+        {"--format", Bench::RunFormat},
+        {"--tz-check", Bench::RunZoneCheck},
+        {"--tsc", Bench::RunTsc},
+        {"--restore", Bench::RunRestore},
+        {"--pool", Bench::RunPool},
+        {"--executor", Bench::RunExecutor},
+        {"--alarms", Bench::RunAlarms},
+        {"--cron-check", Bench::RunCronCheck},
+        {"--cron", Bench::RunCron},
+        {"--sequences", Bench::RunSequences},
+        {"--capture", Bench::RunCapture},
+        {"--timer-stress", Bench::RunTimerStress},
+        {"--timer-read", Bench::RunTimerReads},
+        {"--profiler", Bench::RunProfiler},
+    };
+    
+    // A frame count; anything else on the command line is a mistake
+    bool IsCount(const char* text) {
+        if (*text == '\0') return false;
+        for (; *text != '\0'; ++text) {
+            if (*text < '0' || *text > '9') return false;
+        }
+        return true;
+    }
+    
+    // Allocations made by the UI thread, counted by the operator new below
+    thread_local uint64_t thread_allocations = 0;
+    uint64_t imgui_allocations = 0;
+    
+    void* CountingAlloc(size_t size, void*) {
+        ++imgui_allocations;
+        return std::malloc(size);
+    }
+    
+    void CountingFree(void* ptr, void*) {
+        std::free(ptr);
+    }
+    
+    // The null renderer: accepts every texture ImGui asks for and draws nothing
+    void UpdateTextures(ImDrawData* draw_data) {
+        if (!draw_data->Textures) return;
+        for (ImTextureData* tex : *draw_data->Textures) {
+            if (tex->Status == ImTextureStatus_WantCreate || tex->Status == ImTextureStatus_WantUpdates) {
+                tex->SetTexID(static_cast<ImTextureID>(tex->UniqueID));
+                tex->SetStatus(ImTextureStatus_OK);
+            } else if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames > 0) {
+                tex->SetTexID(ImTextureID_Invalid);
+                tex->SetStatus(ImTextureStatus_Destroyed);
+            }
+        }
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    
+    // Stays on the World Clock tab when set
+    bool world_clock_only = false;
+    
+    // Installed zones, plus POSIX rules that need no zoneinfo, repeated
+    // under numbered labels until there are `count` rows
+    void AddZones(WorldClock& world_clock, size_t count) {
+        static const char* const NAMES[] = {
+            "EST5EDT,M3.2.0,M11.1.0", "CET-1CEST,M3.5.0,M10.5.0/3", "UTC",
+            "Europe/London", "Europe/Paris", "Europe/Sofia", "Europe/Moscow", "Africa/Cairo",
+            "Africa/Casablanca", "Asia/Dubai", "Asia/Kolkata", "Asia/Kathmandu", "Asia/Shanghai",
+            "Asia/Tokyo", "Australia/Sydney", "Australia/Lord_Howe", "Pacific/Auckland",
+            "Pacific/Chatham", "America/Sao_Paulo", "America/St_Johns", "America/New_York",
+            "America/Chicago", "America/Denver", "America/Los_Angeles", "Pacific/Honolulu"
+        };
+        constexpr size_t NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+        
+        world_clock.Clear();
+        for (size_t i = 0; world_clock.Size() < count && i < count * NAME_COUNT; ++i) {
+            char label[64];
+            std::snprintf(label, sizeof(label), "%s #%zu", NAMES[i % NAME_COUNT], i / NAME_COUNT + 1);
+            world_clock.AddZone(NAMES[i % NAME_COUNT], label);
+        }
+    }
+    
+    // Timers named out of slot order; a third are countdowns of up to two
+    // hours, started up to ten minutes ago, so some expire during the run.
+    // One in four is left paused and one in eight never started.
+    void AddTimers(TimerPool& pool, size_t count) {
+        auto now = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            bool countdown = i % 3 == 0;
+            auto duration = std::chrono::seconds(1 + (i * 7919) % 7200);
+            TimerPool::Index index = pool.Add(countdown ? Timer::Type::Countdown : Timer::Type::Stopwatch, duration);
+            
+            char name[32];
+            std::snprintf(name, sizeof(name), "Timer %07zu", (i * 2654435761u) % count);
+            pool.SetName(index, name);
+            if (i % 8 == 7) continue;
+            
+            pool.Start(index, now - std::chrono::milliseconds((i * 104729) % 600000));
+            if (i % 4 == 1) pool.Pause(index, now);
+        }
+    }
+    
+    // What a user does over the run: the mouse circles over the window, the
+    // tabs cycle, the stopwatch takes laps and the countdown runs. With
+    // timers in the pool it stays on the Timers tab instead, toggling a few
+    // timers each frame and changing the sort now and then. With --zones it
+    // stays on the World Clock tab.
+    void Script(int frame, TimeApplication& app, TimeAppView& view) {
+        ImGuiIO& io = ImGui::GetIO();
+        float angle = frame * 0.05f;
+        io.AddMousePosEvent(DISPLAY_WIDTH * 0.5f + std::cos(angle) * 200.0f,
+                            DISPLAY_HEIGHT * 0.5f + std::sin(angle) * 150.0f);
+        
+        TimerPool& pool = app.GetTimerPool();
+        if (pool.Size() > 0) {
+            if (frame == 0) view.SelectTab(TimeAppView::Tab::Timers);
+            if (frame % SORT_FRAMES == 0) {
+                static const TimerTable::SortKey KEYS[] = {
+                    TimerTable::SortKey::Remaining,
+                    TimerTable::SortKey::Name,
+                    TimerTable::SortKey::State
+                };
+                int step = frame / SORT_FRAMES;
+                view.GetTimerTable().SetSort(KEYS[step % 3], step % 2 == 1);
+            }
+            
+            auto now = Clock::now();
+            for (int i = 0; i < TIMER_TOGGLES; ++i) {
+                auto index = static_cast<TimerPool::Index>((static_cast<uint64_t>(frame) * TIMER_TOGGLES + i) * 40503u
+                                                           % pool.Capacity());
+                if (!pool.IsUsed(index)) continue;
+                if (pool.GetState(index) == Timer::State::Running) {
+                    pool.Pause(index, now);
+                } else {
+                    pool.Resume(index, now);
+                }
+            }
+        } else if (world_clock_only) {
+            if (frame == 0) view.SelectTab(TimeAppView::Tab::WorldClock);
+        } else if (frame % TAB_FRAMES == 0) {
+            static const TimeAppView::Tab TABS[] = {
+                TimeAppView::Tab::Stopwatch,
+                TimeAppView::Tab::Countdown,
+                TimeAppView::Tab::Intervals,
+                TimeAppView::Tab::WorldClock,
+                TimeAppView::Tab::Alarms
+            };
+            view.SelectTab(TABS[(frame / TAB_FRAMES) % (sizeof(TABS) / sizeof(TABS[0]))]);
+        }
+        if (frame % MILLISECONDS_FRAMES == 0) {
+            view.SetShowMilliseconds((frame / MILLISECONDS_FRAMES) % 2 == 0);
+        }
+        
+        Timer& stopwatch = app.GetStopwatch();
+        if (frame % RESET_FRAMES == 0) {
+            stopwatch.Reset();
+            stopwatch.Start();
+            
+            Timer& countdown = app.GetCountdown();
+            countdown.Reset();
+            countdown.SetDuration(std::chrono::hours(1));
+            countdown.Start();
+        } else if (frame % LAP_FRAMES == 0) {
+            stopwatch.Lap();
+        }
+    }
+    
+    using Bench::Microseconds;
+    using Bench::Series;
+    
+    void RunFrame(TimeAppView& view) {
+        ImGui::GetIO().DeltaTime = FRAME_DELTA;
+        ImGui::NewFrame();
+        view.Render();
+        ImGui::Render();
+        UpdateTextures(ImGui::GetDrawData());
+        view.TakeFrameRequest();
+    }
+    
+    // Clicks through the Stopwatch tab from the bottom up until a click adds
+    // a lap, putting the stopwatch back after any other button. Bottom up,
+    // so the tab contents come before the NTP button above them.
+    bool FindLapButton(TimeApplication& app, TimeAppView& view, ImVec2& position) {
+        ImGuiIO& io = ImGui::GetIO();
+        Timer& stopwatch = app.GetStopwatch();
+        for (float y = DISPLAY_HEIGHT - 4.0f; y > 0.0f; y -= 6.0f) {
+            for (float x = 4.0f; x < DISPLAY_WIDTH; x += 12.0f) {
+                io.AddMousePosEvent(x, y);
+                RunFrame(view);
+                if (!ImGui::IsAnyItemHovered()) continue;
+                
+                size_t laps = stopwatch.GetLaps().Size();
+                io.AddMouseButtonEvent(0, true);
+                RunFrame(view);
+                io.AddMouseButtonEvent(0, false);
+                RunFrame(view);
+                if (stopwatch.GetState() == Timer::State::Running && stopwatch.GetLaps().Size() == laps + 1) {
+                    position = ImVec2(x, y);
+                    return true;
+                }
+                if (stopwatch.GetState() != Timer::State::Running) {
+                    stopwatch.Reset();
+                    stopwatch.Start();
+                }
+                view.SelectTab(TimeAppView::Tab::Stopwatch);
+                RunFrame(view);
+            }
+        }
+        return false;
+    }
+    
+    // Stopwatch laps from scripted input that arrives while the UI waits for
+    // the next 60 Hz frame, the way a click lands during a vsync wait. Each
+    // lap is taken once through the Lap button, stamped as MainWindow does on
+    // WM_LBUTTONUP, and once through EventCapture, as HotkeyThread does. The
+    // error of anchoring at the frame is when the frame handled it minus when
+    // it arrived; anchored at the input, the recorded split should be exact.
+    int RunInputBenchmark(TimeApplication& app, TimeAppView& view, size_t count) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        const TscClock& clock = app.GetTscClock();
+        Timer& stopwatch = app.GetStopwatch();
+        
+        view.SelectTab(TimeAppView::Tab::Stopwatch);
+        stopwatch.Start();
+        for (int frame = 0; frame < WARMUP_FRAMES; ++frame) RunFrame(view);
+        ImVec2 lap_button;
+        if (!FindLapButton(app, view, lap_button)) {
+            std::printf("Input anchoring: no Lap button found on the Stopwatch tab\n");
+            return 1;
+        }
+        
+        stopwatch.Reset();
+        Clock::time_point started = clock.Now();
+        stopwatch.Start(started);
+        io.AddMousePosEvent(lap_button.x, lap_button.y);
+        
+        auto frame_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(FRAME_DELTA));
+        Clock::time_point next_frame = Clock::now();
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        auto arrival = [&]() {
+            // Somewhere in the wait just finished, short of the previous frame
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return clock.Now() - frame_period * static_cast<int64_t>((state >> 11) % 95) / 100;
+        };
+        auto wait_for_frame = [&]() {
+            next_frame += frame_period;
+            std::this_thread::sleep_until(next_frame);
+        };
+        
+        Series button_frame, button_input, hotkey_frame, hotkey_input;
+        size_t missed = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t laps = stopwatch.GetLaps().Size();
+            wait_for_frame();
+            io.AddMouseButtonEvent(0, true);
+            app.Update();
+            RunFrame(view);
+            
+            wait_for_frame();
+            Clock::time_point at = arrival();
+            view.SetInputTime(at);
+            io.AddMouseButtonEvent(0, false);
+            app.Update();
+            RunFrame(view);
+            if (stopwatch.GetLaps().Size() != laps + 1) {
+                ++missed;
+                continue;
+            }
+            button_frame.Add(Microseconds(view.GetLastInputCorrection()));
+            button_input.Add(Microseconds(stopwatch.GetLaps().GetLastSplit() - (at - started)));
+            
+            wait_for_frame();
+            at = arrival();
+            app.GetStopwatchEvents().Capture(EventCapture::Action::Lap, at);
+            Clock::time_point drained = clock.Now();
+            app.Update();
+            RunFrame(view);
+            if (stopwatch.GetLaps().Size() != laps + 2) {
+                ++missed;
+                continue;
+            }
+            hotkey_frame.Add(Microseconds(drained - at));
+            hotkey_input.Add(Microseconds(stopwatch.GetLaps().GetLastSplit() - (at - started)));
+        }
+        
+        size_t inexact = 0;
+        for (double error : button_input.values) inexact += error != 0.0;
+        for (double error : hotkey_input.values) inexact += error != 0.0;
+        
+        std::printf("Input anchoring, %zu laps each by button and by EventCapture, input arriving up to a 60 Hz frame early:\n",
+                    count);
+        button_frame.Print("button, frame", "us error");
+        button_input.Print("button, input", "us error");
+        hotkey_frame.Print("event, frame", "us error");
+        hotkey_input.Print("event, input", "us error");
+        std::printf("  %zu laps missed, %zu input-anchored splits off their input time\n", missed, inexact);
+        return missed == 0 && inexact == 0 ? 0 : 1;
+    }
+    
+    void RunFrameBenchmark(TimeApplication& app, TimeAppView& view, int frames) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        
+        Series new_frame, build, render, total;
+        Series vertices, indices, draw_lists;
+        Series new_calls, imgui_calls;
+        
+        std::clock_t cpu_start = std::clock();
+        Clock::time_point wall_start = Clock::now();
+        
+        for (int frame = 0; frame < frames; ++frame) {
+            io.DeltaTime = FRAME_DELTA;
+            Script(frame, app, view);
+            
+            uint64_t new_before = thread_allocations;
+            uint64_t imgui_before = imgui_allocations;
+            
+            Clock::time_point t0 = Clock::now();
+            ImGui::NewFrame();
+            Clock::time_point t1 = Clock::now();
+            view.Render();
+            Clock::time_point t2 = Clock::now();
+            ImGui::Render();
+            Clock::time_point t3 = Clock::now();
+            
+            ImDrawData* draw_data = ImGui::GetDrawData();
+            UpdateTextures(draw_data);
+            view.TakeFrameRequest();
+            
+            if (frame < WARMUP_FRAMES) continue;
+            new_frame.Add(Microseconds(t1 - t0));
+            build.Add(Microseconds(t2 - t1));
+            render.Add(Microseconds(t3 - t2));
+            total.Add(Microseconds(t3 - t0));
+            vertices.Add(draw_data->TotalVtxCount);
+            indices.Add(draw_data->TotalIdxCount);
+            draw_lists.Add(draw_data->CmdListsCount);
+            // ImGui's own allocations go through malloc, not operator new
+            new_calls.Add(static_cast<double>(thread_allocations - new_before));
+            imgui_calls.Add(static_cast<double>(imgui_allocations - imgui_before));
+        }
+        
+        double wall = std::chrono::duration<double>(Clock::now() - wall_start).count();
+        double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        
+        std::printf("TimeAppHeadless: %d frames (%d warm-up not counted), %.2f s wall, %.2f s process CPU\n",
+                    frames, WARMUP_FRAMES, wall, cpu);
+        std::printf("Per frame:\n");
+        new_frame.Print("NewFrame", "us");
+        build.Print("widget build", "us");
+        render.Print("Render", "us");
+        total.Print("total", "us");
+        vertices.Print("vertices", "");
+        indices.Print("indices", "");
+        draw_lists.Print("draw lists", "");
+        new_calls.Print("operator new", "allocations");
+        imgui_calls.Print("ImGui alloc", "allocations");
+        
+        const GeometryCache& cache = view.GetGeometryCache();
+        if (cache.IsEnabled()) {
+            GeometryCache::Stats stats = cache.GetStats();
+            std::printf("Geometry cache: %.1f replays/frame, %.0f vertices/frame replayed, %llu captures, %zu entries\n",
+                        static_cast<double>(stats.hits) / frames, static_cast<double>(stats.replayed_vertices) / frames,
+                        static_cast<unsigned long long>(stats.misses), stats.entries);
+        } else {
+            std::printf("Geometry cache: disabled\n");
+        }
+        
+        // Every rebuild of the atlas makes a new texture with the next id
+        const ImTextureData* atlas = io.Fonts->TexData;
+        std::printf("Font atlas: %dx%d, %d KB, texture #%d; big clocks: %s",
+                    atlas->Width, atlas->Height, atlas->GetSizeInBytes() / 1024, atlas->UniqueID,
+                    view.GetClockDigits().IsEnabled() ? "ClockDigits" : "SetWindowFontScale");
+        if (view.GetClockDigits().IsEnabled()) {
+            std::printf(", %llu glyph refreshes", static_cast<unsigned long long>(view.GetClockDigits().GetRefreshCount()));
+        }
+        std::printf("\n");
+        
+        const SegmentDisplay::Stats& segments = view.GetWallDisplay().GetStats();
+        if (segments.vertices > 0) {
+            std::printf("Wall display: %d vertices %s, %llu mesh builds\n", segments.vertices,
+                        view.GetWallDisplay().IsCached() ? "copied" : "tessellated",
+                        static_cast<unsigned long long>(segments.mesh_builds));
+        }
+        
+        const TimerPool& pool = app.GetTimerPool();
+        if (pool.Size() > 0) {
+            const TimerTable::Stats& table = view.GetTimerTable().GetStats();
+            std::printf("Timer table: %zu timers (%zu running), %d rows drawn, order %s: %llu full sorts, "
+                        "%llu rows moved, %llu batch merges\n",
+                        pool.Size(), pool.RunningCount(), table.rows_drawn,
+                        view.GetTimerTable().IsIncremental() ? "incremental" : "re-sorted every frame",
+                        static_cast<unsigned long long>(table.rebuilds),
+                        static_cast<unsigned long long>(table.moved_rows),
+                        static_cast<unsigned long long>(table.merges));
+        }
+        
+        if (world_clock_only) {
+            std::printf("World clock: %zu zones\n", app.GetWorldClock().Size());
+        }
+        
+        const AnalogClock::Stats& analog = view.GetAnalogClock().GetStats();
+        if (analog.face_builds > 0) {
+            std::printf("Analog clock: face %d vertices %s, %llu face builds, hands %d vertices/frame\n",
+                        analog.face_vertices, view.GetAnalogClock().IsCached() ? "replayed" : "tessellated",
+                        static_cast<unsigned long long>(analog.face_builds), analog.hand_vertices);
+        }
+    }
+    
+    // Binary PPM; alpha dropped
+    bool WritePpm(const char* path, const SoftwareRenderer& renderer) {
+        FILE* file = std::fopen(path, "wb");
+        if (!file) return false;
+        std::fprintf(file, "P6\n%d %d\n255\n", renderer.GetWidth(), renderer.GetHeight());
+        std::vector<unsigned char> row(static_cast<size_t>(renderer.GetWidth()) * 3);
+        for (int y = 0; y < renderer.GetHeight(); ++y) {
+            const uint32_t* pixels = renderer.GetPixels() + static_cast<size_t>(y) * renderer.GetWidth();
+            for (int x = 0; x < renderer.GetWidth(); ++x) {
+                row[x * 3 + 0] = static_cast<unsigned char>(pixels[x]);
+                row[x * 3 + 1] = static_cast<unsigned char>(pixels[x] >> 8);
+                row[x * 3 + 2] = static_cast<unsigned char>(pixels[x] >> 16);
+            }
+            std::fwrite(row.data(), 1, row.size(), file);
+        }
+        return std::fclose(file) == 0;
+    }
+    
+    // Largest per-channel difference and the number of pixels off by more than one
+    void Compare(const SoftwareRenderer& a, const SoftwareRenderer& b, int& max_diff, size_t& off_pixels) {
+        max_diff = 0;
+        off_pixels = 0;
+        size_t count = static_cast<size_t>(a.GetWidth()) * a.GetHeight();
+        for (size_t i = 0; i < count; ++i) {
+            int pixel_diff = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                int ca = (a.GetPixels()[i] >> shift) & 0xFF;
+                int cb = (b.GetPixels()[i] >> shift) & 0xFF;
+                pixel_diff = std::max(pixel_diff, std::abs(ca - cb));
+            }
+            max_diff = std::max(max_diff, pixel_diff);
+            if (pixel_diff > 1) ++off_pixels;
+        }
+    }
+    
+    // Every kernel draws the same frames; the reference one is the naive
+    // per-pixel rasterizer the others are checked against
+    void RunRasterBenchmark(TimeApplication& app, TimeAppView& view, int frames, const char* screenshot) {
+        struct Size { int width, height; const char* name; };
+        const Size sizes[] = {{1920, 1080, "1080p"}, {3840, 2160, "4K"}};
+        const SoftwareRenderer::Kernel kernels[] = {
+            SoftwareRenderer::Kernel::Reference,
+            SoftwareRenderer::Kernel::Scalar,
+            SoftwareRenderer::Kernel::Sse41,
+            SoftwareRenderer::Kernel::Avx2
+        };
+        
+        ImGuiIO& io = ImGui::GetIO();
+        int frame = 0;
+        for (const Size& size : sizes) {
+            io.DisplaySize = ImVec2(static_cast<float>(size.width), static_cast<float>(size.height));
+            
+            std::vector<std::unique_ptr<SoftwareRenderer>> renderers;
+            std::vector<Series> times;
+            for (SoftwareRenderer::Kernel kernel : kernels) {
+                if (!SoftwareRenderer::IsSupported(kernel)) continue;
+                renderers.push_back(std::make_unique<SoftwareRenderer>(kernel));
+                times.emplace_back();
+            }
+            Series triangles;
+            
+            for (int i = 0; i < frames; ++i, ++frame) {
+                io.DeltaTime = FRAME_DELTA;
+                Script(frame, app, view);
+                ImGui::NewFrame();
+                view.Render();
+                ImGui::Render();
+                view.TakeFrameRequest();
+                
+                ImDrawData* draw_data = ImGui::GetDrawData();
+                for (size_t k = 0; k < renderers.size(); ++k) {
+                    Clock::time_point start = Clock::now();
+                    renderers[k]->RenderDrawData(draw_data);
+                    if (i >= RASTER_WARMUP_FRAMES) times[k].Add(Microseconds(Clock::now() - start) / 1000.0);
+                }
+                triangles.Add(static_cast<double>(renderers[0]->GetStats().triangles));
+            }
+            
+            std::printf("%s (%dx%d), %d frames (%d warm-up not counted), %u threads:\n", size.name,
+                        size.width, size.height, frames, RASTER_WARMUP_FRAMES, renderers.back()->GetThreadCount());
+            triangles.Print("triangles", "");
+            for (size_t k = 0; k < renderers.size(); ++k) {
+                times[k].Print(SoftwareRenderer::GetKernelName(renderers[k]->GetKernel()), "ms");
+            }
+            for (size_t k = 1; k < renderers.size(); ++k) {
+                int max_diff;
+                size_t off_pixels;
+                Compare(*renderers[0], *renderers[k], max_diff, off_pixels);
+                std::printf("  %-14s vs reference: max channel diff %d, %zu pixels off by more than 1\n",
+                            SoftwareRenderer::GetKernelName(renderers[k]->GetKernel()), max_diff, off_pixels);
+            }
+            
+            if (screenshot && &size == &sizes[0]) {
+                if (WritePpm(screenshot, *renderers.back())) {
+                    std::cout << "Wrote " << screenshot << std::endl;
+                } else {
+                    std::cerr << "Failed to write " << screenshot << std::endl;
+                }
+            }
+        }
+    }
+}
+
+// Counts every allocation in the process; the UI thread reads its own count
+void* operator new(size_t size) {
+    ++thread_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+int main(int argc, char** argv) {
+    for (const BenchMode& mode : BENCH_MODES) {
+        if (argc >= 2 && std::strcmp(argv[1], mode.flag) == 0) {
+            return mode.run(argc >= 3 ? static_cast<size_t>(std::atoll(argv[2])) : 0);
+        }
+    }
+    
+    bool raster = false;
+    const char* screenshot = nullptr;
+    bool geometry_cache = true;
+    bool clock_digits = true;
+    bool analog_clock = false;
+    bool face_cache = true;
+    bool wall_display = false;
+    bool wall_cache = true;
+    bool incremental_sort = true;
+    size_t timers = 0;
+    size_t zones = 0;
+    size_t inputs = 0;
+    int frames = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--raster") == 0) {
+            raster = true;
+        } else if (std::strcmp(argv[i], "--no-geometry-cache") == 0) {
+            geometry_cache = false;
+        } else if (std::strcmp(argv[i], "--font-scale") == 0) {
+            clock_digits = false;
+        } else if (std::strcmp(argv[i], "--analog") == 0) {
+            analog_clock = true;
+        } else if (std::strcmp(argv[i], "--no-face-cache") == 0) {
+            face_cache = false;
+        } else if (std::strcmp(argv[i], "--wall") == 0) {
+            wall_display = true;
+        } else if (std::strcmp(argv[i], "--no-wall-cache") == 0) {
+            wall_cache = false;
+        } else if (std::strcmp(argv[i], "--full-sort") == 0) {
+            incremental_sort = false;
+        } else if (std::strcmp(argv[i], "--timers") == 0 && i + 1 < argc) {
+            timers = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--zones") == 0 && i + 1 < argc) {
+            zones = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--input") == 0) {
+            inputs = i + 1 < argc ? static_cast<size_t>(std::atoll(argv[++i])) : 0;
+            if (inputs == 0) inputs = DEFAULT_INPUTS;
+        } else if (std::strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
+            screenshot = argv[++i];
+        } else if (IsCount(argv[i])) {
+            frames = std::atoi(argv[i]);
+        } else {
+            std::cerr << "Unknown argument or missing value: " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+    if (raster && frames <= RASTER_WARMUP_FRAMES) frames = DEFAULT_RASTER_FRAMES;
+    if (!raster && frames <= WARMUP_FRAMES) frames = DEFAULT_FRAMES;
+    
+    // Nothing that touches the disk, the network or the desktop
+    TimeApplication::Options options;
+    options.persist_timers = false;
+    options.initial_ntp_sync = false;
+    options.global_hotkeys = false;
+    TimeApplication app(options);
+    
+    ImGui::SetAllocatorFunctions(CountingAlloc, CountingFree, nullptr);
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    if (raster) {
+        SoftwareRenderer::ConfigureContext();
+    } else {
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+        io.BackendRendererName = "null";
+    }
+    DarkTheme::Apply();
+    
+    TimeAppView view(app);
+    view.GetGeometryCache().SetEnabled(geometry_cache);
+    view.GetClockDigits().SetEnabled(clock_digits);
+    view.GetAnalogClock().SetCached(face_cache);
+    view.SetShowAnalogClock(analog_clock);
+    view.GetWallDisplay().SetCached(wall_cache);
+    view.SetShowWallDisplay(wall_display);
+    view.GetTimerTable().SetIncremental(incremental_sort);
+    AddTimers(app.GetTimerPool(), timers);
+    if (zones > 0) {
+        AddZones(app.GetWorldClock(), zones);
+        world_clock_only = true;
+    }
+    int result = 0;
+    if (inputs > 0) {
+        result = RunInputBenchmark(app, view, inputs);
+    } else if (raster) {
+        RunRasterBenchmark(app, view, frames, screenshot);
+    } else {
+        RunFrameBenchmark(app, view, frames);
+    }
+    
+    ImGui::DestroyContext();
+    return result;
+}